@@ -9,6 +9,7 @@ namespace Alex {
 	public:
 		Part gBody, gHead, gArmL, gArmR, gLegL, gLegR, gBoundingBox;
 		GLuint textureID;
+		int textureLayer = -1;
 		glm::vec3 pos = { 4.5f, 1.5f, 12.0f };
 		glm::vec2 moveDir = { 0.0f, 0.0f }; 
 		GLfloat moveSpeed = 0.1f; 
@@ -22,7 +23,7 @@ namespace Alex {
 		glm::vec3 boundingBoxSize; 
 
 		Character(const char* texturePath) {
-			textureID = Init::loadTexture(texturePath);
+			textureID = Init::loadSkin(texturePath, textureLayer);
 
 			const float gap = 0.02f; 
 			glm::vec3 bodyH(0.3f, 0.35f, 0.15f);        
@@ -90,6 +91,20 @@ namespace Alex {
 			armState = 3; // LOWERING
 		}
 
+		CharacterState getState() const {
+			CharacterState s;
+			s.pos = pos; s.moveDir = moveDir;
+			s.armState = armState; s.armAngle = armAngle; s.armDir = armDir;
+			s.legState = legState; s.legAngle = legAngle; s.legDir = legDir;
+			return s;
+		}
+
+		void setState(const CharacterState& s) {
+			pos = s.pos; moveDir = s.moveDir;
+			armState = s.armState; armAngle = s.armAngle; armDir = s.armDir;
+			legState = s.legState; legAngle = s.legAngle; legDir = s.legDir;
+		}
+
 
 		bool checkCollision(const glm::vec3& characterMin, const glm::vec3& characterMax, const Block& block) {
 			float blockSize = block.getSize();
@@ -244,22 +259,19 @@ namespace Alex {
 			}
 		}
 
-		void drawBoundingBox(GLuint modelLoc, const glm::mat4& M) {
-			glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &M[0][0]);
-			glBindVertexArray(gBoundingBox.vao);
-			glDrawArrays(GL_LINES, 0, gBoundingBox.count);
-			glBindVertexArray(0);
+		void drawBoundingBox(Render::DrawList& out, const glm::mat4& M) {
+			Render::DrawItem item(gBoundingBox.mesh, GL_LINES);
+			item.model = M;
+			out.add(item);
 		}
 
-		void draw(GLuint modelLoc) {
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, textureID);
-
+		void draw(Render::DrawList& out) {
 			auto drawVAO = [&](const Part& p, const glm::mat4& M) {
-				glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &M[0][0]);
-				glBindVertexArray(p.vao);
-				glDrawArrays(GL_TRIANGLES, 0, p.count);
-				glBindVertexArray(0);
+				Render::DrawItem item(p.mesh);
+				item.texture = textureID;
+				item.layer = textureLayer;
+				item.model = M;
+				out.add(item);
 				};
 
 			glm::mat4 Mbase = glm::translate(glm::mat4(1.0f), pos);
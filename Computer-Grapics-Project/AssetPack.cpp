@@ -0,0 +1,331 @@
+﻿#include "AssetPack.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+const uint32_t AssetPack::MAGIC;
+const uint32_t AssetPack::VERSION;
+
+// 파일 배치 그대로 매핑해서 읽으므로 채움 없는 고정 크기
+struct AssetPack::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t namesSize;
+    uint64_t dataOffset;
+    uint64_t manifestHash;      // 항목 표 + 이름의 hashBytes
+};
+
+struct AssetPack::Source {
+    std::string name;
+    std::vector<unsigned char> bytes;
+};
+
+struct AssetPack::Entry {
+    uint32_t nameOffset;        // 이름 문자열 안에서
+    uint32_t nameLength;
+    uint64_t offset;            // 파일 처음부터
+    uint64_t size;
+    uint64_t hash;
+};
+
+namespace {
+    const size_t DATA_ALIGNMENT = 16;
+
+    size_t alignUp(size_t value)
+    {
+        return (value + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+    }
+
+    uint64_t continueHash(uint64_t hash, const unsigned char* data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    const uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+    // openCachePack이 정한 대기 목록 (notePendingCache가 덧붙인다)
+    std::mutex pendingMutex;
+    std::string pendingPath;
+}
+
+uint64_t AssetPack::hashBytes(const unsigned char* data, size_t size)
+{
+    return continueHash(FNV_OFFSET, data, size);
+}
+
+std::string AssetPack::normalizeName(const std::string& name)
+{
+    std::string out(name);
+    for (char& c : out) {
+        if (c == '\\') c = '/';
+        else c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (out.compare(0, 2, "./") == 0) out.erase(0, 2);
+    return out;
+}
+
+bool AssetPack::open(const std::string& packPath)
+{
+    close();
+    if (!file.open(packPath)) return false;
+
+    static_assert(sizeof(Header) == 32, "Header는 파일 배치와 같아야 한다");
+    static_assert(sizeof(Entry) == 32, "Entry는 파일 배치와 같아야 한다");
+    const unsigned char* data = file.data();
+    const size_t size = file.size();
+    const Header* header = reinterpret_cast<const Header*>(data);
+    size_t tableEnd = 0;
+    bool valid = size >= sizeof(Header) && header->magic == MAGIC && header->version == VERSION && header->entryCount > 0;
+    if (valid) {
+        tableEnd = sizeof(Header) + static_cast<size_t>(header->entryCount) * sizeof(Entry);
+        valid = tableEnd + header->namesSize <= size && header->dataOffset <= size;
+    }
+    if (valid) {
+        uint64_t manifest = hashBytes(data + sizeof(Header), tableEnd - sizeof(Header) + header->namesSize);
+        valid = manifest == header->manifestHash;
+    }
+    if (valid) {
+        const Entry* table = reinterpret_cast<const Entry*>(data + sizeof(Header));
+        for (uint32_t i = 0; i < header->entryCount && valid; ++i) {
+            valid = static_cast<uint64_t>(table[i].nameOffset) + table[i].nameLength <= header->namesSize &&
+                table[i].offset >= header->dataOffset && table[i].offset + table[i].size <= size;
+        }
+    }
+    if (!valid) {
+        std::cerr << "에셋 팩이 깨졌거나 형식이 다름 (매니페스트 검사 실패): " << packPath << std::endl;
+        file.close();
+        return false;
+    }
+
+    path = packPath;
+    entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    names = reinterpret_cast<const char*>(data + tableEnd);
+    entryCount = header->entryCount;
+    return true;
+}
+
+void AssetPack::close()
+{
+    file.close();
+    path.clear();
+    entries = nullptr;
+    names = nullptr;
+    entryCount = 0;
+}
+
+std::string AssetPack::entryName(size_t index) const
+{
+    return std::string(names + entries[index].nameOffset, entries[index].nameLength);
+}
+
+AssetPack::View AssetPack::find(const std::string& name) const
+{
+    View view;
+    if (entryCount == 0) return view;
+
+    // 항목은 이름순이다
+    std::string key = normalizeName(name);
+    size_t lo = 0, hi = entryCount;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int order = key.compare(0, std::string::npos, names + entries[mid].nameOffset, entries[mid].nameLength);
+        if (order == 0) {
+            view.data = file.data() + entries[mid].offset;
+            view.size = static_cast<size_t>(entries[mid].size);
+            view.hash = entries[mid].hash;
+            return view;
+        }
+        if (order < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return view;
+}
+
+int AssetPack::verify() const
+{
+    int bad = 0;
+    for (size_t i = 0; i < entryCount; ++i) {
+        if (hashBytes(file.data() + entries[i].offset, static_cast<size_t>(entries[i].size)) != entries[i].hash) {
+            std::cerr << "에셋 팩 항목 해시 불일치: " << entryName(i) << std::endl;
+            ++bad;
+        }
+    }
+    return bad;
+}
+
+bool AssetPack::readSource(const std::string& name, std::vector<Source>& sources)
+{
+    Source source;
+    source.name = normalizeName(name);
+    std::ifstream in(name.c_str(), std::ios::binary);
+    if (!in) {
+        std::cerr << "에셋 팩: 파일 없음, 건너뜀: " << name << std::endl;
+        return false;
+    }
+    source.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    sources.push_back(std::move(source));
+    return true;
+}
+
+bool AssetPack::build(const std::string& packPath, const std::vector<std::string>& files)
+{
+    std::vector<Source> sources;
+    for (const std::string& name : files) readSource(name, sources);
+    if (sources.empty()) {
+        std::cerr << "에셋 팩: 넣을 파일이 없음" << std::endl;
+        return false;
+    }
+    return write(packPath, sources, true);
+}
+
+bool AssetPack::merge(const std::string& packPath, const std::vector<std::string>& files)
+{
+    std::vector<Source> sources;
+    {
+        // 옛 항목을 복사해 두고 바꿔 넣기 전에 매핑을 푼다 (Windows는 매핑된 파일을 바꿀 수 없다)
+        AssetPack old;
+        if (old.open(packPath)) {
+            for (size_t i = 0; i < old.entryCount; ++i) {
+                Source source;
+                source.name = old.entryName(i);
+                const unsigned char* data = old.file.data() + old.entries[i].offset;
+                source.bytes.assign(data, data + old.entries[i].size);
+                sources.push_back(std::move(source));
+            }
+        }
+    }
+    size_t added = 0;
+    for (const std::string& name : files) {
+        if (readSource(name, sources)) ++added;
+    }
+    // 더할 파일이 하나도 남아 있지 않으면 할 일이 없다
+    if (added == 0) return true;
+    return write(packPath, sources, false);
+}
+
+bool AssetPack::write(const std::string& packPath, std::vector<Source>& sources, bool verbose)
+{
+    // 같은 이름이면 나중에 더한 것을 남긴다
+    std::stable_sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) { return a.name < b.name; });
+    std::vector<Source> unique;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (i + 1 < sources.size() && sources[i + 1].name == sources[i].name) continue;
+        unique.push_back(std::move(sources[i]));
+    }
+    sources.swap(unique);
+
+    std::vector<Entry> table(sources.size());
+    std::string nameBlob;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        table[i].nameOffset = static_cast<uint32_t>(nameBlob.size());
+        table[i].nameLength = static_cast<uint32_t>(sources[i].name.size());
+        nameBlob += sources[i].name;
+    }
+    size_t offset = alignUp(sizeof(Header) + table.size() * sizeof(Entry) + nameBlob.size());
+    const size_t dataOffset = offset;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        table[i].offset = offset;
+        table[i].size = sources[i].bytes.size();
+        table[i].hash = hashBytes(sources[i].bytes.data(), sources[i].bytes.size());
+        offset = alignUp(offset + sources[i].bytes.size());
+    }
+
+    Header header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.entryCount = static_cast<uint32_t>(table.size());
+    header.namesSize = static_cast<uint32_t>(nameBlob.size());
+    header.dataOffset = dataOffset;
+    uint64_t manifest = hashBytes(reinterpret_cast<const unsigned char*>(table.data()), table.size() * sizeof(Entry));
+    header.manifestHash = continueHash(manifest, reinterpret_cast<const unsigned char*>(nameBlob.data()), nameBlob.size());
+
+    std::string temporary = packPath + ".tmp";
+    {
+        std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "에셋 팩 저장 실패: " << packPath << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(Entry));
+        out.write(nameBlob.data(), nameBlob.size());
+        static const char padding[DATA_ALIGNMENT] = {};
+        size_t written = sizeof(Header) + table.size() * sizeof(Entry) + nameBlob.size();
+        for (size_t i = 0; i < sources.size(); ++i) {
+            out.write(padding, table[i].offset - written);
+            out.write(reinterpret_cast<const char*>(sources[i].bytes.data()), sources[i].bytes.size());
+            written = table[i].offset + sources[i].bytes.size();
+        }
+        out.write(padding, offset - written);
+        if (!out) {
+            std::cerr << "에셋 팩 저장 실패: " << packPath << std::endl;
+            return false;
+        }
+    }
+    std::remove(packPath.c_str());
+    if (std::rename(temporary.c_str(), packPath.c_str()) != 0) {
+        std::cerr << "에셋 팩 저장 실패: " << packPath << std::endl;
+        return false;
+    }
+
+    if (verbose) {
+        for (size_t i = 0; i < sources.size(); ++i) {
+            std::cout << "  " << sources[i].name << " (" << sources[i].bytes.size() << " bytes)" << std::endl;
+        }
+    }
+    std::cout << "에셋 팩 " << packPath << ": " << sources.size() << "개, " << offset << " bytes" << std::endl;
+    return true;
+}
+
+AssetPack& assetPack()
+{
+    // 텍스처 워커가 프로그램 종료 중에도 읽을 수 있게 일부러 해제하지 않는다
+    static AssetPack* pack = new AssetPack();
+    return *pack;
+}
+
+AssetPack& cachePack()
+{
+    // assetPack과 같은 이유로 해제하지 않는다
+    static AssetPack* pack = new AssetPack();
+    return *pack;
+}
+
+bool openCachePack(const std::string& path)
+{
+    std::vector<std::string> pending;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        pendingPath = path + ".pending";
+        std::ifstream list(pendingPath.c_str());
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && std::find(pending.begin(), pending.end(), line) == pending.end()) pending.push_back(line);
+        }
+    }
+    if (!pending.empty()) {
+        // 합치지 못하면 따로 둔 파일을 그대로 두고 다음에 다시 해 본다
+        if (AssetPack::merge(path, pending)) {
+            for (const std::string& file : pending) std::remove(file.c_str());
+            std::remove((path + ".pending").c_str());
+            std::cout << "캐시 팩: 새 캐시 " << pending.size() << "개를 합침" << std::endl;
+        }
+    }
+    return cachePack().open(path);
+}
+
+void notePendingCache(const std::string& file)
+{
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    if (pendingPath.empty()) return;
+    std::ofstream list(pendingPath.c_str(), std::ios::app);
+    list << file << '\n';
+}
@@ -0,0 +1,80 @@
+﻿#pragma once
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 셰이더, 텍스처 원본, (나중에) 맵 파일을 한 파일로 묶은 에셋 팩. 런타임은 팩을 한 번 매핑하고
+// 이름으로 찾은 내용을 복사 없이 그대로 돌려준다. 팩에 없는 이름은 부르는 쪽이 작업 폴더에서 읽는다.
+//
+// 파일: 헤더, 이름순 항목 표, 이름 문자열, 16바이트 정렬된 내용. 항목마다 내용의 FNV-1a 64 해시가 있고
+// 헤더에는 항목 표와 이름 전체의 해시(매니페스트 체크섬)가 있다. open은 매니페스트만 검사하고
+// (내용 페이지는 건드리지 않는다) 내용 해시는 verify가 본다.
+// 이름은 소문자로 찾는다 (Windows 작업 폴더처럼 대소문자를 가리지 않는다).
+//
+// open과 close는 워커가 팩을 읽기 전에, GL 스레드에서. 그 뒤 find는 어느 스레드에서 불러도 된다.
+//
+// 같은 형식의 두 번째 팩(cachePack)에는 실행하면서 만든 GPU용 캐시(.gtex, 셰이더 바이너리)를 모은다.
+// 캐시는 새로 만들면 우선 따로 파일로 쓰고 (notePendingCache), 다음 실행의 openCachePack이 매핑하기 전에
+// 팩에 합치고 지운다. 그래서 캐시가 다 만들어진 뒤의 시작은 에셋마다 파일을 열지 않고 팩 하나만 매핑한다.
+class AssetPack
+{
+public:
+    static const uint32_t MAGIC = 0x4b415041;   // "APAK"
+    static const uint32_t VERSION = 1;
+
+    struct View {
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        uint64_t hash = 0;      // 내용의 FNV-1a 64 (hashBytes)
+
+        explicit operator bool() const { return data != nullptr; }
+    };
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return entryCount > 0; }
+    const std::string& getPath() const { return path; }
+    size_t getEntryCount() const { return entryCount; }
+    size_t getSize() const { return file.size(); }
+
+    // 없으면 빈 View
+    View find(const std::string& name) const;
+    // 모든 항목을 다시 해시해서 매니페스트와 비교한다. 틀린 항목 수.
+    int verify() const;
+
+    // files를 읽어 path에 팩을 쓴다 (임시 파일에 쓰고 바꿔 넣는다)
+    static bool build(const std::string& path, const std::vector<std::string>& files);
+    // path 팩(없으면 빈 팩)에 files를 더해 다시 쓴다. 같은 이름은 files 쪽이 이긴다. path는 열려 있지 않아야 한다.
+    // 더할 파일이 하나도 없으면 쓰지 않고 true.
+    static bool merge(const std::string& path, const std::vector<std::string>& files);
+    static uint64_t hashBytes(const unsigned char* data, size_t size);
+    static std::string normalizeName(const std::string& name);
+
+private:
+    struct Header;
+    struct Entry;
+    struct Source;
+
+    static bool readSource(const std::string& name, std::vector<Source>& sources);
+    // 이름순으로 정렬하고 (같은 이름은 뒤의 것) path에 쓴다
+    static bool write(const std::string& path, std::vector<Source>& sources, bool verbose);
+
+    std::string entryName(size_t index) const;
+
+    MappedFile file;
+    std::string path;
+    const Entry* entries = nullptr;
+    const char* names = nullptr;
+    size_t entryCount = 0;
+};
+
+// 게임 전체가 같이 쓰는 팩 (열지 않았으면 find가 항상 빈 View)
+AssetPack& assetPack();
+
+// GPU용 캐시 팩. 열지 않았으면 캐시는 따로 둔 파일에서만 읽는다.
+AssetPack& cachePack();
+// 지난 실행이 적어 둔 캐시 파일을 path 팩에 합치고 지운 다음 연다. 시작할 때 한 번, 워커가 캐시를 읽기 전에.
+bool openCachePack(const std::string& path);
+// 새로 쓴 캐시 파일을 다음 openCachePack이 합치도록 적어 둔다. 어느 스레드에서 불러도 된다.
+void notePendingCache(const std::string& file);
@@ -4,8 +4,7 @@
 #include <gl/glm/ext.hpp>
 #include <gl/glm/gtc/matrix_transform.hpp>
 #include <iostream>
-
-#include "stb_image.h"
+#include "TextureArray.h"
 
 Block::Block() : x(0.0f), y(0.0f), z(0.0f), size(10.0f), texturePath("oak_planks.png")
 {
@@ -18,51 +17,6 @@ Block::Block(float x, float y, float z, float size, const std::string& texturePa
     
 }
 
-Block::Block(const Block& other) 
-    : x(other.x), y(other.y), z(other.z), size(other.size), texturePath(other.texturePath)
-{
- 
-}
-
-Block& Block::operator=(const Block& other)
-{
-    if (this != &other) {
-        if (isInitialized) {
-            glDeleteVertexArrays(1, &vao);
-            glDeleteBuffers(1, &vbo);
-            glDeleteBuffers(1, &nbo);
-            glDeleteBuffers(1, &tbo);
-            if (textureLoaded && texture != 0) {
-                glDeleteTextures(1, &texture);
-            }
-            isInitialized = false;
-            textureLoaded = false;
-            vao = vbo = nbo = tbo = texture = 0;
-            count = 0;
-        }
-        
-        x = other.x;
-        y = other.y;
-        z = other.z;
-        size = other.size;
-        texturePath = other.texturePath;
-    }
-    return *this;
-}
-
-Block::~Block()
-{
-    if (isInitialized) {
-        glDeleteVertexArrays(1, &vao);
-        glDeleteBuffers(1, &vbo);
-        glDeleteBuffers(1, &nbo);
-        glDeleteBuffers(1, &tbo);
-        if (textureLoaded && texture != 0) {
-            glDeleteTextures(1, &texture);
-        }
-    }
-}
-
 void Block::setPosition(float x, float y, float z)
 {
     this->x = x;
@@ -72,80 +26,39 @@ void Block::setPosition(float x, float y, float z)
 
 void Block::setSize(float size)
 {
+    if (this->size == size) return;
     this->size = size;
-    if (isInitialized) {
+    if (mesh) {
         initialize();
     }
 }
 
 void Block::setTexture(const std::string& texturePath)
 {
+    releaseTexture();
     this->texturePath = texturePath;
-    if (textureLoaded) {
-        if (texture != 0) {
-            glDeleteTextures(1, &texture);
-            texture = 0;
-        }
-        textureLoaded = false;
-    }
 }
 
 void Block::loadTexture() const
 {
     if (textureLoaded) return;
 
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-
-    // ؽó Ķ 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // ̹ ε
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(texturePath.c_str(), &width, &height, &channels, 0);
-    
-    if (data) {
-        GLenum format;
-        if (channels == 1)
-            format = GL_RED;
-        else if (channels == 3)
-            format = GL_RGB;
-        else if (channels == 4)
-            format = GL_RGBA;
-        else
-            format = GL_RGB; // ⺻
+    //  ̹    ؽó 迭   
+    layer = Render::worldTextures().addLayer(texturePath);
+    texture = Render::worldTextures().getTexture();
+    textureLoaded = true;
+}
 
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        
-        std::cout << "ؽó ε : " << texturePath << " (" << width << "x" << height << ", " << channels << " channels)" << std::endl;
-        textureLoaded = true;
-    }
-    else {
-        std::cerr << "ؽó ε : " << texturePath << std::endl;
-        // ⺻ ؽó 
-        unsigned char whitePixel[3] = {255, 255, 255};
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, whitePixel);
-        textureLoaded = true;
-    }
-    
-    stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+void Block::releaseTexture() const
+{
+    //  迭 ´ (ٸ ϰ  , ũ⵵ ۴)
+    texture = 0;
+    layer = -1;
+    textureLoaded = false;
 }
 
 void Block::initialize() const
 {
-    if (isInitialized) {
-        glDeleteVertexArrays(1, &vao);
-        glDeleteBuffers(1, &vbo);
-        glDeleteBuffers(1, &nbo);
-        glDeleteBuffers(1, &tbo);
-    }
-
     // ť ؽ 
     float half = size / 2.0f;
     std::vector<glm::vec3> vertices = {
@@ -216,81 +129,27 @@ void Block::initialize() const
         {1.0f, 1.0f}, {0.0f, 1.0f}, {0.0f, 0.0f}
     };
 
-    //  
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &nbo);
-    glGenBuffers(1, &tbo);
-
-    glBindVertexArray(vao);
-
-    // ؽ ġ 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-
-    //  
-    glBindBuffer(GL_ARRAY_BUFFER, nbo);
-    glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), normals.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-
-    // ؽó ǥ 
-    glBindBuffer(GL_ARRAY_BUFFER, tbo);
-    glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(glm::vec2), texCoords.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    count = static_cast<GLsizei>(vertices.size());
-    isInitialized = true;
+    // ̹  ޽ø ۸ ٽ  븸 ٲ۴
+    Render::MeshData data;
+    data.positions = vertices.data();
+    data.normals = normals.data();
+    data.texCoords = texCoords.data();
+    data.count = vertices.size();
+    Render::backend().uploadMesh(mesh, data);
     
     loadTexture();
 }
 
-void Block::render(GLuint shaderProgram, const glm::vec3& color) const
+void Block::render(Render::DrawList& out, const glm::vec3& color) const
 {
-    if (!isInitialized) {
+    if (!mesh) {
         initialize();
     }
 
-    if (textureLoaded && texture != 0) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture);
-    }
-
-    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, z));
-    
-    glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
-    
-    GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLint normalMatrixLoc = glGetUniformLocation(shaderProgram, "normalMatrix");
-    GLint vColorLoc = glGetUniformLocation(shaderProgram, "vColor");
-    GLint useTextureLoc = glGetUniformLocation(shaderProgram, "useTexture");
-    GLint textureLoc = glGetUniformLocation(shaderProgram, "texture1");
-    
-    if (modelLoc != -1) {
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &model[0][0]);
-    }
-    if (normalMatrixLoc != -1) {
-        glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, &normalMatrix[0][0]);
-    }
-    if (vColorLoc != -1) {
-        glUniform3f(vColorLoc, color.r, color.g, color.b);
-    }
-    if (useTextureLoc != -1) {
-        glUniform1i(useTextureLoc, textureLoaded ? 1 : 0);
-    }
-    if (textureLoc != -1) {
-        glUniform1i(textureLoc, 0);
-    }
-
-    glBindVertexArray(vao);
-    glDrawArrays(GL_TRIANGLES, 0, count);
-    glBindVertexArray(0);
-    
-    glBindTexture(GL_TEXTURE_2D, 0);
+    Render::DrawItem item(mesh);
+    item.texture = textureLoaded ? texture : 0;
+    item.layer = layer;
+    item.model = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, z));
+    item.color = color;
+    out.add(item);
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include <gl/glew.h>
+#include "GlIntercept.h"
 #include <gl/glm/glm.hpp>
+#include "RenderQueue.h"
 #include <vector>
 #include <string>
 
@@ -10,13 +12,9 @@ private:
     float x, y, z;
     float size;
     
-    mutable GLuint vao = 0;
-    mutable GLuint vbo = 0;
-    mutable GLuint nbo = 0;
-    mutable GLuint tbo = 0;
-    mutable GLuint texture = 0;
-    mutable GLsizei count = 0;
-    mutable bool isInitialized = false;
+    mutable Render::Mesh mesh;          // ó ׸  
+    mutable GLuint texture = 0;         //  ؽó 迭 ( TextureArray)
+    mutable int layer = -1;             //  ؽó 迭 
 
     std::string texturePath;
     mutable bool textureLoaded = false;
@@ -25,8 +23,11 @@ public:
     Block();
     Block(float x, float y, float z, float size = 1.0f, const std::string& texturePath = "oak_planks.png");
     
-    Block(const Block& other);
-    Block& operator=(const Block& other);
+    // ޽ ̶ ű⸸ Ѵ. Ground/Wall vector Ŀų ڸ ٲ㵵 ޽ø ٽ  ʴ´.
+    Block(Block&& other) = default;
+    Block& operator=(Block&& other) = default;
+    Block(const Block&) = delete;
+    Block& operator=(const Block&) = delete;
     
     float getX() const { return x; }
     float getY() const { return y; }
@@ -38,10 +39,9 @@ public:
     void setTexture(const std::string& texturePath);
     
     void loadTexture() const;
+    void releaseTexture() const;
     
     void initialize() const;
-    void render(GLuint shaderProgram, const glm::vec3& color = glm::vec3(0.5f, 0.5f, 0.5f)) const;
-    
-    ~Block();
+    void render(Render::DrawList& out, const glm::vec3& color = glm::vec3(0.5f, 0.5f, 0.5f)) const;
 };
 
@@ -0,0 +1,249 @@
+﻿#include "BlockCompression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    bool compressionEnabled = false;
+
+    struct Color565 {
+        uint16_t packed;
+        float rgb[3];       // 펼친 값 (0..255)
+    };
+
+    Color565 quantize(const float rgb[3])
+    {
+        int r = std::max(0, std::min(31, static_cast<int>(rgb[0] * 31.0f / 255.0f + 0.5f)));
+        int g = std::max(0, std::min(63, static_cast<int>(rgb[1] * 63.0f / 255.0f + 0.5f)));
+        int b = std::max(0, std::min(31, static_cast<int>(rgb[2] * 31.0f / 255.0f + 0.5f)));
+        Color565 c;
+        c.packed = static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        c.rgb[0] = static_cast<float>((r << 3) | (r >> 2));
+        c.rgb[1] = static_cast<float>((g << 2) | (g >> 4));
+        c.rgb[2] = static_cast<float>((b << 3) | (b >> 2));
+        return c;
+    }
+
+    float distanceSquared(const float a[3], const float b[3])
+    {
+        float dr = a[0] - b[0], dg = a[1] - b[1], db = a[2] - b[2];
+        return dr * dr + dg * dg + db * db;
+    }
+
+    // 4색 모드 팔레트: c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1
+    void palette(const Color565& c0, const Color565& c1, float out[4][3])
+    {
+        for (int k = 0; k < 3; ++k) {
+            out[0][k] = c0.rgb[k];
+            out[1][k] = c1.rgb[k];
+            out[2][k] = (2.0f * c0.rgb[k] + c1.rgb[k]) / 3.0f;
+            out[3][k] = (c0.rgb[k] + 2.0f * c1.rgb[k]) / 3.0f;
+        }
+    }
+
+    uint32_t pickIndices(const float texels[16][3], const float colors[4][3], float& error)
+    {
+        uint32_t indices = 0;
+        error = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0;
+            float bestDistance = distanceSquared(texels[i], colors[0]);
+            for (int c = 1; c < 4; ++c) {
+                float d = distanceSquared(texels[i], colors[c]);
+                if (d < bestDistance) { bestDistance = d; best = c; }
+            }
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+            error += bestDistance;
+        }
+        return indices;
+    }
+
+    // 주성분 축의 양 끝
+    void principalEndpoints(const float texels[16][3], float lo[3], float hi[3])
+    {
+        float mean[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) for (int k = 0; k < 3; ++k) mean[k] += texels[i][k] / 16.0f;
+
+        float cov[6] = { 0.0f };    // rr rg rb gg gb bb
+        for (int i = 0; i < 16; ++i) {
+            float d[3] = { texels[i][0] - mean[0], texels[i][1] - mean[1], texels[i][2] - mean[2] };
+            cov[0] += d[0] * d[0]; cov[1] += d[0] * d[1]; cov[2] += d[0] * d[2];
+            cov[3] += d[1] * d[1]; cov[4] += d[1] * d[2]; cov[5] += d[2] * d[2];
+        }
+
+        // 거듭제곱법. 밝기 방향에서 시작하면 회색조 블록은 바로 맞는다.
+        float axis[3] = { 0.577f, 0.577f, 0.577f };
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            float next[3] = {
+                cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+                cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+                cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]
+            };
+            float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+            if (length < 1e-6f) break;
+            for (int k = 0; k < 3; ++k) axis[k] = next[k] / length;
+        }
+
+        float minDot = 1e30f, maxDot = -1e30f;
+        for (int i = 0; i < 16; ++i) {
+            float d = (texels[i][0] - mean[0]) * axis[0] + (texels[i][1] - mean[1]) * axis[1] + (texels[i][2] - mean[2]) * axis[2];
+            minDot = std::min(minDot, d);
+            maxDot = std::max(maxDot, d);
+        }
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = std::max(0.0f, std::min(255.0f, mean[k] + axis[k] * minDot));
+            hi[k] = std::max(0.0f, std::min(255.0f, mean[k] + axis[k] * maxDot));
+        }
+    }
+
+    // 인덱스를 고정하고 두 끝점을 최소제곱으로 다시 푼다. 풀 수 없으면 false.
+    bool refitEndpoints(const float texels[16][3], uint32_t indices, float a[3], float b[3])
+    {
+        static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+        float ax[3] = { 0.0f, 0.0f, 0.0f }, bx[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            float alpha = weights[(indices >> (2 * i)) & 3];
+            float beta = 1.0f - alpha;
+            aa += alpha * alpha; bb += beta * beta; ab += alpha * beta;
+            for (int k = 0; k < 3; ++k) { ax[k] += alpha * texels[i][k]; bx[k] += beta * texels[i][k]; }
+        }
+        float det = aa * bb - ab * ab;
+        if (std::fabs(det) < 1e-6f) return false;
+        for (int k = 0; k < 3; ++k) {
+            a[k] = std::max(0.0f, std::min(255.0f, (ax[k] * bb - bx[k] * ab) / det));
+            b[k] = std::max(0.0f, std::min(255.0f, (bx[k] * aa - ax[k] * ab) / det));
+        }
+        return true;
+    }
+
+    void writeColorBlock(uint16_t c0, uint16_t c1, uint32_t indices, unsigned char* out)
+    {
+        out[0] = static_cast<unsigned char>(c0 & 0xff); out[1] = static_cast<unsigned char>(c0 >> 8);
+        out[2] = static_cast<unsigned char>(c1 & 0xff); out[3] = static_cast<unsigned char>(c1 >> 8);
+        for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+
+    // 8바이트 색 블록. c0 > c1인 4색 모드만 쓴다 (BC3 안에서도 같은 모양이다).
+    void encodeColorBlock(const float texels[16][3], unsigned char* out)
+    {
+        float lo[3], hi[3];
+        principalEndpoints(texels, lo, hi);
+        Color565 c0 = quantize(hi), c1 = quantize(lo);
+
+        float colors[4][3];
+        palette(c0, c1, colors);
+        float error;
+        uint32_t indices = pickIndices(texels, colors, error);
+
+        float a[3], b[3];
+        if (refitEndpoints(texels, indices, a, b)) {
+            Color565 r0 = quantize(a), r1 = quantize(b);
+            palette(r0, r1, colors);
+            float refitError;
+            uint32_t refitIndices = pickIndices(texels, colors, refitError);
+            if (refitError < error) { c0 = r0; c1 = r1; indices = refitIndices; }
+        }
+
+        if (c0.packed == c1.packed) {
+            // 같으면 3색 모드가 되어 인덱스 3이 투명 검정이다. 전부 0번 색으로.
+            writeColorBlock(c0.packed, c1.packed, 0, out);
+            return;
+        }
+        if (c0.packed < c1.packed) {
+            // 끝점을 바꾸면 0<->1, 2<->3이 바뀐다
+            std::swap(c0, c1);
+            indices ^= 0x55555555u;
+        }
+        writeColorBlock(c0.packed, c1.packed, indices, out);
+    }
+
+    // 8바이트 알파 블록: 최대/최소 알파 사이 8단계
+    void encodeAlphaBlock(const unsigned char alphas[16], unsigned char* out)
+    {
+        unsigned char a0 = *std::max_element(alphas, alphas + 16);
+        unsigned char a1 = *std::min_element(alphas, alphas + 16);
+        out[0] = a0;
+        out[1] = a1;
+        uint64_t bits = 0;
+        if (a0 != a1) {
+            float values[8];
+            values[0] = a0; values[1] = a1;
+            for (int k = 1; k < 7; ++k) values[k + 1] = ((7 - k) * a0 + k * a1) / 7.0f;
+            for (int i = 0; i < 16; ++i) {
+                int best = 0;
+                float bestDistance = std::fabs(alphas[i] - values[0]);
+                for (int k = 1; k < 8; ++k) {
+                    float d = std::fabs(alphas[i] - values[k]);
+                    if (d < bestDistance) { bestDistance = d; best = k; }
+                }
+                bits |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+        for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+}
+
+void BlockCompression::setEnabled(bool enabled)
+{
+    compressionEnabled = enabled;
+}
+
+bool BlockCompression::isEnabled()
+{
+    return compressionEnabled;
+}
+
+GLenum BlockCompression::chooseFormat(const unsigned char* rgba, int width, int height)
+{
+    size_t count = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < count; ++i) {
+        if (rgba[i * 4 + 3] != 255) return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    }
+    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+size_t BlockCompression::encodedSize(GLenum format, int width, int height)
+{
+    size_t blocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+    if (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) return blocks * 8;
+    if (format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) return blocks * 16;
+    return static_cast<size_t>(width) * height * 4;
+}
+
+void BlockCompression::encode(GLenum format, const unsigned char* rgba, int width, int height, unsigned char* out)
+{
+    bool withAlpha = format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            float texels[16][3];
+            unsigned char alphas[16];
+            for (int i = 0; i < 16; ++i) {
+                int x = std::min(bx + (i & 3), width - 1);
+                int y = std::min(by + (i >> 2), height - 1);
+                const unsigned char* p = rgba + (static_cast<size_t>(y) * width + x) * 4;
+                texels[i][0] = p[0]; texels[i][1] = p[1]; texels[i][2] = p[2];
+                alphas[i] = p[3];
+            }
+            if (withAlpha) {
+                encodeAlphaBlock(alphas, out);
+                out += 8;
+            }
+            encodeColorBlock(texels, out);
+            out += 8;
+        }
+    }
+}
+
+bool BlockCompression::isCompressed(GLenum format)
+{
+    return format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
+
+const char* BlockCompression::formatName(GLenum format)
+{
+    if (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) return "BC1";
+    if (format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) return "BC3";
+    return "RGBA8";
+}
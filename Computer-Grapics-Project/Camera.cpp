@@ -27,6 +27,15 @@ glm::mat4 Camera::getProjectionMatrix(float screenWidth, float screenHeight) con
     return glm::perspective(glm::radians(fov), aspect, 0.1f, 100.0f);
 }
 
+const Frustum& Camera::getFrustum(float screenWidth, float screenHeight) const
+{
+    float aspect = screenWidth / screenHeight;
+    if (!frustumCache.matches(position, front, up, fov, aspect)) {
+        frustumCache.update(position, front, up, fov, aspect, getProjectionMatrix(screenWidth, screenHeight) * getViewMatrix());
+    }
+    return frustumCache.get();
+}
+
 void Camera::processSpecialKeyboard(int key)
 {
     float rotationSpeed = 2.0f;
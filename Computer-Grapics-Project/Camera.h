@@ -2,6 +2,7 @@
 
 #include <gl/glm/glm.hpp>
 #include <gl/glm/gtc/matrix_transform.hpp>
+#include "Frustum.h"
 
 class Camera {
 public:
@@ -27,6 +28,9 @@ public:
 
     glm::mat4 getProjectionMatrix(float screenWidth, float screenHeight) const;
 
+    // ġ//ȭ/ȭ ״θ   ״ ش
+    const Frustum& getFrustum(float screenWidth, float screenHeight) const;
+
     void processKeyboard(char key, float deltaTime);
 
     void processSpecialKeyboard(int key);
@@ -43,6 +47,8 @@ public:
     void setAngles(float yawAngle, float pitchAngle);
 
 private:
+    mutable FrustumCache frustumCache;
+
     void updateCameraVectors();
 };
 
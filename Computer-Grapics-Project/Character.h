@@ -4,17 +4,17 @@
 #include <vector>
 #include <string>
 #include <gl/glew.h>
+#include "GlIntercept.h"
 #include <gl/glm/glm.hpp>
 #include <gl/glm/ext.hpp>
 #include <gl/glm/gtc/matrix_transform.hpp>
 #include "stb_image.h"
+#include "RenderQueue.h"
+#include "TextureArray.h"
 
+// ޽ ̶ ű⸸ Ѵ (ĳ͸  ޽õ  )
 struct Part {
-	GLuint vao{ 0 };
-	GLuint vbo{ 0 };
-	GLuint nbo{ 0 };
-	GLuint tbo{ 0 };
-	GLsizei count{ 0 };
+	Render::Mesh mesh;
 	glm::vec3 offset{ 0.0f };
 	glm::vec3 pivot{ 0.0f };
 };
@@ -23,79 +23,53 @@ struct UVRect {
 	float u, v, w, h;
 };
 
+// Ʈũ ȭ/ѹ鿡 ̴ ĳ ùķ̼  ( ڿ )
+struct CharacterState {
+	glm::vec3 pos{ 0.0f };
+	glm::vec2 moveDir{ 0.0f };
+	GLint armState = 0;
+	GLfloat armAngle = 0.0f;
+	GLfloat armDir = 1.0f;
+	GLint legState = 0;
+	GLfloat legAngle = 0.0f;
+	GLfloat legDir = 1.0f;
+};
+
 namespace Init {
 
-	static GLuint loadTexture(const char* filepath)
+	//  ó GL ؽƮ  ĳ͸   false д
+	inline bool& graphicsEnabled()
 	{
-		GLuint textureID;
-		glGenTextures(1, &textureID);
-
-		stbi_set_flip_vertically_on_load(true);
-
-		int width, height, nrComponents;
-		unsigned char* data = stbi_load(filepath, &width, &height, &nrComponents, 0);
-		if (data)
-		{
-			GLenum format;
-			if (nrComponents == 1)
-				format = GL_RED;
-			else if (nrComponents == 3)
-				format = GL_RGB;
-			else if (nrComponents == 4)
-				format = GL_RGBA;
-
-			glBindTexture(GL_TEXTURE_2D, textureID);
-			glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-			glGenerateMipmap(GL_TEXTURE_2D);
-
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-			stbi_image_free(data);
-		}
-		else
-		{
-			std::cout << "Texture failed to load at path: " << filepath << std::endl;
-			stbi_image_free(data);
-		}
-
-		stbi_set_flip_vertically_on_load(false);
-		return textureID;
+		static bool enabled = true;
+		return enabled;
 	}
 
-	static void uploadMesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals, const std::vector<glm::vec2>& texCoords, GLuint& vao, GLuint& vbo, GLuint& nbo, GLuint& tbo, GLsizei& count)
+	// Ų  ؽó 迭(,   ؽó)  ϳ . 迭 ̸ ְ layer  ȣ.
+	inline GLuint loadSkin(const char* filepath, int& layer)
 	{
-		if (vao == 0) glGenVertexArrays(1, &vao);
-		if (vbo == 0) glGenBuffers(1, &vbo);
-		if (nbo == 0) glGenBuffers(1, &nbo);
-		if (tbo == 0) glGenBuffers(1, &tbo);
-
-		glBindVertexArray(vao);
-
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-
-		glBindBuffer(GL_ARRAY_BUFFER, nbo);
-		glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), normals.data(), GL_STATIC_DRAW);
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+		layer = -1;
+		if (!graphicsEnabled()) return 0;
 
-		glBindBuffer(GL_ARRAY_BUFFER, tbo);
-		glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(glm::vec2), texCoords.data(), GL_STATIC_DRAW);
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+		layer = Render::worldTextures().addLayer(filepath);
+		return Render::worldTextures().getTexture();
+	}
 
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	inline void uploadMesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals, const std::vector<glm::vec2>& texCoords, Render::Mesh& mesh)
+	{
+		if (!graphicsEnabled()) {
+			mesh.count = static_cast<GLsizei>(positions.size());
+			return;
+		}
 
-		count = static_cast<GLsizei>(positions.size());
+		Render::MeshData data;
+		data.positions = positions.data();
+		data.normals = normals.empty() ? nullptr : normals.data();
+		data.texCoords = texCoords.empty() ? nullptr : texCoords.data();
+		data.count = positions.size();
+		Render::backend().uploadMesh(mesh, data);
 	}
 
-	static void makeCube(const glm::vec3& h, const UVRect faceUVs[6], const bool flips[6], float texWidth, float texHeight,
+	inline void makeCube(const glm::vec3& h, const UVRect faceUVs[6], const bool flips[6], float texWidth, float texHeight,
 		std::vector<glm::vec3>& positions, std::vector<glm::vec3>& normals, std::vector<glm::vec2>& texCoords)
 	{
 		const glm::vec3 p[] = {
@@ -134,20 +108,20 @@ namespace Init {
 		add_face(4, 0, 2, 6, glm::vec3(0, 0, -1), faceUVs[5], flips[5]);
 	}
 
-	static Part makeCubePart(const glm::vec3& half, const glm::vec3& offset, const UVRect faceUVs[6], const bool flips[6], const glm::vec3& pivotLocal)
+	inline Part makeCubePart(const glm::vec3& half, const glm::vec3& offset, const UVRect faceUVs[6], const bool flips[6], const glm::vec3& pivotLocal)
 	{
 		Part p;
 		std::vector<glm::vec3> positions, normals;
 		std::vector<glm::vec2> texCoords;
 		const float texWidth = 64.0f, texHeight = 64.0f;
 		makeCube(half, faceUVs, flips, texWidth, texHeight, positions, normals, texCoords);
-		uploadMesh(positions, normals, texCoords, p.vao, p.vbo, p.nbo, p.tbo, p.count);
+		uploadMesh(positions, normals, texCoords, p.mesh);
 		p.offset = offset;
 		p.pivot = pivotLocal;
 		return p;
 	}
 
-	Part makeLineCubePart(float width, float height, float depth) {
+	inline Part makeLineCubePart(float width, float height, float depth) {
 		std::vector<glm::vec3> vertices;
 		float w = width / 2.0f;
 		float h = height / 2.0f;
@@ -182,21 +156,7 @@ namespace Init {
 		vertices.push_back(p[3]); vertices.push_back(p[7]);
 
 		Part part;
-		part.count = vertices.size();
-
-		glGenVertexArrays(1, &part.vao);
-		glBindVertexArray(part.vao);
-
-		glGenBuffers(1, &part.vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, part.vbo);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), 0);
-		glEnableVertexAttribArray(0);
-
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-
+		uploadMesh(vertices, std::vector<glm::vec3>(), std::vector<glm::vec2>(), part.mesh);
 		return part;
 	}
 }
\ No newline at end of file
@@ -1,45 +1,49 @@
-#include "Alex_Camera.h"
+﻿#include "FirstPersonCamera.h"
 #include <gl/freeglut.h>
 #include <algorithm>
 
-const float YAW = -90.0f;
-const float PITCH = 0.0f;
 const float SPEED = 2.5f;
 const float SENSITIVITY = 0.1f;
 const float ZOOM = 45.0f;
 
-Alex_Camera::Alex_Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch)
-    : front(glm::vec3(0.0f, 0.0f, -1.0f)), movementSpeed(SPEED), mouseSensitivity(SENSITIVITY), zoom(ZOOM)
+FirstPersonCamera::FirstPersonCamera(int player, float yaw, float pitch, glm::vec3 up)
+    : player(player), position(0.0f), front(glm::vec3(0.0f, 0.0f, -1.0f)), worldUp(up),
+      yaw(yaw), pitch(pitch), movementSpeed(SPEED), mouseSensitivity(SENSITIVITY), zoom(ZOOM)
 {
-    this->position = position;
-    this->worldUp = up;
-    this->yaw = yaw;
-    this->pitch = pitch;
     updateCameraVectors();
 }
 
-void Alex_Camera::updateFromCharacterPosition(const glm::vec3& characterPosition)
+void FirstPersonCamera::updateFromCharacterPosition(const glm::vec3& characterPosition)
 {
-    // ĳ Ӹ κп ī޶ ġ 
+    // 캐릭터의 머리 부분에 카메라 위치 설정
     position = characterPosition + glm::vec3(0.0f, 0.8f, 0.0f);
 }
 
-glm::mat4 Alex_Camera::getViewMatrix() const
+glm::mat4 FirstPersonCamera::getViewMatrix() const
 {
     return glm::lookAt(position, position + front, up);
 }
 
-glm::mat4 Alex_Camera::getProjectionMatrix(float screenWidth, float screenHeight) const
+glm::mat4 FirstPersonCamera::getProjectionMatrix(float screenWidth, float screenHeight) const
 {
     float aspectRatio = screenWidth / screenHeight;
     return glm::perspective(glm::radians(zoom), aspectRatio, 0.1f, 100.0f);
 }
 
-void Alex_Camera::processKeyboard(int key, float deltaTime)
+const Frustum& FirstPersonCamera::getFrustum(float screenWidth, float screenHeight) const
+{
+    float aspectRatio = screenWidth / screenHeight;
+    if (!frustumCache.matches(position, front, up, zoom, aspectRatio)) {
+        frustumCache.update(position, front, up, zoom, aspectRatio, getProjectionMatrix(screenWidth, screenHeight) * getViewMatrix());
+    }
+    return frustumCache.get();
+}
+
+void FirstPersonCamera::processKeyboard(int key, float deltaTime)
 {
     float velocity = movementSpeed * deltaTime;
-    
-    switch(key) {
+
+    switch (key) {
         case GLUT_KEY_UP:
             pitch += velocity * 10.0f;
             break;
@@ -53,16 +57,16 @@ void Alex_Camera::processKeyboard(int key, float deltaTime)
             yaw += velocity * 10.0f;
             break;
     }
-    
+
     if (pitch > 89.0f)
         pitch = 89.0f;
     if (pitch < -89.0f)
         pitch = -89.0f;
-    
+
     updateCameraVectors();
 }
 
-void Alex_Camera::processMouseMovement(float xOffset, float yOffset, bool constrainPitch)
+void FirstPersonCamera::processMouseMovement(float xOffset, float yOffset, bool constrainPitch)
 {
     xOffset *= mouseSensitivity;
     yOffset *= mouseSensitivity;
@@ -80,7 +84,7 @@ void Alex_Camera::processMouseMovement(float xOffset, float yOffset, bool constr
     updateCameraVectors();
 }
 
-void Alex_Camera::processMouseScroll(float yOffset)
+void FirstPersonCamera::processMouseScroll(float yOffset)
 {
     zoom -= (float)yOffset;
     if (zoom < 1.0f)
@@ -89,14 +93,14 @@ void Alex_Camera::processMouseScroll(float yOffset)
         zoom = 45.0f;
 }
 
-void Alex_Camera::updateCameraVectors()
+void FirstPersonCamera::updateCameraVectors()
 {
     glm::vec3 newFront;
     newFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
     newFront.y = sin(glm::radians(pitch));
     newFront.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
     front = glm::normalize(newFront);
-    
+
     right = glm::normalize(glm::cross(front, worldUp));
     up = glm::normalize(glm::cross(right, front));
 }
@@ -1,45 +1,57 @@
-#pragma once
+﻿#pragma once
 #include <gl/glm/glm.hpp>
 #include <gl/glm/gtc/matrix_transform.hpp>
+#include "Frustum.h"
 
-class Alex_Camera
+// 캐릭터 머리에 붙는 1인칭 카메라. 로컬 플레이어(분할 화면 칸)마다 하나씩 두고,
+// player로 어느 캐릭터를 따라갈지 정한다.
+class FirstPersonCamera
 {
 private:
+    int player;
+
     glm::vec3 position;
     glm::vec3 front;
     glm::vec3 up;
     glm::vec3 right;
     glm::vec3 worldUp;
-    
+
     float yaw;
     float pitch;
-    
+
     float movementSpeed;
     float mouseSensitivity;
     float zoom;
-    
+
+    mutable FrustumCache frustumCache;
+
     void updateCameraVectors();
 
 public:
-    Alex_Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f), 
-                glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f),
-                float yaw = -90.0f, float pitch = 0.0f);
-    
+    // yaw 90이면 +z, -90이면 -z를 본다
+    FirstPersonCamera(int player = 0, float yaw = -90.0f, float pitch = 0.0f,
+                      glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f));
+
+    int getPlayer() const { return player; }
+    void setPlayer(int newPlayer) { player = newPlayer; }
+
     void updateFromCharacterPosition(const glm::vec3& characterPosition);
-    
+
     glm::mat4 getViewMatrix() const;
-    
+
     glm::mat4 getProjectionMatrix(float screenWidth, float screenHeight) const;
-    
+
+    // 위치/방향/화각/화면비가 그대로면 지난번 평면을 그대로 돌려준다
+    const Frustum& getFrustum(float screenWidth, float screenHeight) const;
+
     void processKeyboard(int key, float deltaTime);
-    
+
     void processMouseMovement(float xOffset, float yOffset, bool constrainPitch = true);
-    
+
     void processMouseScroll(float yOffset);
-    
+
     glm::vec3 getPosition() const { return position; }
     glm::vec3 getFront() const { return front; }
     glm::vec3 getUp() const { return up; }
     float getZoom() const { return zoom; }
 };
-
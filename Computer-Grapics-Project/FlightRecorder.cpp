@@ -0,0 +1,142 @@
+﻿#include "FlightRecorder.h"
+#include "Profiler.h"
+#include "SimLog.h"
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+struct FrameRecord {
+    double end = 0.0;
+    double seconds = 0.0;
+    uint64_t index = 0;
+};
+
+struct EventRecord {
+    double time = 0.0;
+    uint64_t frame = 0;
+    char text[FlightRecorder::EVENT_TEXT_LENGTH] = {};
+};
+
+FlightRecorder::Config config;
+
+// 프레임 링은 메인 스레드만 쓰고, 이벤트 링은 여러 스레드가 쓸 수 있어서 뮤텍스로 막는다.
+// frameIndex는 메인 스레드가 올리고 이벤트를 적는 스레드가 아무 때나 읽으므로 원자적으로 둔다.
+FrameRecord frames[FlightRecorder::FRAME_CAPACITY];
+int frameHead = 0;
+int frameCount = 0;
+std::atomic<uint64_t> frameIndex(0);
+double lastFrameEnd = 0.0;
+
+std::mutex eventMutex;
+EventRecord events[FlightRecorder::EVENT_CAPACITY];
+int eventHead = 0;
+int eventCount = 0;
+
+double lastDumpTime = -1.0e9;
+int dumpCount = 0;
+
+const FrameRecord& frameAgo(int ago)
+{
+    int index = frameHead - 1 - ago;
+    if (index < 0) index += FlightRecorder::FRAME_CAPACITY;
+    return frames[index];
+}
+
+void dump(const FrameRecord& hitch)
+{
+    char path[256];
+    std::snprintf(path, sizeof(path), "%s%03d.txt", config.filePrefix.c_str(), dumpCount);
+    FILE* f = std::fopen(path, "w");
+    if (!f) {
+        std::cerr << "끊김 기록 저장 실패: " << path << std::endl;
+        return;
+    }
+
+    double windowStart = hitch.end - config.windowSeconds;
+    std::fprintf(f, "hitch frame %llu: %.2f ms (budget %.2f ms)\n", static_cast<unsigned long long>(hitch.index),
+        hitch.seconds * 1000.0, config.hitchBudget * 1000.0);
+    std::fprintf(f, "times are ms relative to the end of the hitch frame\n\n");
+
+    // Profiler 기록 링도 같은 drawScene에서 한 칸씩 밀리므로 ago가 같으면 같은 프레임이다
+    int zones = Profiler::zoneCount();
+    std::fprintf(f, "== frames ==\n");
+    for (int ago = frameCount - 1; ago >= 0; --ago) {
+        const FrameRecord& fr = frameAgo(ago);
+        if (fr.end < windowStart) continue;
+        std::fprintf(f, "%8.1f  frame %llu  %7.2f ms%s", (fr.end - hitch.end) * 1000.0,
+            static_cast<unsigned long long>(fr.index), fr.seconds * 1000.0, fr.seconds > config.hitchBudget ? "  <== HITCH" : "");
+        if (ago < Profiler::historySize()) {
+            const Profiler::FrameStats& stats = Profiler::history(ago);
+            std::fprintf(f, "  draws %u", stats.drawCalls);
+            for (int z = 0; z < zones; ++z) {
+                if (stats.zoneSeconds[z] >= 0.0005) std::fprintf(f, "  %s %.2f", Profiler::zoneName(z), stats.zoneSeconds[z] * 1000.0);
+            }
+        }
+        std::fputc('\n', f);
+    }
+
+    std::fprintf(f, "\n== events ==\n");
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        for (int i = 0; i < eventCount; ++i) {
+            int index = (eventHead - eventCount + i + FlightRecorder::EVENT_CAPACITY) % FlightRecorder::EVENT_CAPACITY;
+            const EventRecord& e = events[index];
+            if (e.time < windowStart) continue;
+            std::fprintf(f, "%8.1f  frame %llu  %s\n", (e.time - hitch.end) * 1000.0,
+                static_cast<unsigned long long>(e.frame), e.text);
+        }
+    }
+    std::fclose(f);
+
+    std::cout << "프레임 끊김 " << hitch.seconds * 1000.0 << "ms -> " << path << std::endl;
+    dumpCount++;
+}
+
+} // namespace
+
+void FlightRecorder::configure(const Config& newConfig)
+{
+    config = newConfig;
+}
+
+void FlightRecorder::event(const char* format, ...)
+{
+    if (!SimLog::enabled()) return;
+
+    double time = Profiler::now();
+    std::lock_guard<std::mutex> lock(eventMutex);
+    EventRecord& e = events[eventHead];
+    e.time = time;
+    e.frame = frameIndex.load(std::memory_order_relaxed);
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(e.text, sizeof(e.text), format, args);
+    va_end(args);
+
+    eventHead = (eventHead + 1) % EVENT_CAPACITY;
+    if (eventCount < EVENT_CAPACITY) eventCount++;
+}
+
+void FlightRecorder::endFrame()
+{
+    double t = Profiler::now();
+    FrameRecord& fr = frames[frameHead];
+    fr.end = t;
+    fr.seconds = (lastFrameEnd > 0.0) ? t - lastFrameEnd : 0.0;
+    fr.index = frameIndex.fetch_add(1, std::memory_order_relaxed);
+    frameHead = (frameHead + 1) % FRAME_CAPACITY;
+    if (frameCount < FRAME_CAPACITY) frameCount++;
+    lastFrameEnd = t;
+
+    if (config.hitchBudget <= 0.0 || fr.seconds <= config.hitchBudget) return;
+    if (t - lastDumpTime < config.cooldownSeconds || dumpCount >= MAX_DUMPS) return;
+
+    dump(fr);
+    // 파일 쓰는 시간은 다음 프레임에 얹히므로 그 프레임은 끊김으로 치지 않는다
+    lastDumpTime = Profiler::now();
+    lastFrameEnd = lastDumpTime;
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+#include <string>
+
+// 항상 켜져 있는 비행 기록 장치. 최근 프레임 시간과 게임 이벤트(발사, 눈 쌓임, 화면 전환,
+// 첫 텍스처 로드 등)를 고정 크기 링에 계속 덮어쓰다가, 한 프레임이 예산을 넘으면
+// 직전 몇 초를 텍스트 파일로 떨군다. 재현이 안 되는 끊김의 앞뒤 사정을 남기는 용도.
+namespace FlightRecorder {
+    const int FRAME_CAPACITY = 600;        // 60fps 기준 10초
+    const int EVENT_CAPACITY = 512;
+    const int EVENT_TEXT_LENGTH = 96;
+    const double DEFAULT_HITCH_BUDGET = 0.050;
+    const double DEFAULT_WINDOW_SECONDS = 3.0;
+    const int MAX_DUMPS = 20;
+
+    struct Config {
+        double hitchBudget = DEFAULT_HITCH_BUDGET;   // 이 시간을 넘는 프레임이면 기록을 떨군다 (0이면 끔)
+        double windowSeconds = DEFAULT_WINDOW_SECONDS;
+        double cooldownSeconds = 2.0;                // 연달아 끊길 때 파일이 쏟아지지 않게
+        std::string filePrefix = "hitch_";
+    };
+
+    void configure(const Config& config);
+
+    // printf 형식. 메모리 할당 없이 링에 복사한다. 소스 파일마다 인코딩이 달라서
+    // 한 파일에 섞여도 깨지지 않게 문구는 ASCII로 쓴다.
+    // SimLog가 꺼진 스레드(롤백 재시뮬레이션, 서버 워커)에서는 남기지 않는다.
+    void event(const char* format, ...);
+
+    // 메인 스레드에서 화면 한 장이 끝날 때마다 호출 (PROFILE_FRAME_END 바로 뒤).
+    // 예산을 넘은 프레임이면 그 자리에서 파일을 쓴다.
+    void endFrame();
+}
@@ -0,0 +1,124 @@
+﻿#include "Frustum.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define FRUSTUM_SIMD 1
+#else
+#define FRUSTUM_SIMD 0
+#endif
+
+Frustum Frustum::fromViewProjection(const glm::mat4& m)
+{
+    // 행렬은 열 우선이라 i행은 (m[0][i], m[1][i], m[2][i], m[3][i])
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum f;
+    f.planes[0] = row3 + row0;
+    f.planes[1] = row3 - row0;
+    f.planes[2] = row3 + row1;
+    f.planes[3] = row3 - row1;
+    f.planes[4] = row3 + row2;
+    f.planes[5] = row3 - row2;
+    for (glm::vec4& p : f.planes) {
+        float length = glm::length(glm::vec3(p));
+        if (length > 0.0f) p /= length;
+    }
+    return f;
+}
+
+bool Frustum::intersects(const glm::vec3& min, const glm::vec3& max) const
+{
+    for (const glm::vec4& p : planes) {
+        // 평면 법선 방향으로 가장 먼 꼭짓점도 바깥이면 상자 전체가 바깥
+        glm::vec3 v(p.x > 0.0f ? max.x : min.x, p.y > 0.0f ? max.y : min.y, p.z > 0.0f ? max.z : min.z);
+        if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+void FrustumSet::add(const Frustum& frustum)
+{
+    if (count < MAX_FRUSTUMS) frustums[count++] = frustum;
+}
+
+bool FrustumSet::intersects(const glm::vec3& min, const glm::vec3& max) const
+{
+    for (int f = 0; f < count; ++f) {
+        if (frustums[f].intersects(min, max)) return true;
+    }
+    return false;
+}
+
+void AabbList::clear()
+{
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+}
+
+void AabbList::add(const glm::vec3& min, const glm::vec3& max)
+{
+    minX.push_back(min.x); minY.push_back(min.y); minZ.push_back(min.z);
+    maxX.push_back(max.x); maxY.push_back(max.y); maxZ.push_back(max.z);
+}
+
+size_t cullAabbs(const FrustumSet& frustums, const AabbList& boxes, std::vector<uint8_t>& visible)
+{
+    const size_t count = boxes.size();
+    visible.resize(count);
+    size_t visibleCount = 0;
+    size_t i = 0;
+
+#if FRUSTUM_SIMD
+    // 상자 네 개를 한 번에: 평면마다 법선 부호로 고른 꼭짓점까지의 거리를 네 칸에 같이 구한다
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 any = zero;
+        for (int f = 0; f < frustums.count; ++f) {
+            __m128 inside = _mm_cmpeq_ps(zero, zero);
+            for (const glm::vec4& p : frustums.frustums[f].planes) {
+                __m128 x = _mm_loadu_ps(p.x > 0.0f ? &boxes.maxX[i] : &boxes.minX[i]);
+                __m128 y = _mm_loadu_ps(p.y > 0.0f ? &boxes.maxY[i] : &boxes.minY[i]);
+                __m128 z = _mm_loadu_ps(p.z > 0.0f ? &boxes.maxZ[i] : &boxes.minZ[i]);
+                __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), x), _mm_mul_ps(_mm_set1_ps(p.y), y));
+                d = _mm_add_ps(d, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z), z), _mm_set1_ps(p.w)));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+            }
+            any = _mm_or_ps(any, inside);
+        }
+        int mask = _mm_movemask_ps(any);
+        for (int k = 0; k < 4; ++k) {
+            visible[i + k] = static_cast<uint8_t>((mask >> k) & 1);
+            visibleCount += visible[i + k];
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        glm::vec3 min(boxes.minX[i], boxes.minY[i], boxes.minZ[i]);
+        glm::vec3 max(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]);
+        visible[i] = frustums.intersects(min, max) ? 1 : 0;
+        visibleCount += visible[i];
+    }
+    return visibleCount;
+}
+
+bool FrustumCache::matches(const glm::vec3& newEye, const glm::vec3& newFront, const glm::vec3& newUp, float newFov, float newAspect) const
+{
+    return valid && eye == newEye && front == newFront && up == newUp && fov == newFov && aspect == newAspect;
+}
+
+const Frustum& FrustumCache::update(const glm::vec3& newEye, const glm::vec3& newFront, const glm::vec3& newUp, float newFov, float newAspect,
+    const glm::mat4& viewProjection)
+{
+    eye = newEye;
+    front = newFront;
+    up = newUp;
+    fov = newFov;
+    aspect = newAspect;
+    frustum = Frustum::fromViewProjection(viewProjection);
+    valid = true;
+    return frustum;
+}
@@ -0,0 +1,63 @@
+﻿#pragma once
+#include <gl/glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// 시야 절두체 컬링. 평면은 안쪽을 향하고 길이 1로 맞춘다 (dot(n, p) + d >= 0 이면 안쪽).
+struct Frustum {
+    glm::vec4 planes[6];   // 왼, 오, 아래, 위, 가까운, 먼
+
+    // projection * view에서 평면을 뽑는다
+    static Frustum fromViewProjection(const glm::mat4& viewProjection);
+
+    // 보수적 검사: 경계에 걸치거나 모서리 근처에서 애매한 상자도 보인다고 한다
+    bool intersects(const glm::vec3& min, const glm::vec3& max) const;
+};
+
+// 시점 여러 개를 한 번에 그릴 때 (분할 화면) 쓰는 절두체 합집합.
+// 어느 하나에라도 걸치면 보인다고 한다. 절두체 하나에서 바로 만들 수 있다.
+struct FrustumSet {
+    static const int MAX_FRUSTUMS = 4;
+
+    FrustumSet() {}
+    FrustumSet(const Frustum& frustum) { add(frustum); }
+
+    void add(const Frustum& frustum);
+    bool intersects(const glm::vec3& min, const glm::vec3& max) const;
+
+    Frustum frustums[MAX_FRUSTUMS];
+    int count = 0;
+};
+
+// AABB 목록. 축별 배열로 둬서 cullAabbs가 네 개씩 SIMD로 검사한다.
+struct AabbList {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    void clear();
+    void add(const glm::vec3& min, const glm::vec3& max);
+    size_t size() const { return minX.size(); }
+};
+
+// visible[i]에 boxes i번이 보이면 1, 아니면 0. 보이는 개수를 돌려준다.
+// 상자 목록은 한 번만 훑고 상자마다 절두체 전부를 검사한다.
+size_t cullAabbs(const FrustumSet& frustums, const AabbList& boxes, std::vector<uint8_t>& visible);
+
+// 카메라가 들고 있는 절두체. 뷰/투영을 만드는 값이 지난번과 같으면 평면을 다시 뽑지 않는다.
+class FrustumCache
+{
+public:
+    bool matches(const glm::vec3& eye, const glm::vec3& front, const glm::vec3& up, float fov, float aspect) const;
+    const Frustum& update(const glm::vec3& eye, const glm::vec3& front, const glm::vec3& up, float fov, float aspect,
+        const glm::mat4& viewProjection);
+    const Frustum& get() const { return frustum; }
+
+private:
+    bool valid = false;
+    glm::vec3 eye{ 0.0f };
+    glm::vec3 front{ 0.0f };
+    glm::vec3 up{ 0.0f };
+    float fov = 0.0f;
+    float aspect = 0.0f;
+    Frustum frustum;
+};
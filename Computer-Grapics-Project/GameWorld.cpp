@@ -0,0 +1,294 @@
+﻿#include "GameWorld.h"
+#include "Steve.h"
+#include "Alex.h"
+#include "SimLog.h"
+#include "Profiler.h"
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <cstring>
+
+static const float maxChargeTime = 1.0f;
+static const float minSpeed = 2.0f;
+static const float maxSpeed = 15.0f;
+
+static bool checkSnowballCharacterCollision(const Snowball& snowball, const glm::vec3& characterPos, const glm::vec3& boundingBoxSize)
+{
+    if (!snowball.getIsActive()) return false;
+
+    glm::vec3 snowballPos = snowball.getPosition();
+    float snowballRadius = snowball.getRadius();
+
+    glm::vec3 characterMin = characterPos - boundingBoxSize / 2.0f;
+    glm::vec3 characterMax = characterPos + boundingBoxSize / 2.0f;
+
+    float closestX = std::max(characterMin.x, std::min(snowballPos.x, characterMax.x));
+    float closestY = std::max(characterMin.y, std::min(snowballPos.y, characterMax.y));
+    float closestZ = std::max(characterMin.z, std::min(snowballPos.z, characterMax.z));
+
+    glm::vec3 closestPoint(closestX, closestY, closestZ);
+
+    glm::vec3 distance = snowballPos - closestPoint;
+    float distanceSquared = glm::dot(distance, distance);
+
+    return distanceSquared <= (snowballRadius * snowballRadius);
+}
+
+GameWorld::GameWorld()
+{
+}
+
+GameWorld::~GameWorld()
+{
+    reset();
+}
+
+void GameWorld::initialize()
+{
+    reset();
+
+    gameMap.initialize();
+    std::cout << "맵 초기화 완료" << std::endl;
+
+    steve = new Steve::Character("steve.png");
+    std::cout << "Steve 캐릭터 초기화 완료" << std::endl;
+
+    alex = new Alex::Character("alex.png");
+    std::cout << "Alex 캐릭터 초기화 완료" << std::endl;
+}
+
+void GameWorld::reset()
+{
+    if (steve) { delete steve; steve = nullptr; }
+    if (alex) { delete alex; alex = nullptr; }
+    snowballs.clear();
+    snowSystem.clearAll();
+
+    for (int i = 0; i < PLAYER_COUNT; ++i) players[i] = PlayerState();
+    winner = Winner::NONE;
+    tickCount = 0;
+    nextSnowballId = 1;
+}
+
+void GameWorld::tick(const PlayerInput inputs[PLAYER_COUNT])
+{
+    updateProjectiles();
+
+    {
+        PROFILE_SCOPE("tick.characters");
+        for (int i = 0; i < PLAYER_COUNT; ++i) {
+            applyPlayerInput(i, inputs[i], true);
+        }
+    }
+
+    ++tickCount;
+}
+
+void GameWorld::updateProjectiles()
+{
+    {
+        PROFILE_SCOPE("tick.snow_anim");
+        snowSystem.updateAnimations(TICK_DELTA_TIME);
+    }
+    {
+        PROFILE_SCOPE("tick.snowballs");
+        for (auto& sb : snowballs) sb.update(TICK_DELTA_TIME, snowSystem, gameMap);
+        snowballs.erase(std::remove_if(snowballs.begin(), snowballs.end(),
+            [](const Snowball& s) { return !s.getIsActive(); }), snowballs.end());
+    }
+    {
+        PROFILE_SCOPE("tick.collision");
+        checkAllSnowballCollisions();
+    }
+}
+
+void GameWorld::applyPlayerInput(int player, const PlayerInput& input, bool allowFire)
+{
+    if (!hasCharacters()) return;
+
+    PlayerState& ps = players[player];
+    auto step = [&](auto& character, const char* name) {
+        if (input.throwHeld && !ps.throwHeld) {
+            if (!ps.charging && character.armState < 2) {
+                ps.charging = true;
+                ps.chargeStartTick = tickCount;
+                character.enterCharge();
+                SIM_LOG << name << " 던지기 준비..." << std::endl;
+            }
+        }
+        else if (!input.throwHeld && ps.throwHeld) {
+            if (ps.charging) {
+                if (allowFire) fireSnowball(player, input.aim);
+                ps.charging = false;
+                character.enterThrow();
+            }
+        }
+        ps.throwHeld = input.throwHeld;
+
+        if (ps.charging && character.armState == 2) {
+            float chargeTime = (tickCount - ps.chargeStartTick) * TICK_DELTA_TIME;
+            float chargeRatio = std::min(chargeTime / maxChargeTime, 1.0f);
+            character.armAngle = -glm::radians(180.0f) * chargeRatio;
+        }
+
+        character.moveDir = input.moveDir;
+        character.update(gameMap, snowSystem);
+    };
+
+    if (player == 0) step(*steve, "Steve");
+    else step(*alex, "Alex");
+}
+
+void GameWorld::fireSnowball(int player, const glm::vec3& aim)
+{
+    const PlayerState& ps = players[player];
+    glm::vec3 pos = getCharacterPosition(player);
+    float throwingSpeed = (player == 0) ? steve->throwingSpeed : alex->throwingSpeed;
+
+    float chargeTime = (tickCount - ps.chargeStartTick) * TICK_DELTA_TIME;
+    float chargeRatio = std::min(chargeTime / maxChargeTime, 1.0f);
+
+    float speed = minSpeed + (maxSpeed - minSpeed) * chargeRatio;
+    speed *= throwingSpeed;
+    speed = std::min(speed, maxSpeed);
+
+    glm::vec3 startPos = pos + aim * 1.0f + glm::vec3(0, 1, 0) * 0.5f;
+    glm::vec3 direction = aim + glm::vec3(0, 1, 0) * 0.3f;
+
+    Snowball newSnowball(startPos, direction, speed, 0.15f);
+    newSnowball.setId(nextSnowballId++);
+    if (nextSnowballId == 0) nextSnowballId = 1;
+    size_t capacity = snowballs.capacity();
+    snowballs.push_back(newSnowball);
+    FlightRecorder::event("%s throw %u speed %.1f", player == 0 ? "Steve" : "Alex", static_cast<unsigned int>(newSnowball.getId()), speed);
+    if (snowballs.capacity() != capacity) {
+        FlightRecorder::event("snowballs regrow %u -> %u", static_cast<unsigned int>(capacity), static_cast<unsigned int>(snowballs.capacity()));
+    }
+
+    SIM_LOG << (player == 0 ? "Steve" : "Alex") << " 눈덩이 발사! 차징 시간: " << chargeTime << "초, 속도: " << speed
+        << " (현재 " << snowballs.size() << "개)" << std::endl;
+}
+
+void GameWorld::checkAllSnowballCollisions()
+{
+    if (!hasCharacters() || winner != Winner::NONE) return;
+
+    for (const auto& snowball : snowballs) {
+        if (!snowball.getIsActive()) continue;
+
+        if (checkSnowballCharacterCollision(snowball, steve->pos, steve->boundingBoxSize)) {
+            SIM_LOG << "\n=== 경기 종료 ===\nSteve가 눈덩이에 맞았습니다!" << std::endl;
+            winner = Winner::ALEX;
+            return;
+        }
+
+        if (checkSnowballCharacterCollision(snowball, alex->pos, alex->boundingBoxSize)) {
+            SIM_LOG << "\n=== 경기 종료 ===\nAlex가 눈덩이에 맞았습니다!" << std::endl;
+            winner = Winner::STEVE;
+            return;
+        }
+    }
+}
+
+CharacterState GameWorld::getCharacterState(int player) const
+{
+    if (!hasCharacters()) return CharacterState();
+    return (player == 0) ? steve->getState() : alex->getState();
+}
+
+void GameWorld::setCharacterState(int player, const CharacterState& state)
+{
+    if (!hasCharacters()) return;
+    if (player == 0) steve->setState(state);
+    else alex->setState(state);
+}
+
+glm::vec3 GameWorld::getCharacterPosition(int player) const
+{
+    if (!hasCharacters()) return glm::vec3(0.0f);
+    return (player == 0) ? steve->pos : alex->pos;
+}
+
+void GameWorld::saveState(WorldSnapshot& out) const
+{
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        out.characters[i] = getCharacterState(i);
+        out.players[i] = players[i];
+    }
+    out.snowballs = snowballs;
+    out.snow = snowSystem.getSnowData();
+    out.winner = winner;
+    out.tickCount = tickCount;
+    out.nextSnowballId = nextSnowballId;
+}
+
+void GameWorld::loadState(const WorldSnapshot& in)
+{
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        setCharacterState(i, in.characters[i]);
+        players[i] = in.players[i];
+    }
+    snowballs = in.snowballs;
+    snowSystem.setSnowData(in.snow);
+    winner = in.winner;
+    tickCount = in.tickCount;
+    nextSnowballId = in.nextSnowballId;
+}
+
+namespace {
+    struct Fnv1a {
+        uint32_t hash = 2166136261u;
+
+        void bytes(const void* data, size_t size) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= p[i];
+                hash *= 16777619u;
+            }
+        }
+        void f(float v) { uint32_t bits; std::memcpy(&bits, &v, sizeof(bits)); bytes(&bits, sizeof(bits)); }
+        void i(int32_t v) { bytes(&v, sizeof(v)); }
+        void v3(const glm::vec3& v) { f(v.x); f(v.y); f(v.z); }
+    };
+}
+
+uint32_t GameWorld::checksum() const
+{
+    Fnv1a h;
+    for (int p = 0; p < PLAYER_COUNT; ++p) {
+        CharacterState s = getCharacterState(p);
+        h.v3(s.pos); h.f(s.moveDir.x); h.f(s.moveDir.y);
+        h.i(s.armState); h.f(s.armAngle); h.f(s.armDir);
+        h.i(s.legState); h.f(s.legAngle); h.f(s.legDir);
+        h.i(players[p].charging); h.i(players[p].throwHeld); h.i(static_cast<int32_t>(players[p].chargeStartTick));
+    }
+    for (const auto& sb : snowballs) {
+        h.i(sb.getId()); h.v3(sb.getPosition()); h.v3(sb.getVelocity());
+    }
+    for (const auto& cell : snowSystem.getSnowData()) {
+        h.i(cell.first.first); h.i(cell.first.second);
+        h.f(cell.second.targetHeight); h.f(cell.second.currentHeight); h.f(cell.second.animationTime);
+    }
+    h.i(static_cast<int32_t>(winner));
+    h.i(static_cast<int32_t>(tickCount));
+    return h.hash;
+}
+
+InputBot::InputBot(int player, unsigned int seed) : player(player), rng(seed)
+{
+    current.aim = (player == 0) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 0.0f, -1.0f);
+}
+
+PlayerInput InputBot::next()
+{
+    std::uniform_int_distribution<int> axis(-1, 1);
+    std::uniform_int_distribution<int> hold(5, 60);
+
+    if (frame >= nextChange) {
+        current.moveDir = glm::vec2(static_cast<float>(axis(rng)), static_cast<float>(axis(rng)));
+        nextChange = frame + hold(rng);
+        if (axis(rng) > 0) throwUntil = frame + hold(rng);
+    }
+    current.throwHeld = frame < throwUntil;
+    ++frame;
+    return current;
+}
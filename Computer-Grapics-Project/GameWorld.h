@@ -0,0 +1,103 @@
+﻿#pragma once
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <random>
+#include <gl/glm/glm.hpp>
+#include "Map.h"
+#include "Snow.h"
+#include "Snowball.h"
+#include "Character.h"
+#include "finish.h"
+
+namespace Steve { class Character; }
+namespace Alex { class Character; }
+
+constexpr int PLAYER_COUNT = 2;
+constexpr float TICK_DELTA_TIME = 0.016f;
+
+// 한 틱 동안 한 플레이어가 내리는 입력 (키 상태를 그대로 옮긴 값)
+struct PlayerInput {
+    glm::vec2 moveDir{ 0.0f };
+    glm::vec3 aim{ 0.0f, 0.0f, 1.0f };
+    bool throwHeld = false;
+};
+
+// 캐릭터 밖에서 관리하던 던지기 차징 상태
+struct PlayerState {
+    bool charging = false;
+    bool throwHeld = false;
+    unsigned int chargeStartTick = 0;
+};
+
+// 자체 테스트/부하 측정용 봇. 불규칙하게 방향을 바꾸고 차징 시간을 달리해 던진다.
+class InputBot
+{
+public:
+    InputBot(int player, unsigned int seed);
+    PlayerInput next();
+
+private:
+    int player;
+    std::mt19937 rng;
+    PlayerInput current;
+    int frame = 0;
+    int nextChange = 0;
+    int throwUntil = 0;
+};
+
+// 롤백에 필요한 월드 상태 전체 (렌더링 자원은 포함하지 않음)
+struct WorldSnapshot {
+    CharacterState characters[PLAYER_COUNT];
+    PlayerState players[PLAYER_COUNT];
+    std::vector<Snowball> snowballs;
+    std::map<std::pair<int, int>, SnowAnimationData> snow;
+    Winner winner = Winner::NONE;
+    unsigned int tickCount = 0;
+    unsigned short nextSnowballId = 1;
+};
+
+// 한 경기의 시뮬레이션 상태. 렌더링/입력 장치와 독립적으로 틱 단위로 진행한다.
+class GameWorld
+{
+public:
+    GameWorld();
+    ~GameWorld();
+
+    GameWorld(const GameWorld&) = delete;
+    GameWorld& operator=(const GameWorld&) = delete;
+
+    void initialize();
+    void reset();
+
+    void tick(const PlayerInput inputs[PLAYER_COUNT]);
+
+    // tick()을 이루는 단계들. 클라이언트 예측처럼 일부만 진행할 때 따로 호출한다.
+    void updateProjectiles();
+    void applyPlayerInput(int player, const PlayerInput& input, bool allowFire);
+
+    bool hasCharacters() const { return steve != nullptr && alex != nullptr; }
+    CharacterState getCharacterState(int player) const;
+    void setCharacterState(int player, const CharacterState& state);
+    glm::vec3 getCharacterPosition(int player) const;
+
+    void saveState(WorldSnapshot& out) const;
+    void loadState(const WorldSnapshot& in);
+    // 동기화 검사용 해시 (FNV-1a)
+    uint32_t checksum() const;
+
+    Map gameMap;
+    Snow snowSystem;
+    std::vector<Snowball> snowballs;
+    Steve::Character* steve = nullptr;
+    Alex::Character* alex = nullptr;
+
+    PlayerState players[PLAYER_COUNT];
+    Winner winner = Winner::NONE;
+    unsigned int tickCount = 0;
+    unsigned short nextSnowballId = 1;
+
+private:
+    void fireSnowball(int player, const glm::vec3& aim);
+    void checkAllSnowballCollisions();
+};
@@ -0,0 +1,534 @@
+﻿#define GL_INTERCEPT_IMPLEMENTATION
+#include "GlIntercept.h"
+#include "Profiler.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+const GLuint UNKNOWN = 0xFFFFFFFFu;
+const int MAX_TEXTURE_UNITS = 32;
+const int MAX_TRACKED_CAPS = 16;
+const int MAX_UNIFORM_FLOATS = 16;
+
+// 바인딩을 따로 추적하는 텍스처 타깃. 타깃마다 유닛별 바인딩이 따로 있다.
+const GLenum TEXTURE_TARGETS[] = { GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP };
+const int TEXTURE_TARGET_COUNT = sizeof(TEXTURE_TARGETS) / sizeof(TEXTURE_TARGETS[0]);
+
+struct UniformValue {
+    GLfloat data[MAX_UNIFORM_FLOATS];
+    int count = 0;
+};
+
+// 래퍼를 거친 호출로만 추적하는 GL 상태. UNKNOWN이면 다음 설정은 중복으로 치지 않는다.
+struct Shadow {
+    GLuint program = UNKNOWN;
+    GLuint vertexArray = UNKNOWN;
+    GLuint arrayBuffer = UNKNOWN;
+    GLuint elementBuffer = UNKNOWN;
+    GLenum activeUnit = UNKNOWN;
+    GLuint textures[TEXTURE_TARGET_COUNT][MAX_TEXTURE_UNITS];
+    GLenum caps[MAX_TRACKED_CAPS];
+    int capValues[MAX_TRACKED_CAPS];
+    int capCount = 0;
+    std::unordered_map<uint64_t, UniformValue> uniforms;
+};
+
+bool enabled = false;
+bool active = false;              // enabled 또는 덤프 중인 프레임
+Shadow shadow;
+
+GlIntercept::Counters frameCounters;
+GlIntercept::Counters zoneCounters[Profiler::MAX_ZONES + 1];
+GlIntercept::Counters lastCounters;
+GlIntercept::Counters lastZoneCounters[Profiler::MAX_ZONES + 1];
+std::unordered_map<std::string, int> lookups;     // 이번 프레임에 찾아본 (프로그램, 이름)
+
+std::string dumpPath;
+bool dumpRequested = false;
+int dumpDelay = 0;
+FILE* dumpFile = nullptr;
+uint32_t dumpLine = 0;
+
+void resetShadow()
+{
+    shadow.program = shadow.vertexArray = shadow.arrayBuffer = shadow.elementBuffer = UNKNOWN;
+    shadow.activeUnit = UNKNOWN;
+    for (auto& target : shadow.textures) {
+        for (GLuint& bound : target) bound = UNKNOWN;
+    }
+    shadow.capCount = 0;
+    shadow.uniforms.clear();
+}
+
+void note(GlIntercept::Category category, bool redundant, const char* format, ...)
+{
+    int zone = Profiler::activeZone();
+    frameCounters.calls[category]++;
+    zoneCounters[zone + 1].calls[category]++;
+    if (redundant) {
+        frameCounters.redundant[category]++;
+        zoneCounters[zone + 1].redundant[category]++;
+    }
+
+    if (!dumpFile) return;
+    char call[320];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(call, sizeof(call), format, args);
+    va_end(args);
+    std::fprintf(dumpFile, "%6u  %-22s %s%s\n", dumpLine++, zone >= 0 ? Profiler::zoneName(zone) : "-",
+        call, redundant ? "  [redundant]" : "");
+}
+
+void noteUploadBytes(size_t bytes)
+{
+    frameCounters.uploadBytes += bytes;
+    zoneCounters[Profiler::activeZone() + 1].uploadBytes += bytes;
+}
+
+// 압축하지 않은 업로드의 크기 (UNPACK_ALIGNMENT 여백은 치지 않는다)
+size_t pixelBytes(GLenum format, GLenum type, GLsizei width, GLsizei height, GLsizei depth)
+{
+    size_t channels = 4;
+    if (format == GL_RED || format == GL_DEPTH_COMPONENT) channels = 1;
+    else if (format == GL_RG) channels = 2;
+    else if (format == GL_RGB || format == GL_BGR) channels = 3;
+    size_t size = 1;
+    if (type == GL_FLOAT || type == GL_UNSIGNED_INT || type == GL_INT) size = 4;
+    else if (type == GL_HALF_FLOAT || type == GL_UNSIGNED_SHORT || type == GL_SHORT) size = 2;
+    return channels * size * static_cast<size_t>(width) * height * depth;
+}
+
+int textureTargetIndex(GLenum target)
+{
+    for (int i = 0; i < TEXTURE_TARGET_COUNT; ++i) {
+        if (TEXTURE_TARGETS[i] == target) return i;
+    }
+    return -1;
+}
+
+// 같은 값이면 true, 아니면 기록해 두고 false
+bool sameAsShadow(GLuint& slot, GLuint value)
+{
+    bool same = (slot == value);
+    slot = value;
+    return same;
+}
+
+bool sameUniform(GLint location, const GLfloat* values, int count)
+{
+    if (shadow.program == UNKNOWN || count > MAX_UNIFORM_FLOATS) return false;
+    uint64_t key = (static_cast<uint64_t>(shadow.program) << 32) | static_cast<uint32_t>(location);
+    UniformValue& v = shadow.uniforms[key];
+    bool same = (v.count == count && std::memcmp(v.data, values, count * sizeof(GLfloat)) == 0);
+    std::memcpy(v.data, values, count * sizeof(GLfloat));
+    v.count = count;
+    return same;
+}
+
+bool sameCap(GLenum cap, int value)
+{
+    for (int i = 0; i < shadow.capCount; ++i) {
+        if (shadow.caps[i] == cap) {
+            bool same = (shadow.capValues[i] == value);
+            shadow.capValues[i] = value;
+            return same;
+        }
+    }
+    if (shadow.capCount < MAX_TRACKED_CAPS) {
+        shadow.caps[shadow.capCount] = cap;
+        shadow.capValues[shadow.capCount] = value;
+        shadow.capCount++;
+    }
+    return false;
+}
+
+int activeUnitIndex()
+{
+    if (shadow.activeUnit == UNKNOWN) return -1;
+    int unit = static_cast<int>(shadow.activeUnit - GL_TEXTURE0);
+    return (unit >= 0 && unit < MAX_TEXTURE_UNITS) ? unit : -1;
+}
+
+void writeCounters(FILE* f, const char* label, const GlIntercept::Counters& c)
+{
+    std::fprintf(f, "%-22s %6u calls %6u redundant %8lluKB upload |", label, c.totalCalls(), c.totalRedundant(),
+        static_cast<unsigned long long>(c.uploadBytes / 1024));
+    for (int i = 0; i < GlIntercept::CATEGORY_COUNT; ++i) {
+        if (c.calls[i] > 0) std::fprintf(f, " %s %u/%u", GlIntercept::categoryName(i), c.calls[i], c.redundant[i]);
+    }
+    std::fputc('\n', f);
+}
+
+} // namespace
+
+uint32_t GlIntercept::Counters::totalCalls() const
+{
+    uint32_t total = 0;
+    for (int i = 0; i < CATEGORY_COUNT; ++i) total += calls[i];
+    return total;
+}
+
+uint32_t GlIntercept::Counters::totalRedundant() const
+{
+    uint32_t total = 0;
+    for (int i = 0; i < CATEGORY_COUNT; ++i) total += redundant[i];
+    return total;
+}
+
+const char* GlIntercept::categoryName(int category)
+{
+    static const char* const names[CATEGORY_COUNT] = {
+        "uniform", "lookup", "bind", "buffer", "draw", "state", "teximage", "other"
+    };
+    return (category >= 0 && category < CATEGORY_COUNT) ? names[category] : "?";
+}
+
+void GlIntercept::setEnabled(bool on)
+{
+    if (on && !active) resetShadow();
+    enabled = on;
+    active = enabled || dumpFile != nullptr;
+    std::cout << "GL 호출 집계: " << (enabled ? "ON" : "OFF") << std::endl;
+}
+
+bool GlIntercept::isEnabled()
+{
+    return enabled;
+}
+
+void GlIntercept::requestDump(const std::string& path, int delayFrames)
+{
+    dumpPath = path;
+    dumpRequested = true;
+    dumpDelay = delayFrames;
+}
+
+void GlIntercept::endFrame()
+{
+    lastCounters = frameCounters;
+    std::memcpy(lastZoneCounters, zoneCounters, sizeof(zoneCounters));
+    frameCounters = Counters();
+    for (auto& c : zoneCounters) c = Counters();
+    lookups.clear();
+
+    if (dumpFile) {
+        std::fprintf(dumpFile, "\n== summary ==\n");
+        writeCounters(dumpFile, "frame", lastCounters);
+        for (int z = -1; z < Profiler::zoneCount(); ++z) {
+            if (lastZoneCounters[z + 1].totalCalls() == 0) continue;
+            writeCounters(dumpFile, z >= 0 ? Profiler::zoneName(z) : "-", lastZoneCounters[z + 1]);
+        }
+        std::fclose(dumpFile);
+        dumpFile = nullptr;
+        std::cout << "GL 호출 기록 저장: " << dumpPath << " (" << lastCounters.totalCalls() << "회, 중복 "
+            << lastCounters.totalRedundant() << ")" << std::endl;
+    }
+
+    if (dumpRequested && dumpDelay-- <= 0) {
+        dumpRequested = false;
+        dumpFile = std::fopen(dumpPath.c_str(), "w");
+        if (!dumpFile) std::cerr << "GL 호출 기록 파일 열기 실패: " << dumpPath << std::endl;
+        else {
+            // 꺼져 있다가 이 프레임만 켜는 경우 추적 상태가 없어서 중복이 덜 잡힌다
+            if (!active) resetShadow();
+            dumpLine = 0;
+        }
+    }
+    active = enabled || dumpFile != nullptr;
+}
+
+const GlIntercept::Counters& GlIntercept::lastFrame()
+{
+    return lastCounters;
+}
+
+const GlIntercept::Counters& GlIntercept::lastFrameZone(int zone)
+{
+    return lastZoneCounters[zone + 1];
+}
+
+//--- 진입점
+
+void GlIntercept::uniform1i(GLint location, GLint v0)
+{
+    if (active) {
+        GLfloat value;
+        std::memcpy(&value, &v0, sizeof(value));
+        bool redundant = location < 0 || sameUniform(location, &value, 1);
+        note(CATEGORY_UNIFORM, redundant, "glUniform1i(%d, %d)", location, v0);
+    }
+    glUniform1i(location, v0);
+}
+
+void GlIntercept::uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    if (active) {
+        GLfloat values[3] = { v0, v1, v2 };
+        bool redundant = location < 0 || sameUniform(location, values, 3);
+        note(CATEGORY_UNIFORM, redundant, "glUniform3f(%d, %g, %g, %g)", location, v0, v1, v2);
+    }
+    glUniform3f(location, v0, v1, v2);
+}
+
+void GlIntercept::uniform3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    if (active) {
+        bool redundant = location < 0 || sameUniform(location, value, 3 * count);
+        note(CATEGORY_UNIFORM, redundant, "glUniform3fv(%d, %d, {%g, %g, %g%s})", location, count,
+            value[0], value[1], value[2], count > 1 ? ", ..." : "");
+    }
+    glUniform3fv(location, count, value);
+}
+
+void GlIntercept::uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    if (active) {
+        bool redundant = location < 0 || sameUniform(location, value, 9 * count);
+        note(CATEGORY_UNIFORM, redundant, "glUniformMatrix3fv(%d, %d, %d, {%g, %g, %g, ...})", location, count,
+            transpose, value[0], value[4], value[8]);
+    }
+    glUniformMatrix3fv(location, count, transpose, value);
+}
+
+void GlIntercept::uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    if (active) {
+        bool redundant = location < 0 || sameUniform(location, value, 16 * count);
+        note(CATEGORY_UNIFORM, redundant, "glUniformMatrix4fv(%d, %d, %d, {%g, %g, %g, ..., %g, %g, %g})", location,
+            count, transpose, value[0], value[5], value[10], value[12], value[13], value[14]);
+    }
+    glUniformMatrix4fv(location, count, transpose, value);
+}
+
+GLint GlIntercept::getUniformLocation(GLuint program, const GLchar* name)
+{
+    GLint location = glGetUniformLocation(program, name);
+    if (active) {
+        // 같은 프레임에 같은 이름을 다시 찾으면 중복 (캐시해 둘 수 있는 호출)
+        int& seen = lookups[std::to_string(program) + ":" + name];
+        note(CATEGORY_UNIFORM_LOOKUP, seen++ > 0, "glGetUniformLocation(%u, \"%s\") = %d", program, name, location);
+    }
+    return location;
+}
+
+void GlIntercept::useProgram(GLuint program)
+{
+    if (active) note(CATEGORY_BIND, sameAsShadow(shadow.program, program), "glUseProgram(%u)", program);
+    glUseProgram(program);
+}
+
+void GlIntercept::bindVertexArray(GLuint array)
+{
+    if (active) {
+        bool redundant = sameAsShadow(shadow.vertexArray, array);
+        if (!redundant) shadow.elementBuffer = UNKNOWN;     // 인덱스 버퍼 바인딩은 VAO 상태
+        note(CATEGORY_BIND, redundant, "glBindVertexArray(%u)", array);
+    }
+    glBindVertexArray(array);
+}
+
+void GlIntercept::bindBuffer(GLenum target, GLuint buffer)
+{
+    if (active) {
+        bool redundant = false;
+        if (target == GL_ARRAY_BUFFER) redundant = sameAsShadow(shadow.arrayBuffer, buffer);
+        else if (target == GL_ELEMENT_ARRAY_BUFFER) redundant = sameAsShadow(shadow.elementBuffer, buffer);
+        note(CATEGORY_BIND, redundant, "glBindBuffer(0x%04X, %u)", target, buffer);
+    }
+    glBindBuffer(target, buffer);
+}
+
+void GlIntercept::bindTexture(GLenum target, GLuint texture)
+{
+    if (active) {
+        bool redundant = false;
+        int unit = activeUnitIndex();
+        int index = textureTargetIndex(target);
+        if (index >= 0 && unit >= 0) redundant = sameAsShadow(shadow.textures[index][unit], texture);
+        note(CATEGORY_BIND, redundant, "glBindTexture(0x%04X, %u)", target, texture);
+    }
+    glBindTexture(target, texture);
+}
+
+void GlIntercept::activeTexture(GLenum texture)
+{
+    if (active) note(CATEGORY_STATE, sameAsShadow(shadow.activeUnit, texture), "glActiveTexture(GL_TEXTURE%d)", texture - GL_TEXTURE0);
+    glActiveTexture(texture);
+}
+
+void GlIntercept::bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    if (active) note(CATEGORY_BUFFER_DATA, false, "glBufferData(0x%04X, %lld, %p, 0x%04X)", target,
+        static_cast<long long>(size), data, usage);
+    glBufferData(target, size, data, usage);
+}
+
+void GlIntercept::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    if (active) note(CATEGORY_BUFFER_DATA, false, "glBufferSubData(0x%04X, %lld, %lld, %p)", target,
+        static_cast<long long>(offset), static_cast<long long>(size), data);
+    glBufferSubData(target, offset, size, data);
+}
+
+void GlIntercept::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    if (active) note(CATEGORY_DRAW, false, "glDrawArrays(0x%04X, %d, %d)", mode, first, count);
+    glDrawArrays(mode, first, count);
+}
+
+void GlIntercept::drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+{
+    if (active) note(CATEGORY_DRAW, false, "glDrawArraysInstanced(0x%04X, %d, %d, %d)", mode, first, count, instances);
+    glDrawArraysInstanced(mode, first, count, instances);
+}
+
+void GlIntercept::drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    if (active) note(CATEGORY_DRAW, false, "glDrawElements(0x%04X, %d, 0x%04X, %p)", mode, count, type, indices);
+    glDrawElements(mode, count, type, indices);
+}
+
+void GlIntercept::enable(GLenum cap)
+{
+    if (active) note(CATEGORY_STATE, sameCap(cap, 1), "glEnable(0x%04X)", cap);
+    glEnable(cap);
+}
+
+void GlIntercept::disable(GLenum cap)
+{
+    if (active) note(CATEGORY_STATE, sameCap(cap, 0), "glDisable(0x%04X)", cap);
+    glDisable(cap);
+}
+
+void GlIntercept::texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+    GLint border, GLenum format, GLenum type, const void* pixels)
+{
+    if (active) {
+        noteUploadBytes(pixelBytes(format, type, width, height, 1));
+        note(CATEGORY_TEXTURE_UPLOAD, false, "glTexImage2D(0x%04X, %d, 0x%04X, %d, %d, %d, 0x%04X, 0x%04X, %p)",
+            target, level, internalformat, width, height, border, format, type, pixels);
+    }
+    glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+void GlIntercept::texImage3D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth,
+    GLint border, GLenum format, GLenum type, const void* pixels)
+{
+    if (active) {
+        noteUploadBytes(pixelBytes(format, type, width, height, depth));
+        note(CATEGORY_TEXTURE_UPLOAD, false, "glTexImage3D(0x%04X, %d, 0x%04X, %d, %d, %d, %d, 0x%04X, 0x%04X, %p)",
+            target, level, internalformat, width, height, depth, border, format, type, pixels);
+    }
+    glTexImage3D(target, level, internalformat, width, height, depth, border, format, type, pixels);
+}
+
+void GlIntercept::texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+    GLenum format, GLenum type, const void* pixels)
+{
+    if (active) {
+        noteUploadBytes(pixelBytes(format, type, width, height, 1));
+        note(CATEGORY_TEXTURE_UPLOAD, false, "glTexSubImage2D(0x%04X, %d, %d, %d, %d, %d, 0x%04X, 0x%04X, %p)",
+            target, level, xoffset, yoffset, width, height, format, type, pixels);
+    }
+    glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+}
+
+void GlIntercept::texSubImage3D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width,
+    GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels)
+{
+    if (active) {
+        noteUploadBytes(pixelBytes(format, type, width, height, depth));
+        note(CATEGORY_TEXTURE_UPLOAD, false, "glTexSubImage3D(0x%04X, %d, %d, %d, %d, %d, %d, %d, 0x%04X, 0x%04X, %p)",
+            target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels);
+    }
+    glTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels);
+}
+
+void GlIntercept::compressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
+    GLint border, GLsizei imageSize, const void* data)
+{
+    if (active) {
+        noteUploadBytes(static_cast<size_t>(imageSize));
+        note(CATEGORY_TEXTURE_UPLOAD, false, "glCompressedTexImage2D(0x%04X, %d, 0x%04X, %d, %d, %d, %d, %p)",
+            target, level, internalformat, width, height, border, imageSize, data);
+    }
+    glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+}
+
+void GlIntercept::compressedTexImage3D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
+    GLsizei depth, GLint border, GLsizei imageSize, const void* data)
+{
+    if (active) {
+        noteUploadBytes(static_cast<size_t>(imageSize));
+        note(CATEGORY_TEXTURE_UPLOAD, false, "glCompressedTexImage3D(0x%04X, %d, 0x%04X, %d, %d, %d, %d, %d, %p)",
+            target, level, internalformat, width, height, depth, border, imageSize, data);
+    }
+    glCompressedTexImage3D(target, level, internalformat, width, height, depth, border, imageSize, data);
+}
+
+void GlIntercept::compressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width,
+    GLsizei height, GLenum format, GLsizei imageSize, const void* data)
+{
+    if (active) {
+        noteUploadBytes(static_cast<size_t>(imageSize));
+        note(CATEGORY_TEXTURE_UPLOAD, false, "glCompressedTexSubImage2D(0x%04X, %d, %d, %d, %d, %d, 0x%04X, %d, %p)",
+            target, level, xoffset, yoffset, width, height, format, imageSize, data);
+    }
+    glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
+}
+
+void GlIntercept::compressedTexSubImage3D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset,
+    GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void* data)
+{
+    if (active) {
+        noteUploadBytes(static_cast<size_t>(imageSize));
+        note(CATEGORY_TEXTURE_UPLOAD, false, "glCompressedTexSubImage3D(0x%04X, %d, %d, %d, %d, %d, %d, %d, 0x%04X, %d, %p)",
+            target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data);
+    }
+    glCompressedTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data);
+}
+
+// 지운 이름이 바인딩돼 있었으면 GL이 0으로 되돌린다. 이름이 재사용될 수 있으니 추적 상태도 맞춘다.
+void GlIntercept::deleteTextures(GLsizei n, const GLuint* textures)
+{
+    if (active) {
+        for (GLsizei i = 0; i < n; ++i) {
+            for (auto& target : shadow.textures) {
+                for (GLuint& bound : target) if (bound == textures[i]) bound = 0;
+            }
+        }
+        note(CATEGORY_OTHER, false, "glDeleteTextures(%d, {%u%s})", n, n > 0 ? textures[0] : 0, n > 1 ? ", ..." : "");
+    }
+    glDeleteTextures(n, textures);
+}
+
+void GlIntercept::deleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    if (active) {
+        for (GLsizei i = 0; i < n; ++i) {
+            if (shadow.arrayBuffer == buffers[i]) shadow.arrayBuffer = 0;
+            if (shadow.elementBuffer == buffers[i]) shadow.elementBuffer = 0;
+        }
+        note(CATEGORY_OTHER, false, "glDeleteBuffers(%d, {%u%s})", n, n > 0 ? buffers[0] : 0, n > 1 ? ", ..." : "");
+    }
+    glDeleteBuffers(n, buffers);
+}
+
+void GlIntercept::deleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    if (active) {
+        for (GLsizei i = 0; i < n; ++i) {
+            if (shadow.vertexArray == arrays[i]) {
+                shadow.vertexArray = 0;
+                shadow.elementBuffer = UNKNOWN;
+            }
+        }
+        note(CATEGORY_OTHER, false, "glDeleteVertexArrays(%d, {%u%s})", n, n > 0 ? arrays[0] : 0, n > 1 ? ", ..." : "");
+    }
+    glDeleteVertexArrays(n, arrays);
+}
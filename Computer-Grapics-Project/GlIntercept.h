@@ -0,0 +1,154 @@
+﻿#pragma once
+#include <gl/glew.h>
+#include <cstdint>
+#include <string>
+
+// GL 호출 가로채기. GL 헤더 다음에 이 헤더를 포함하면 아래 진입점이 GlIntercept:: 함수로
+// 바뀌어서, 켜 둔 동안 프레임별/구간별(Profiler 구간) 호출 수를 세고 이미 같은 값인
+// 바인드/상태/유니폼 설정을 "중복"으로 표시한다. 한 프레임의 호출 전체를 파일로 떨굴 수도 있다.
+// 꺼져 있으면 분기 하나 뒤에 원래 함수를 부르고, GL_INTERCEPT_ENABLED를 0으로 빌드하면 아예 없다.
+//
+// 중복 판정은 이 래퍼를 거친 호출만 보고 추적한 상태로 한다. 그래서 GL을 부르는 파일은
+// 모두 이 헤더를 거쳐야 한다 (GpuTimer처럼 바인드 상태를 건드리지 않는 곳은 예외).
+#ifndef GL_INTERCEPT_ENABLED
+#define GL_INTERCEPT_ENABLED 1
+#endif
+
+namespace GlIntercept {
+    enum Category {
+        CATEGORY_UNIFORM,
+        CATEGORY_UNIFORM_LOOKUP,
+        CATEGORY_BIND,
+        CATEGORY_BUFFER_DATA,
+        CATEGORY_DRAW,
+        CATEGORY_STATE,
+        CATEGORY_TEXTURE_UPLOAD,
+        CATEGORY_OTHER,
+        CATEGORY_COUNT
+    };
+
+    struct Counters {
+        uint32_t calls[CATEGORY_COUNT] = {};
+        uint32_t redundant[CATEGORY_COUNT] = {};
+        uint64_t uploadBytes = 0;       // 텍스처 업로드 호출이 넘긴 픽셀 양 (PBO 오프셋이어도 센다)
+
+        uint32_t totalCalls() const;
+        uint32_t totalRedundant() const;
+    };
+
+    const char* categoryName(int category);
+
+    // 켤 때마다 추적 상태를 "모름"으로 되돌린다 (꺼져 있던 동안의 변화를 모르므로)
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    // delayFrames 뒤 프레임 하나의 호출을 전부 path에 쓴다 (꺼져 있었으면 그 프레임 동안만 켠다)
+    void requestDump(const std::string& path, int delayFrames = 0);
+
+    // 메인 스레드에서 화면 한 장이 끝날 때마다 (PROFILE_FRAME_END 옆)
+    void endFrame();
+
+    // 지난 프레임 값. zone은 Profiler 구간 번호이고 -1이면 구간 밖에서 한 호출.
+    const Counters& lastFrame();
+    const Counters& lastFrameZone(int zone);
+
+    // 가로채는 진입점
+    void uniform1i(GLint location, GLint v0);
+    void uniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+    void uniform3fv(GLint location, GLsizei count, const GLfloat* value);
+    void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    GLint getUniformLocation(GLuint program, const GLchar* name);
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint array);
+    void bindBuffer(GLenum target, GLuint buffer);
+    void bindTexture(GLenum target, GLuint texture);
+    void activeTexture(GLenum texture);
+    void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+    void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+    void drawArrays(GLenum mode, GLint first, GLsizei count);
+    void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+    void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+    void enable(GLenum cap);
+    void disable(GLenum cap);
+    void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+        GLint border, GLenum format, GLenum type, const void* pixels);
+    void texImage3D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth,
+        GLint border, GLenum format, GLenum type, const void* pixels);
+    void texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+        GLenum format, GLenum type, const void* pixels);
+    void texSubImage3D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width,
+        GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels);
+    void compressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
+        GLint border, GLsizei imageSize, const void* data);
+    void compressedTexImage3D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
+        GLsizei depth, GLint border, GLsizei imageSize, const void* data);
+    void compressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width,
+        GLsizei height, GLenum format, GLsizei imageSize, const void* data);
+    void compressedTexSubImage3D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset,
+        GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void* data);
+    void deleteTextures(GLsizei n, const GLuint* textures);
+    void deleteBuffers(GLsizei n, const GLuint* buffers);
+    void deleteVertexArrays(GLsizei n, const GLuint* arrays);
+}
+
+#if GL_INTERCEPT_ENABLED && !defined(GL_INTERCEPT_IMPLEMENTATION)
+#undef glUniform1i
+#undef glUniform3f
+#undef glUniform3fv
+#undef glUniformMatrix3fv
+#undef glUniformMatrix4fv
+#undef glGetUniformLocation
+#undef glUseProgram
+#undef glBindVertexArray
+#undef glBindBuffer
+#undef glBindTexture
+#undef glActiveTexture
+#undef glBufferData
+#undef glBufferSubData
+#undef glDrawArrays
+#undef glDrawArraysInstanced
+#undef glDrawElements
+#undef glEnable
+#undef glDisable
+#undef glTexImage2D
+#undef glTexImage3D
+#undef glTexSubImage2D
+#undef glTexSubImage3D
+#undef glCompressedTexImage2D
+#undef glCompressedTexImage3D
+#undef glCompressedTexSubImage2D
+#undef glCompressedTexSubImage3D
+#undef glDeleteTextures
+#undef glDeleteBuffers
+#undef glDeleteVertexArrays
+#define glUniform1i GlIntercept::uniform1i
+#define glUniform3f GlIntercept::uniform3f
+#define glUniform3fv GlIntercept::uniform3fv
+#define glUniformMatrix3fv GlIntercept::uniformMatrix3fv
+#define glUniformMatrix4fv GlIntercept::uniformMatrix4fv
+#define glGetUniformLocation GlIntercept::getUniformLocation
+#define glUseProgram GlIntercept::useProgram
+#define glBindVertexArray GlIntercept::bindVertexArray
+#define glBindBuffer GlIntercept::bindBuffer
+#define glBindTexture GlIntercept::bindTexture
+#define glActiveTexture GlIntercept::activeTexture
+#define glBufferData GlIntercept::bufferData
+#define glBufferSubData GlIntercept::bufferSubData
+#define glDrawArrays GlIntercept::drawArrays
+#define glDrawArraysInstanced GlIntercept::drawArraysInstanced
+#define glDrawElements GlIntercept::drawElements
+#define glEnable GlIntercept::enable
+#define glDisable GlIntercept::disable
+#define glTexImage2D GlIntercept::texImage2D
+#define glTexImage3D GlIntercept::texImage3D
+#define glTexSubImage2D GlIntercept::texSubImage2D
+#define glTexSubImage3D GlIntercept::texSubImage3D
+#define glCompressedTexImage2D GlIntercept::compressedTexImage2D
+#define glCompressedTexImage3D GlIntercept::compressedTexImage3D
+#define glCompressedTexSubImage2D GlIntercept::compressedTexSubImage2D
+#define glCompressedTexSubImage3D GlIntercept::compressedTexSubImage3D
+#define glDeleteTextures GlIntercept::deleteTextures
+#define glDeleteBuffers GlIntercept::deleteBuffers
+#define glDeleteVertexArrays GlIntercept::deleteVertexArrays
+#endif
@@ -0,0 +1,178 @@
+﻿#include "GlState.h"
+
+namespace {
+    const GLint UNKNOWN = -1;
+
+    struct Shadow {
+        GLint program = UNKNOWN;
+        GLint vertexArray = UNKNOWN;
+        GLint activeUnit = UNKNOWN;                  // 0부터
+        GLint textures[GlState::MAX_TEXTURE_UNITS];
+        GLint textureArrays[GlState::MAX_TEXTURE_UNITS];
+        GLint blend = UNKNOWN;
+        GLint depthTest = UNKNOWN;
+        GLint cullFace = UNKNOWN;
+        GLint blendSrc = UNKNOWN;
+        GLint blendDst = UNKNOWN;
+        GLint cullMode = UNKNOWN;
+        GLint frontMode = UNKNOWN;
+
+        Shadow() {
+            for (GLint& t : textures) t = UNKNOWN;
+            for (GLint& t : textureArrays) t = UNKNOWN;
+        }
+    };
+
+    Shadow shadow;
+    GlState::Counters frameCounters;
+    GlState::Counters lastCounters;
+
+    // 이미 value면 생략하고 false, 아니면 기억하고 true
+    bool change(GLint& slot, GLint value, GlState::Kind kind)
+    {
+        if (slot == value) {
+            ++frameCounters.elided[kind];
+            return false;
+        }
+        slot = value;
+        ++frameCounters.issued[kind];
+        return true;
+    }
+
+    GLint* capabilitySlot(GLenum cap)
+    {
+        switch (cap) {
+        case GL_BLEND: return &shadow.blend;
+        case GL_DEPTH_TEST: return &shadow.depthTest;
+        case GL_CULL_FACE: return &shadow.cullFace;
+        default: return nullptr;
+        }
+    }
+}
+
+uint32_t GlState::Counters::totalIssued() const
+{
+    uint32_t total = 0;
+    for (uint32_t c : issued) total += c;
+    return total;
+}
+
+uint32_t GlState::Counters::totalElided() const
+{
+    uint32_t total = 0;
+    for (uint32_t c : elided) total += c;
+    return total;
+}
+
+const char* GlState::kindName(int kind)
+{
+    switch (kind) {
+    case KIND_PROGRAM: return "program";
+    case KIND_VERTEX_ARRAY: return "vao";
+    case KIND_TEXTURE: return "texture";
+    case KIND_CAPABILITY: return "enable";
+    case KIND_FUNCTION: return "func";
+    default: return "?";
+    }
+}
+
+void GlState::useProgram(GLuint program)
+{
+    if (change(shadow.program, static_cast<GLint>(program), KIND_PROGRAM)) glUseProgram(program);
+}
+
+void GlState::bindVertexArray(GLuint vao)
+{
+    if (change(shadow.vertexArray, static_cast<GLint>(vao), KIND_VERTEX_ARRAY)) glBindVertexArray(vao);
+}
+
+void GlState::activeTexture(GLenum unit)
+{
+    if (change(shadow.activeUnit, static_cast<GLint>(unit - GL_TEXTURE0), KIND_TEXTURE)) glActiveTexture(unit);
+}
+
+void GlState::bindTexture(GLenum target, GLuint texture)
+{
+    GLint unit = shadow.activeUnit;
+    GLint* slots = (target == GL_TEXTURE_2D) ? shadow.textures : (target == GL_TEXTURE_2D_ARRAY) ? shadow.textureArrays : nullptr;
+    if (!slots || unit < 0 || unit >= MAX_TEXTURE_UNITS) {
+        // 유닛을 모르면 어느 칸인지 모르니 기억하지 않는다
+        ++frameCounters.issued[KIND_TEXTURE];
+        glBindTexture(target, texture);
+        return;
+    }
+    if (change(slots[unit], static_cast<GLint>(texture), KIND_TEXTURE)) glBindTexture(target, texture);
+}
+
+void GlState::setEnabled(GLenum cap, bool enabled)
+{
+    GLint* slot = capabilitySlot(cap);
+    if (slot) {
+        if (!change(*slot, enabled ? 1 : 0, KIND_CAPABILITY)) return;
+    }
+    else {
+        ++frameCounters.issued[KIND_CAPABILITY];
+    }
+
+    if (enabled) glEnable(cap);
+    else glDisable(cap);
+}
+
+void GlState::blendFunc(GLenum src, GLenum dst)
+{
+    if (shadow.blendSrc == static_cast<GLint>(src) && shadow.blendDst == static_cast<GLint>(dst)) {
+        ++frameCounters.elided[KIND_FUNCTION];
+        return;
+    }
+    shadow.blendSrc = static_cast<GLint>(src);
+    shadow.blendDst = static_cast<GLint>(dst);
+    ++frameCounters.issued[KIND_FUNCTION];
+    glBlendFunc(src, dst);
+}
+
+void GlState::cullFace(GLenum mode)
+{
+    if (change(shadow.cullMode, static_cast<GLint>(mode), KIND_FUNCTION)) glCullFace(mode);
+}
+
+void GlState::frontFace(GLenum mode)
+{
+    if (change(shadow.frontMode, static_cast<GLint>(mode), KIND_FUNCTION)) glFrontFace(mode);
+}
+
+void GlState::deleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    for (GLsizei i = 0; i < n; ++i) {
+        if (static_cast<GLint>(arrays[i]) == shadow.vertexArray) shadow.vertexArray = 0;
+    }
+    glDeleteVertexArrays(n, arrays);
+}
+
+void GlState::deleteTextures(GLsizei n, const GLuint* textures)
+{
+    for (GLsizei i = 0; i < n; ++i) {
+        for (GLint& bound : shadow.textures) {
+            if (static_cast<GLint>(textures[i]) == bound) bound = 0;
+        }
+        for (GLint& bound : shadow.textureArrays) {
+            if (static_cast<GLint>(textures[i]) == bound) bound = 0;
+        }
+    }
+    glDeleteTextures(n, textures);
+}
+
+void GlState::invalidate()
+{
+    shadow = Shadow();
+}
+
+void GlState::endFrame()
+{
+    lastCounters = frameCounters;
+    frameCounters = Counters();
+}
+
+const GlState::Counters& GlState::lastFrame()
+{
+    return lastCounters;
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+#include <gl/glew.h>
+#include "GlIntercept.h"
+#include <cstdint>
+
+// GL 상태 그림자. 바인드된 프로그램/VAO, 텍스처 유닛별 2D/2D 배열 텍스처, 블렌드/깊이/컬링 켜짐과
+// 블렌드 식/컬링 면을 기억해 두고, 값이 그대로인 호출은 드라이버로 보내지 않는다.
+// 렌더 백엔드와 HUD는 이 함수로만 이 상태들을 바꾼다. (GlIntercept는 실제로 나간 호출만 센다)
+//
+// 그림자는 여기를 거친 호출만 안다. 다른 경로로 GL 상태를 바꿨으면 invalidate()로 "모름"으로
+// 돌려야 한다. 모르는 값은 다음 호출이 무조건 나가면서 다시 알게 된다.
+namespace GlState {
+    const int MAX_TEXTURE_UNITS = 8;
+
+    enum Kind {
+        KIND_PROGRAM,
+        KIND_VERTEX_ARRAY,
+        KIND_TEXTURE,          // 바인드 + 활성 유닛
+        KIND_CAPABILITY,       // glEnable/glDisable
+        KIND_FUNCTION,         // 블렌드 식, 컬링 면, 앞면 방향
+        KIND_COUNT
+    };
+
+    struct Counters {
+        uint32_t issued[KIND_COUNT] = {};
+        uint32_t elided[KIND_COUNT] = {};
+
+        uint32_t totalIssued() const;
+        uint32_t totalElided() const;
+    };
+
+    const char* kindName(int kind);
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void activeTexture(GLenum unit);
+    // GL_TEXTURE_2D와 GL_TEXTURE_2D_ARRAY만 유닛별로 기억한다. 다른 대상은 그대로 보낸다.
+    void bindTexture(GLenum target, GLuint texture);
+
+    // GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE만 기억한다. 다른 값은 그대로 보낸다.
+    void setEnabled(GLenum cap, bool enabled);
+    inline void enable(GLenum cap) { setEnabled(cap, true); }
+    inline void disable(GLenum cap) { setEnabled(cap, false); }
+
+    void blendFunc(GLenum src, GLenum dst);
+    void cullFace(GLenum mode);
+    void frontFace(GLenum mode);
+
+    // 지우면서 바인드돼 있던 이름은 0으로 (GL이 하는 것과 같다)
+    void deleteVertexArrays(GLsizei n, const GLuint* arrays);
+    void deleteTextures(GLsizei n, const GLuint* textures);
+
+    void invalidate();
+
+    // 화면 한 장이 끝날 때마다 (GlIntercept::endFrame 옆)
+    void endFrame();
+    const Counters& lastFrame();
+}
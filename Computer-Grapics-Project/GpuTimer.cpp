@@ -0,0 +1,183 @@
+﻿#include "GpuTimer.h"
+#include <gl/glew.h>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// 구간 하나 (같은 이름이 한 프레임에 여러 번 나오면 각각 따로)
+struct Instance {
+    int zone = 0;
+    double cpuStart = 0.0;
+    double gpuSeconds = 0.0;
+    double gpuStart = 0.0;
+    bool started = false;
+};
+
+// 쿼리 하나로 잰 조각. 그 순간 열려 있던 구간 모두에 더한다.
+struct Segment {
+    GLuint query = 0;
+    int instances[GpuTimer::MAX_DEPTH];
+    int depth = 0;
+};
+
+struct FrameSlot {
+    std::vector<GLuint> queries;       // 슬롯마다 재사용 (모자랄 때만 새로 만든다)
+    std::vector<Segment> segments;
+    std::vector<Instance> instances;
+    bool pending = false;
+};
+
+bool available = false;
+FrameSlot slots[GpuTimer::FRAME_LATENCY];
+int currentSlot = -1;
+int stack[GpuTimer::MAX_DEPTH];
+int depth = 0;
+bool segmentOpen = false;
+uint64_t frameNumber = 0;
+uint64_t resolved = 0;
+uint64_t dropped = 0;
+
+// Mesa llvmpipe는 컨텍스트에서 처음 래스터화하는 쿼리에 시작 시각 대신 0을 써서 부팅 후
+// 경과 시간 같은 값이 나온다. 한 조각이 이보다 길면 그 프레임은 믿지 않는다.
+const double MAX_SEGMENT_SECONDS = 1.0;
+
+void openSegment(FrameSlot& slot)
+{
+    size_t index = slot.segments.size();
+    if (index >= slot.queries.size()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        slot.queries.push_back(query);
+    }
+    Segment s;
+    s.query = slot.queries[index];
+    s.depth = depth;
+    for (int i = 0; i < depth; ++i) s.instances[i] = stack[i];
+    slot.segments.push_back(s);
+    glBeginQuery(GL_TIME_ELAPSED, s.query);
+    segmentOpen = true;
+}
+
+void closeSegment()
+{
+    if (!segmentOpen) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    segmentOpen = false;
+}
+
+void resolve(FrameSlot& slot)
+{
+    if (slot.segments.empty()) return;
+
+    // 쿼리는 넣은 순서대로 끝나므로 마지막 것만 확인하면 된다
+    GLuint ready = 0;
+    glGetQueryObjectuiv(slot.segments.back().query, GL_QUERY_RESULT_AVAILABLE, &ready);
+    if (!ready) {
+        dropped++;
+        return;
+    }
+
+    // GPU는 조각들을 순서대로 실행했다고 보고, 첫 구간을 제출한 CPU 시각에 맞춰 이어 붙인다
+    static std::vector<double> results;
+    results.resize(slot.segments.size());
+    for (size_t i = 0; i < slot.segments.size(); ++i) {
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(slot.segments[i].query, GL_QUERY_RESULT, &nanoseconds);
+        results[i] = nanoseconds * 1e-9;
+        if (results[i] > MAX_SEGMENT_SECONDS) {
+            dropped++;
+            return;
+        }
+    }
+
+    double cursor = slot.instances.front().cpuStart;
+    for (size_t k = 0; k < slot.segments.size(); ++k) {
+        const Segment& s = slot.segments[k];
+        double seconds = results[k];
+        for (int i = 0; i < s.depth; ++i) {
+            Instance& inst = slot.instances[s.instances[i]];
+            if (!inst.started) {
+                inst.gpuStart = cursor;
+                inst.started = true;
+            }
+            inst.gpuSeconds += seconds;
+        }
+        cursor += seconds;
+    }
+    for (const Instance& inst : slot.instances) {
+        Profiler::addGpuZone(inst.zone, inst.gpuStart, inst.gpuStart + inst.gpuSeconds);
+    }
+    resolved++;
+}
+
+} // namespace
+
+bool GpuTimer::initialize()
+{
+    available = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (!available) std::cout << "GPU 타이머 쿼리 미지원: GPU 구간 시간 없이 진행" << std::endl;
+    return available;
+}
+
+bool GpuTimer::isAvailable()
+{
+    return available;
+}
+
+void GpuTimer::beginFrame()
+{
+    if (!available) return;
+
+    // 지난 프레임에 닫히지 않은 구간이 있으면 (중간 return 등) 여기서 정리
+    closeSegment();
+    depth = 0;
+
+    currentSlot = static_cast<int>(frameNumber++ % FRAME_LATENCY);
+    FrameSlot& slot = slots[currentSlot];
+    if (slot.pending) resolve(slot);
+    slot.segments.clear();
+    slot.instances.clear();
+    slot.pending = true;
+}
+
+void GpuTimer::beginZone(int zone)
+{
+    if (!available || currentSlot < 0) return;
+    if (depth >= MAX_DEPTH) {
+        depth++;          // 너무 깊은 구간은 재지 않고 짝만 맞춘다
+        return;
+    }
+
+    FrameSlot& slot = slots[currentSlot];
+    closeSegment();
+    Instance inst;
+    inst.zone = zone;
+    inst.cpuStart = Profiler::now();
+    slot.instances.push_back(inst);
+    stack[depth++] = static_cast<int>(slot.instances.size()) - 1;
+    openSegment(slot);
+}
+
+void GpuTimer::endZone()
+{
+    if (!available || currentSlot < 0 || depth == 0) return;
+    if (depth > MAX_DEPTH) {
+        depth--;
+        return;
+    }
+
+    closeSegment();
+    depth--;
+    if (depth > 0) openSegment(slots[currentSlot]);
+}
+
+uint64_t GpuTimer::resolvedFrames()
+{
+    return resolved;
+}
+
+uint64_t GpuTimer::droppedFrames()
+{
+    return dropped;
+}
@@ -0,0 +1,47 @@
+﻿#pragma once
+#include <cstdint>
+#include "Profiler.h"
+
+// 렌더 패스별 GPU 시간 (GL_TIME_ELAPSED 타이머 쿼리).
+// 쿼리는 프레임마다 다른 슬롯에 쌓고 FRAME_LATENCY 프레임 뒤에 결과를 읽으므로 CPU가 GPU를
+// 기다리지 않는다. 그때까지도 결과가 안 나왔으면 기다리지 않고 그 프레임을 버린다.
+// 읽은 값은 Profiler로 넘겨서 HUD와 트레이스("GPU" 트랙)에 같이 나온다.
+//
+// TIME_ELAPSED 쿼리는 한 번에 하나만 열 수 있어서, 구간이 겹치면 바깥 구간을 잠시 닫고
+// 안쪽 구간 조각을 재서 바깥 구간에도 더한다. 그래서 바깥 구간 값도 안쪽을 포함한 시간이다.
+namespace GpuTimer {
+    const int FRAME_LATENCY = 4;
+    const int MAX_DEPTH = 8;
+
+    // GL 컨텍스트를 만든 뒤 한 번. 타이머 쿼리를 못 쓰면 false이고 이후 호출은 모두 무시된다.
+    bool initialize();
+    bool isAvailable();
+
+    // drawScene 처음에 (PROFILE_FRAME_END 다음). 오래된 슬롯의 결과를 회수하고 새 슬롯을 연다.
+    void beginFrame();
+    void beginZone(int zone);
+    void endZone();
+
+    uint64_t resolvedFrames();
+    uint64_t droppedFrames();      // 결과가 늦어 버린 프레임 수
+
+    class ScopedZone
+    {
+    public:
+        explicit ScopedZone(int zone) { beginZone(zone); }
+        ~ScopedZone() { endZone(); }
+
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+    };
+}
+
+#if PROFILER_ENABLED
+#define GPU_SCOPE(name) \
+    static const int PROFILE_CONCAT(gpuZone, __LINE__) = Profiler::registerZone(name); \
+    GpuTimer::ScopedZone PROFILE_CONCAT(gpuTimer, __LINE__)(PROFILE_CONCAT(gpuZone, __LINE__))
+#define GPU_FRAME_BEGIN() GpuTimer::beginFrame()
+#else
+#define GPU_SCOPE(name) do {} while (0)
+#define GPU_FRAME_BEGIN() do {} while (0)
+#endif
@@ -36,47 +36,20 @@ void Ground::initializeBlocks(float startX, float startY, float startZ, float bl
         for (int z = 0; z < depth; ++z) {
             float posX = startX + x * blockSize;
             float posZ = startZ + z * blockSize;
-            blocks[x][z] = Block(posX, startY, posZ, blockSize);
+            Block& block = blocks[x][z];
+            block.setPosition(posX, startY, posZ);
+            block.setSize(blockSize);
         }
     }
 }
 
-void Ground::render() const
+void Ground::render(Render::DrawList& out) const
 {
-        extern GLuint shaderProgramID;
-    extern glm::vec3 cameraPos;
-    
-    GLint lightPosLoc = glGetUniformLocation(shaderProgramID, "lightPos");
-    GLint lightColorLoc = glGetUniformLocation(shaderProgramID, "lightColor");
-    GLint viewPosLoc = glGetUniformLocation(shaderProgramID, "viewPos");
-    GLint vColorLoc = glGetUniformLocation(shaderProgramID, "vColor");
-    GLint lightingEnabledLoc = glGetUniformLocation(shaderProgramID, "lightingEnabled");
-    GLint modelLoc = glGetUniformLocation(shaderProgramID, "model");
-    GLint normalMatrixLoc = glGetUniformLocation(shaderProgramID, "normalMatrix");
-    
-    if (lightingEnabledLoc != -1) {
-        glUniform1i(lightingEnabledLoc, 1); // true
-    }
-    
-    if (lightPosLoc != -1) {
-        glm::vec3 lightPos(5.0f, 8.0f, 7.5f);
-        glUniform3fv(lightPosLoc, 1, &lightPos[0]);
-    }
-    
-    if (lightColorLoc != -1) {
-        glm::vec3 lightColor(1.5f, 1.5f, 1.5f);
-        glUniform3fv(lightColorLoc, 1, &lightColor[0]);
-    }
-    
-    if (viewPosLoc != -1) {
-        glUniform3fv(viewPosLoc, 1, &cameraPos[0]);
-    }
-    
-    glm::vec3 groundColor(0.2f, 0.8f, 0.2f);
+    glm::vec3 groundColor = getColor();
     
     for (int x = 0; x < width; ++x) {
         for (int z = 0; z < depth; ++z) {
-            blocks[x][z].render(shaderProgramID, groundColor);
+            blocks[x][z].render(out, groundColor);
         }
     }
 }
@@ -18,7 +18,8 @@ public:
     
     void initializeBlocks(float startX, float startY, float startZ, float blockSize);
     
-    void render() const;
+    glm::vec3 getColor() const { return glm::vec3(0.2f, 0.8f, 0.2f); }
+    void render(Render::DrawList& out) const;
 };
 
 
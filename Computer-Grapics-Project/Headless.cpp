@@ -0,0 +1,171 @@
+﻿#include "Headless.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#include <gl/freeglut.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::~HeadlessContext()
+{
+    destroy();
+}
+
+#ifdef _WIN32
+
+bool HeadlessContext::createContext(int w, int h)
+{
+    // 윈도우에는 surfaceless 컨텍스트가 없으니 작은 창을 만들어 숨기고 FBO에만 그린다
+    int argc = 1;
+    char name[] = "headless";
+    char* argv[] = { name, nullptr };
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_RGBA | GLUT_DEPTH);
+    glutInitWindowSize(64, 64);
+    glutCreateWindow("Minecraft Snowball Fight (headless)");
+    glutHideWindow();
+    width = w;
+    height = h;
+    return true;
+}
+
+#else
+
+bool HeadlessContext::createContext(int w, int h)
+{
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay) eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (eglDisplay == EGL_NO_DISPLAY) eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        std::cerr << "EGL 초기화 실패" << std::endl;
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "EGL에서 데스크톱 OpenGL을 쓸 수 없음" << std::endl;
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    const EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    eglChooseConfig(eglDisplay, configAttribs, &config, 1, &configCount);
+
+    // HUD가 고정 파이프라인(glWindowPos, glColor)을 쓰므로 호환 프로파일
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext eglContext = eglCreateContext(eglDisplay, configCount > 0 ? config : nullptr, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT || !eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+        std::cerr << "EGL 컨텍스트 생성 실패 (0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        if (eglContext != EGL_NO_CONTEXT) eglDestroyContext(eglDisplay, eglContext);
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    display = eglDisplay;
+    context = eglContext;
+    width = w;
+    height = h;
+    std::cout << "EGL " << major << "." << minor << " surfaceless 컨텍스트 생성" << std::endl;
+    return true;
+}
+
+#endif
+
+bool HeadlessContext::createFramebuffer()
+{
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "FBO 생성 실패 (0x" << std::hex << status << std::dec << ")" << std::endl;
+        return false;
+    }
+    glViewport(0, 0, width, height);
+    std::cout << "오프스크린 FBO " << width << "x" << height << " 생성" << std::endl;
+    return true;
+}
+
+void HeadlessContext::destroy()
+{
+    if (fbo) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+        fbo = colorBuffer = depthBuffer = 0;
+    }
+#ifndef _WIN32
+    if (context) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        context = display = nullptr;
+    }
+#endif
+}
+
+bool HeadlessContext::savePpm(const std::string& path) const
+{
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::cerr << "이미지 저장 실패: " << path << std::endl;
+        return false;
+    }
+    std::fprintf(f, "P6\n%d %d\n255\n", width, height);
+    for (int y = height - 1; y >= 0; --y) {
+        std::fwrite(&pixels[static_cast<size_t>(y) * width * 3], 1, static_cast<size_t>(width) * 3, f);
+    }
+    std::fclose(f);
+    return true;
+}
+
+void printFrameTimeReport(const std::string& scene, const std::vector<double>& frameSeconds, int warmupFrames)
+{
+    if (frameSeconds.empty()) return;
+
+    size_t warmup = std::min(frameSeconds.size() - 1, static_cast<size_t>(std::max(0, warmupFrames)));
+    double first = frameSeconds.front();
+    std::vector<double> samples(frameSeconds.begin() + warmup, frameSeconds.end());
+    double total = 0.0;
+    for (double s : samples) total += s;
+    std::sort(samples.begin(), samples.end());
+    double average = total / samples.size();
+    double p50 = samples[samples.size() / 2];
+    double p99 = samples[std::min(samples.size() - 1, static_cast<size_t>(samples.size() * 0.99))];
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-8s frames %4zu  first %8.2f ms  avg %7.3f  p50 %7.3f  p99 %7.3f  max %7.3f ms  (%.1f fps)",
+        scene.c_str(), samples.size(), first * 1e3, average * 1e3, p50 * 1e3, p99 * 1e3, samples.back() * 1e3,
+        average > 0.0 ? 1.0 / average : 0.0);
+    std::cout << line << std::endl;
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+#include <gl/glew.h>
+#include <string>
+#include <vector>
+
+// 창 없이 그리기 (--headless). GPU 없는 리눅스 CI에서도 llvmpipe로 렌더 벤치마크를 돌린다.
+// 리눅스는 surfaceless EGL 컨텍스트, 윈도우는 숨긴 GLUT 창으로 컨텍스트를 만들고
+// 어느 쪽이든 지정한 해상도의 FBO에 그린다.
+struct HeadlessConfig {
+    int width = 1280;
+    int height = 720;
+    int frames = 300;                 // 장면마다
+    int warmupFrames = 10;            // 통계에서 뺄 첫 프레임 수 (첫 사용 로드)
+    std::string scenes = "title,world,split,finish";
+    bool capture = false;             // 장면마다 마지막 프레임을 headless_<장면>.ppm으로 저장
+    std::string backend = "gl";       // "null"이면 GL 없이 그리기 명령만 기록 (CPU 렌더 준비 비용)
+};
+
+class HeadlessContext
+{
+public:
+    ~HeadlessContext();
+
+    // GL 컨텍스트를 만들어 현재로 설정 (glewInit 전)
+    bool createContext(int width, int height);
+    // 그릴 FBO를 만든다 (glewInit 뒤)
+    bool createFramebuffer();
+    // null 백엔드용: 컨텍스트 없이 그릴 크기만 정한다
+    void setSize(int w, int h) { width = w; height = h; }
+    void destroy();
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    GLuint getFramebuffer() const { return fbo; }
+
+    // 현재 FBO 내용을 PPM으로 저장 (위아래를 뒤집어 이미지 방향으로)
+    bool savePpm(const std::string& path) const;
+
+private:
+    int width = 0;
+    int height = 0;
+    GLuint fbo = 0;
+    GLuint colorBuffer = 0;
+    GLuint depthBuffer = 0;
+    void* display = nullptr;
+    void* context = nullptr;
+};
+
+// 장면별 프레임 시간 통계 출력. 첫 warmup개는 따로 보고하고 나머지로 평균/p50/p99/최대를 낸다.
+void printFrameTimeReport(const std::string& scene, const std::vector<double>& frameSeconds, int warmupFrames);
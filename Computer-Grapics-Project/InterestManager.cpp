@@ -0,0 +1,203 @@
+﻿#include "InterestManager.h"
+#include "NetGame.h"
+#include "Map.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 같은 거리라면 날아오는 눈덩이가 쌓인 눈보다 먼저 나간다
+const float SNOWBALL_WEIGHT = 2.0f;
+const float CELL_WEIGHT = 1.0f;
+
+glm::vec2 cellCenter(const std::pair<int, int>& key)
+{
+    return glm::vec2(key.first * BLOCK_SIZE, key.second * BLOCK_SIZE);
+}
+
+template <typename Key>
+void sortByPriority(std::vector<std::pair<float, Key>>& items, std::vector<Key>& out)
+{
+    std::sort(items.begin(), items.end(),
+        [](const std::pair<float, Key>& a, const std::pair<float, Key>& b) { return a.first > b.first; });
+    out.clear();
+    for (const auto& item : items) out.push_back(item.second);
+}
+
+} // namespace
+
+size_t InterestConfig::snapshotBudget() const
+{
+    double perSnapshot = bytesPerSecond * SNAPSHOT_INTERVAL_TICKS * TICK_DELTA_TIME - static_cast<double>(UDP_HEADER_BYTES);
+    return static_cast<size_t>(std::min(std::max(perSnapshot, 64.0), static_cast<double>(MAX_SNAPSHOT_BYTES)));
+}
+
+//--- 공간 격자
+
+std::pair<int, int> InterestGrid::bucketOf(float x, float z) const
+{
+    return std::make_pair(static_cast<int>(std::floor(x / cellSize)), static_cast<int>(std::floor(z / cellSize)));
+}
+
+void InterestGrid::build(const NetView& view, float size)
+{
+    cellSize = std::max(size, 0.5f);
+    buckets.clear();
+    for (const auto& s : view.snowballs) {
+        buckets[bucketOf(s.second.pos.x, s.second.pos.z)].snowballs.push_back(s.first);
+    }
+    for (const auto& c : view.snow) {
+        glm::vec2 p = cellCenter(c.first);
+        buckets[bucketOf(p.x, p.y)].cells.push_back(c.first);
+    }
+}
+
+void InterestGrid::query(const glm::vec3& center, float radius,
+    std::vector<uint16_t>& snowballs, std::vector<std::pair<int, int>>& cells) const
+{
+    snowballs.clear();
+    cells.clear();
+    std::pair<int, int> lo = bucketOf(center.x - radius, center.z - radius);
+    std::pair<int, int> hi = bucketOf(center.x + radius, center.z + radius);
+    for (int bx = lo.first; bx <= hi.first; ++bx) {
+        for (int bz = lo.second; bz <= hi.second; ++bz) {
+            auto it = buckets.find(std::make_pair(bx, bz));
+            if (it == buckets.end()) continue;
+            snowballs.insert(snowballs.end(), it->second.snowballs.begin(), it->second.snowballs.end());
+            cells.insert(cells.end(), it->second.cells.begin(), it->second.cells.end());
+        }
+    }
+}
+
+//--- 클라이언트별 관심 영역
+
+void InterestSet::select(const InterestGrid& grid, const InterestConfig& config, const glm::vec3& eye, const glm::vec3& aim,
+    const NetView& full, const NetView& base, NetView& target, NetViewOrder& order)
+{
+    target = full;
+    target.snowballs.clear();
+    target.snow = base.snow;     // 영역 밖 칸은 마지막으로 보낸 값 그대로
+
+    const glm::vec2 origin(eye.x, eye.z);
+    glm::vec2 facing(aim.x, aim.z);
+    const float facingLength = glm::length(facing);
+    if (facingLength > 0.0001f) facing /= facingLength;
+    const float cosHalf = std::cos(config.viewHalfAngle);
+
+    auto inView = [&](const glm::vec2& p, bool wasVisible) {
+        float margin = wasVisible ? config.leaveMargin : 0.0f;
+        glm::vec2 d = p - origin;
+        float dist = glm::length(d);
+        if (dist <= config.nearRadius + margin) return true;
+        if (dist > config.viewRadius + margin || facingLength <= 0.0001f) return false;
+        // 원뿔 경계도 여유 거리만큼 각도를 넓혀 준다
+        float slack = wasVisible ? margin / dist : 0.0f;
+        return glm::dot(d / dist, facing) >= cosHalf - slack;
+    };
+    auto proximity = [&](const glm::vec2& p) {
+        return 1.0f + std::max(0.0f, 1.0f - glm::length(p - origin) / std::max(config.viewRadius, 0.001f));
+    };
+
+    std::vector<uint16_t> nearbyBalls;
+    std::vector<std::pair<int, int>> nearbyCells;
+    grid.query(eye, config.viewRadius + config.leaveMargin, nearbyBalls, nearbyCells);
+
+    // 눈덩이: 영역 안의 것만 남기고, 클라이언트가 아직 모르는 것은 우선순위를 쌓는다
+    std::set<uint16_t> nowBalls;
+    std::vector<std::pair<float, uint16_t>> ballOrder;
+    for (uint16_t id : nearbyBalls) {
+        const NetSnowball& s = full.snowballs.find(id)->second;
+        glm::vec2 p(s.pos.x, s.pos.z);
+        bool was = visibleSnowballs.count(id) != 0;
+        if (!inView(p, was)) continue;
+
+        nowBalls.insert(id);
+        target.snowballs[id] = s;
+        if (!was) stats.enters++;
+        if (base.snowballs.find(id) == base.snowballs.end()) {
+            float& priority = snowballPriority[id];
+            priority += SNOWBALL_WEIGHT * proximity(p);
+            ballOrder.push_back(std::make_pair(priority, id));
+        }
+    }
+    for (uint16_t id : visibleSnowballs) {
+        if (nowBalls.count(id)) continue;
+        // 사라진 것이 아니라 영역을 벗어난 것만 센다
+        if (full.snowballs.find(id) != full.snowballs.end()) stats.leaves++;
+        snowballPriority.erase(id);
+    }
+    visibleSnowballs.swap(nowBalls);
+
+    // 눈 칸: 영역 안에서 바뀐 칸만 보낸다
+    std::set<std::pair<int, int>> nowCells;
+    std::vector<std::pair<float, std::pair<int, int>>> cellOrder;
+    auto visitCell = [&](const std::pair<int, int>& key) {
+        glm::vec2 p = cellCenter(key);
+        bool was = visibleCells.count(key) != 0;
+        if (!inView(p, was) || !nowCells.insert(key).second) return;
+        if (!was) stats.enters++;
+
+        auto f = full.snow.find(key);
+        auto b = base.snow.find(key);
+        int fullSteps = (f == full.snow.end()) ? 0 : f->second;
+        int baseSteps = (b == base.snow.end()) ? 0 : b->second;
+        if (fullSteps > 0) target.snow[key] = fullSteps;
+        else target.snow.erase(key);
+        if (fullSteps != baseSteps) {
+            float& priority = cellPriority[key];
+            priority += CELL_WEIGHT * proximity(p);
+            cellOrder.push_back(std::make_pair(priority, key));
+        }
+    };
+    for (const auto& key : nearbyCells) visitCell(key);
+    // 녹아서 없어진 칸은 격자에 없으니 클라이언트가 아는 칸에서 따로 찾는다
+    for (const auto& c : base.snow) {
+        if (full.snow.find(c.first) == full.snow.end()) visitCell(c.first);
+    }
+    for (const auto& key : visibleCells) {
+        if (nowCells.count(key)) continue;
+        stats.leaves++;
+        cellPriority.erase(key);
+    }
+    visibleCells.swap(nowCells);
+
+    sortByPriority(ballOrder, order.snowballs);
+    sortByPriority(cellOrder, order.cells);
+    stats.visibleSnowballs = visibleSnowballs.size();
+    stats.visibleCells = visibleCells.size();
+}
+
+void InterestSet::commit(const NetView& target, const NetView& sent)
+{
+    for (auto it = snowballPriority.begin(); it != snowballPriority.end();) {
+        bool pending = target.snowballs.count(it->first) && !sent.snowballs.count(it->first);
+        if (pending) {
+            stats.deferred++;
+            ++it;
+        }
+        else {
+            it = snowballPriority.erase(it);
+        }
+    }
+    for (auto it = cellPriority.begin(); it != cellPriority.end();) {
+        auto t = target.snow.find(it->first);
+        auto s = sent.snow.find(it->first);
+        int targetSteps = (t == target.snow.end()) ? 0 : t->second;
+        int sentSteps = (s == sent.snow.end()) ? 0 : s->second;
+        if (targetSteps != sentSteps) {
+            stats.deferred++;
+            ++it;
+        }
+        else {
+            it = cellPriority.erase(it);
+        }
+    }
+}
+
+void InterestSet::reset()
+{
+    visibleSnowballs.clear();
+    visibleCells.clear();
+    snowballPriority.clear();
+    cellPriority.clear();
+}
@@ -0,0 +1,80 @@
+﻿#pragma once
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include <gl/glm/glm.hpp>
+
+struct NetView;
+struct NetViewOrder;
+
+// 관심 영역(AOI) 설정. 캐릭터 주변 nearRadius는 방향과 관계없이,
+// 그 밖은 조준 방향 시야 원뿔 안에서 viewRadius까지만 복제한다.
+struct InterestConfig {
+    bool enabled = false;
+    float nearRadius = 4.0f;
+    float viewRadius = 12.0f;
+    float viewHalfAngle = 1.1f;          // 라디안 (약 63도)
+    float leaveMargin = 1.0f;            // 이미 보이는 것은 이만큼 더 멀어져야 빠진다 (경계 떨림 방지)
+    int bytesPerSecond = 12 * 1024;      // 클라이언트당 스냅샷 대역폭 예산
+    float cellSize = 4.0f;               // 공간 격자 한 칸 크기
+
+    // 스냅샷 한 번에 쓸 수 있는 바이트 (IP/UDP 헤더 제외)
+    size_t snapshotBudget() const;
+};
+
+struct InterestStats {
+    uint64_t enters = 0;
+    uint64_t leaves = 0;
+    uint64_t deferred = 0;           // 예산이 모자라 다음 스냅샷으로 밀린 항목
+    size_t visibleSnowballs = 0;
+    size_t visibleCells = 0;
+};
+
+// 스냅샷마다 한 번 만들어 모든 클라이언트가 같이 쓰는 공간 격자
+class InterestGrid
+{
+public:
+    void build(const NetView& view, float cellSize);
+
+    // 중심에서 radius 안에 걸치는 격자 칸의 항목들을 모은다 (정확한 거리 검사는 호출자 몫)
+    void query(const glm::vec3& center, float radius,
+        std::vector<uint16_t>& snowballs, std::vector<std::pair<int, int>>& cells) const;
+
+private:
+    struct Bucket {
+        std::vector<uint16_t> snowballs;
+        std::vector<std::pair<int, int>> cells;
+    };
+
+    std::pair<int, int> bucketOf(float x, float z) const;
+
+    float cellSize = 4.0f;
+    std::map<std::pair<int, int>, Bucket> buckets;
+};
+
+// 클라이언트 하나의 관심 영역 상태: 지금 보이는 것과 아직 못 보낸 항목의 누적 우선순위
+class InterestSet
+{
+public:
+    // full 중 관심 영역 안의 것만 반영한 target과 전송 순서를 만든다.
+    // 눈덩이는 영역을 벗어나면 제거되고, 눈 칸은 벗어나면 마지막으로 보낸 값에 고정된다.
+    void select(const InterestGrid& grid, const InterestConfig& config, const glm::vec3& eye, const glm::vec3& aim,
+        const NetView& full, const NetView& base, NetView& target, NetViewOrder& order);
+
+    // 실제로 보낸 항목은 우선순위를 비우고, 못 보낸 항목은 다음에도 계속 쌓이게 둔다
+    void commit(const NetView& target, const NetView& sent);
+
+    // 새 경기: 보이던 목록과 우선순위를 모두 비운다
+    void reset();
+
+    const InterestStats& getStats() const { return stats; }
+
+private:
+    std::set<uint16_t> visibleSnowballs;
+    std::set<std::pair<int, int>> visibleCells;
+    std::map<uint16_t, float> snowballPriority;
+    std::map<std::pair<int, int>, float> cellPriority;
+    InterestStats stats;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <gl/glew.h>
+#include "GlIntercept.h"
 #include <gl/glm/glm.hpp>
 #include <vector>
 
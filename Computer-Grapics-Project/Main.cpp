@@ -5,6 +5,7 @@
 #include <gl/glew.h>
 #include <gl/freeglut.h>
 #include <gl/freeglut_ext.h>
+#include "GlIntercept.h"
 #include <gl/glm/glm.hpp>
 #include <gl/glm/ext.hpp>
 #include <gl/glm/gtc/matrix_transform.hpp>
@@ -20,35 +21,49 @@
 #include "Steve.h"
 #include "Alex.h"
 #include "Camera.h"
-#include "Steve_Camera.h"
-#include "Alex_Camera.h"
+#include "FirstPersonCamera.h"
+#include "ViewportLayout.h"
 #include "Snowball.h"
 #include "Snow.h"
 #include "KeyManager.h"
 #include "title.h"
 #include "finish.h"
+#include "GameWorld.h"
+#include "NetGame.h"
+#include "Rollback.h"
+#include "MatchHost.h"
+#include "SpectatorRelay.h"
+#include "Profiler.h"
+#include "PerfHud.h"
+#include "FlightRecorder.h"
+#include "GpuTimer.h"
+#include "Headless.h"
+#include "RenderQueue.h"
+#include "GlState.h"
+#include "ShaderLibrary.h"
+#include "TextureLoader.h"
+#include "TextureArray.h"
+#include "BlockCompression.h"
+#include "AssetPack.h"
+#include "SimLog.h"
 
 #define WinX 1280
 #define WinY 720
 
-char* filetobuf(const char* file)
-{
-	FILE* fptr;
-	long length;
-	char* buf;
-
-	fptr = fopen(file, "rb");
-	if (!fptr)
-		return NULL;
-	fseek(fptr, 0, SEEK_END);
-	length = ftell(fptr);
-	buf = (char*)malloc(length + 1);
-	fseek(fptr, 0, SEEK_SET);
-	fread(buf, length, 1, fptr);
-	fclose(fptr);
-	buf[length] = 0;
-	return buf;
-}
+static const char* const GL_DUMP_PATH = "glframe.txt";
+static const char* const SHADER_CACHE_PATH = "shader_cache.bin";
+// 있으면 셰이더와 텍스처 원본을 여기서 읽는다 (--asset-pack으로 바꾸고 --no-asset-pack으로 끔)
+static const char* const ASSET_PACK_PATH = "assets.pak";
+// 실행하면서 만든 GPU용 캐시(.gtex, 셰이더 바이너리)를 다음 시작 때 여기로 모아 한 번에 매핑한다
+static const char* const CACHE_PACK_PATH = "gpu_cache.pak";
+// --pack-assets가 묶는 파일. 맵 파일 같은 새 에셋은 여기에 더한다.
+static const char* const PACKED_ASSETS[] = {
+	"vertex.glsl", "fragment.glsl",
+	"Title.png", "Steve_win.png", "Alex_win.png",
+	"steve.png", "alex.png", "steve_face.png", "alex_face.png",
+	"oak_planks.png", "snow.png",
+};
+static const int GL_DUMP_WARMUP_FRAMES = 120;       // --gl-dump: 첫 사용 로드가 끝난 뒤 프레임을 남긴다
 
 glm::vec3 cameraPos = glm::vec3(5.0f, 8.0f, 12.0f);
 glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
@@ -57,18 +72,34 @@ glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
 static GameState currentGameState = GameState::TITLE_SCREEN;
 static TitleScreen titleScreen;
 static FinishScreen finishScreen;
-static Winner winner = Winner::NONE;
 
 static Camera camera;
-static Steve_Camera steveCamera;
-static Alex_Camera alexCamera;
+
+// 로컬 분할 화면 칸마다 1인칭 카메라 하나 (앞의 둘이 Steve, Alex 조작 시점).
+// 캐릭터는 둘뿐이라 3, 4번째 칸은 같은 캐릭터에 붙어 반대쪽을 본다.
+static FirstPersonCamera localCameras[ViewportLayout::MAX_VIEWS] = {
+	FirstPersonCamera(0, 90.0f), FirstPersonCamera(1, -90.0f), FirstPersonCamera(0, -90.0f), FirstPersonCamera(1, 90.0f)
+};
+static int localViewCount = 2;   // --split-views
+static ViewportLayout splitLayout;
 static LightManager lightManager;
-static Map gameMap;
-static Steve::Character* steve = nullptr;
-static Alex::Character* alex = nullptr;
-static Snow snowSystem("snow.png");
+static GameWorld world;
 static KeyManager input;
 
+// 네트워크 클라이언트 모드 (--connect)
+static GameClient* netClient = nullptr;
+static NetConditions netConditions;
+
+// P2P 롤백 모드 (--p2p)
+static RollbackSession* rollbackSession = nullptr;
+
+// 관전 모드 (릴레이에서 받은 경기를 자유 카메라로 본다)
+static SpectatorClient* spectator = nullptr;
+
+// 헤드리스 렌더 벤치마크 (--headless): 창 대신 이 컨텍스트의 FBO에 그린다
+static HeadlessContext* headless = nullptr;
+
+// 한 틱 안에 눌렀다 뗀 던지기 키도 놓치지 않도록 다음 틱까지 눌림으로 유지
 static bool steveThrowFlag = false;
 static bool alexThrowFlag = false;
 
@@ -76,6 +107,14 @@ static glm::vec3 stevePosition = glm::vec3(3.0f, 0.8f, 5.0f);
 static glm::vec3 alexPosition = glm::vec3(7.0f, 0.8f, 5.0f);
 
 static bool splitScreenMode = false;
+// 분할 화면을 한 번 제출로 그린다 (--no-multiview면 시점마다 따로 넘긴다)
+static bool multiViewEnabled = true;
+// 링크한 셰이더 프로그램을 SHADER_CACHE_PATH에 두고 다음 실행에서 다시 쓴다 (--no-shader-cache로 끔)
+static bool shaderCacheEnabled = true;
+// 텍스처를 BC1/BC3으로 올릴지 (--texture-compression on|off|auto). auto는 소프트웨어 래스터라이저에서 끈다:
+// 줄일 VRAM이 없고, 샘플마다 블록을 CPU로 풀어서 프레임이 두 배 가까이 느려진다 (llvmpipe).
+// 드라이버가 S3TC를 모르면 어느 쪽이든 RGBA8이다.
+static std::string textureCompressionMode = "auto";
 
 bool cameraLightMode = true;
 enum CharacterSelection { STEVE, ALEX };
@@ -85,26 +124,31 @@ bool firstMouse = true;
 float lastX = WinX / 2.0f;
 float lastY = WinY / 2.0f;
 
-static std::vector<Snowball> snowballs;
-
-static bool steveCharging = false;
-static float steveChargeStartTime = 0.0f;
-
-static bool alexCharging = false;
-static float alexChargeStartTime = 0.0f;
-
-static float steveLastChargeTime = 0.0f;
-static float alexLastChargeTime = 0.0f;
-
-
-static float maxChargeTime = 1.0f;
-static float minSpeed = 2.0f;
-static float maxSpeed = 15.0f;
-
-static GLuint faceVAO = 0, faceVBO = 0;
+static Render::Mesh faceMesh;
+
+// 월드 그리기 큐와 생산자별 목록 (프레임마다 다시 채우고 용량은 돌려 쓴다)
+static Render::RenderQueue worldQueue;
+static Render::DrawList mapList, snowList, characterList, snowballList;
+
+// 캐릭터/눈덩이 컬링 (AABB를 모아 한 번에 검사)
+static AabbList entityBounds;
+static std::vector<uint8_t> entityVisible;
+// 한 번에 그릴 시점 하나 (분할 화면이면 renderWorld에 여러 개를 같이 넘긴다)
+struct WorldView {
+	glm::mat4 view;
+	glm::mat4 projection;
+	Frustum frustum;
+	int x, y, width, height;
+};
+
+struct WorldCullStats {
+	size_t blocks = 0, blocksTotal = 0;
+	size_t entities = 0, entitiesTotal = 0;
+};
+static WorldCullStats lastCull;
 static bool faceBuffersInitialized = false;
-static GLuint steveFaceTextureID = 0;
-static GLuint alexFaceTextureID = 0;
+static Render::Texture steveFaceTexture;
+static Render::Texture alexFaceTexture;
 static bool faceTexturesLoaded = false;
 
 void Mouse(int button, int state, int x, int y);
@@ -115,38 +159,176 @@ void SpecialKeyboard(int key, int x, int y);
 void SpecialKeyboardUp(int key, int x, int y);
 void TimerFunction(int value);
 
-void make_shaderProgram();
+bool make_shaderProgram();
 GLvoid drawScene();
 GLvoid drawSplitScreen();
-GLvoid renderWorld(const glm::mat4& view, const glm::mat4& projection);
+GLvoid renderWorld(const WorldView* views, int viewCount);
+void presentFrame();
 GLvoid Reshape(int w, int h);
+int windowWidth();
+int windowHeight();
+bool initializeRenderer();
+int runHeadlessBenchmark(const HeadlessConfig& config);
+int packAssets(const std::string& path);
 
 void initializeGame();
-
-void fireSteveSnowball();
-void fireAlexSnowball();
-
-bool checkSnowballCharacterCollision(const Snowball& snowball, const glm::vec3& characterPos, const glm::vec3& boundingBoxSize);
-void checkAllSnowballCollisions();
+GameWorld& activeWorld();
+bool isNetworkGame();
+bool isSpectating();
+int networkPlayerIndex();
+void setGameState(GameState state);
 
 void initializeFaceBuffers();
 void loadFaceTextures();
-GLuint loadTexture(const char* path);
+Render::Texture loadTexture(const char* path);
 void renderCharacterFace(GLuint textureID, float x, float y, float size, int screenWidth, int screenHeight);
 void drawCharacterFaces(int winW, int winH);
 
 //--- 셰이더 관련 변수들
 GLint width, height;
-GLuint shaderProgramID;
-GLuint vertexShader;
-GLuint fragmentShader;
-GLchar* vertexSource, * fragmentSource;
+ShaderLibrary shaderLibrary;
 
 //--- 메인 함수 (반환 타입을 int로 변경)
 int main(int argc, char** argv)
 {
 	std::cout << "프로그램 시작" << std::endl;
 
+	//--- 네트워크 관련 인자
+	bool runServer = false;
+	MatchHostConfig hostConfig;
+	std::string connectAddress;
+	float selfTestSeconds = 0.0f;
+	float rollbackTestSeconds = 0.0f;
+	uint16_t p2pPort = 0;
+	std::string p2pPeer;
+	int p2pPlayer = 0;
+	int inputDelay = DEFAULT_INPUT_DELAY;
+	std::string relayUpstream;
+	uint16_t relayPort = DEFAULT_RELAY_PORT;
+	double spectatorDelay = DEFAULT_SPECTATOR_DELAY;
+	std::string spectateAddress;
+	int loadTestViewers = 0;
+	double traceSeconds = 0.0;
+	std::string tracePath = Profiler::DEFAULT_TRACE_PATH;
+	FlightRecorder::Config flightConfig;
+	bool glStats = false;
+	bool runHeadless = false;
+	HeadlessConfig headlessConfig;
+	std::string assetPackPath = ASSET_PACK_PATH;
+	std::string packOutput;
+	bool verifyAssets = false;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = (i + 1 < argc) && argv[i + 1][0] != '-';
+		if (arg == "--server") {
+			runServer = true;
+			if (hasValue) hostConfig.basePort = static_cast<uint16_t>(atoi(argv[++i]));
+		}
+		else if (arg == "--matches" && hasValue) hostConfig.matchCount = std::max(1, atoi(argv[++i]));
+		else if (arg == "--workers" && hasValue) hostConfig.workerCount = atoi(argv[++i]);
+		else if (arg == "--bots") hostConfig.bots = true;
+		else if (arg == "--duration" && hasValue) hostConfig.seconds = static_cast<float>(atof(argv[++i]));
+		else if (arg == "--timing-csv" && hasValue) hostConfig.timingCsvPath = argv[++i];
+		else if (arg == "--connect" && hasValue) connectAddress = argv[++i];
+		else if (arg == "--latency" && hasValue) netConditions.latencyMs = atoi(argv[++i]);
+		else if (arg == "--jitter" && hasValue) netConditions.jitterMs = atoi(argv[++i]);
+		else if (arg == "--loss" && hasValue) netConditions.lossPercent = static_cast<float>(atof(argv[++i]));
+		else if (arg == "--net-selftest") selfTestSeconds = hasValue ? static_cast<float>(atof(argv[++i])) : 10.0f;
+		else if (arg == "--p2p" && i + 2 < argc) {
+			p2pPort = static_cast<uint16_t>(atoi(argv[++i]));
+			p2pPeer = argv[++i];
+		}
+		else if (arg == "--p2p-player" && hasValue) p2pPlayer = atoi(argv[++i]) == 1 ? 1 : 0;
+		else if (arg == "--input-delay" && hasValue) inputDelay = atoi(argv[++i]);
+		else if (arg == "--rollback-selftest") rollbackTestSeconds = hasValue ? static_cast<float>(atof(argv[++i])) : 10.0f;
+		else if (arg == "--aoi") hostConfig.interest.enabled = true;
+		else if (arg == "--aoi-radius" && hasValue) {
+			hostConfig.interest.enabled = true;
+			hostConfig.interest.viewRadius = static_cast<float>(atof(argv[++i]));
+			hostConfig.interest.nearRadius = std::min(hostConfig.interest.nearRadius, hostConfig.interest.viewRadius);
+		}
+		else if (arg == "--aoi-budget" && hasValue) {
+			hostConfig.interest.enabled = true;
+			hostConfig.interest.bytesPerSecond = std::max(1024, atoi(argv[++i]));
+		}
+		else if (arg == "--relay" && hasValue) relayUpstream = argv[++i];
+		else if (arg == "--relay-port" && hasValue) relayPort = static_cast<uint16_t>(atoi(argv[++i]));
+		else if (arg == "--spectator-delay" && hasValue) spectatorDelay = atof(argv[++i]);
+		else if (arg == "--spectate" && hasValue) spectateAddress = argv[++i];
+		else if (arg == "--relay-loadtest") loadTestViewers = hasValue ? std::max(1, atoi(argv[++i])) : DEFAULT_LOADTEST_VIEWERS;
+		else if (arg == "--trace") traceSeconds = hasValue ? atof(argv[++i]) : Profiler::DEFAULT_TRACE_SECONDS;
+		else if (arg == "--trace-file" && hasValue) tracePath = argv[++i];
+		else if (arg == "--hitch-budget" && hasValue) flightConfig.hitchBudget = atof(argv[++i]) / 1000.0;
+		else if (arg == "--gl-stats") glStats = true;
+		else if (arg == "--no-multiview") multiViewEnabled = false;
+		else if (arg == "--no-shader-cache") shaderCacheEnabled = false;
+		else if (arg == "--no-texture-cache") Render::textureLoader().setCacheEnabled(false);
+		else if (arg == "--texture-compression" && hasValue) textureCompressionMode = argv[++i];
+		else if (arg == "--split-views" && hasValue) localViewCount = std::max(1, std::min(atoi(argv[++i]), ViewportLayout::MAX_VIEWS));
+		else if (arg == "--gl-dump" && hasValue) GlIntercept::requestDump(argv[++i], GL_DUMP_WARMUP_FRAMES);
+		else if (arg == "--headless") {
+			runHeadless = true;
+			if (hasValue) headlessConfig.frames = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--headless-size" && hasValue) {
+			int w = 0, h = 0;
+			if (sscanf(argv[++i], "%dx%d", &w, &h) == 2 && w > 0 && h > 0) {
+				headlessConfig.width = w;
+				headlessConfig.height = h;
+			}
+		}
+		else if (arg == "--headless-scenes" && hasValue) headlessConfig.scenes = argv[++i];
+		else if (arg == "--headless-capture") headlessConfig.capture = true;
+		else if (arg == "--headless-backend" && hasValue) headlessConfig.backend = argv[++i];
+		else if (arg == "--pack-assets") packOutput = hasValue ? argv[++i] : ASSET_PACK_PATH;
+		else if (arg == "--asset-pack" && hasValue) assetPackPath = argv[++i];
+		else if (arg == "--no-asset-pack") assetPackPath.clear();
+		else if (arg == "--verify-assets") verifyAssets = true;
+	}
+	if (glStats) GlIntercept::setEnabled(true);
+	FlightRecorder::configure(flightConfig);
+
+	// 어느 모드로 끝나든(exit 포함) 진행 중인 트레이스는 파일로 남긴다
+	Profiler::setThreadName("main");
+	std::atexit(Profiler::finishCapture);
+	if (traceSeconds > 0.0) Profiler::startCapture(traceSeconds, tracePath);
+
+	if (!packOutput.empty()) return packAssets(packOutput);
+	if (runServer) {
+		hostConfig.conditions = netConditions;
+		return runMatchHost(hostConfig);
+	}
+	if (selfTestSeconds > 0.0f) return runNetSelfTest(selfTestSeconds, netConditions, hostConfig.interest);
+	if (rollbackTestSeconds > 0.0f) return runRollbackSelfTest(rollbackTestSeconds, netConditions, inputDelay);
+	if (loadTestViewers > 0) {
+		return runRelayLoadTest(loadTestViewers, hostConfig.seconds > 0.0f ? hostConfig.seconds : 10.0f, spectatorDelay);
+	}
+	if (!relayUpstream.empty()) {
+		NetAddress serverAddress;
+		if (!Net::initialize() || !NetAddress::parse(relayUpstream, DEFAULT_SERVER_PORT, serverAddress)) {
+			std::cerr << "서버 주소 해석 실패: " << relayUpstream << std::endl;
+			return 1;
+		}
+		return runSpectatorRelay(serverAddress, relayPort, spectatorDelay, hostConfig.seconds);
+	}
+
+	// 셰이더와 텍스처를 읽기 전에. 없으면 작업 폴더의 파일을 하나씩 읽는다.
+	if (!assetPackPath.empty() && assetPack().open(assetPackPath)) {
+		std::cout << "에셋 팩: " << assetPackPath << " (" << assetPack().getEntryCount() << "개, "
+			<< assetPack().getSize() / 1024 << "KB)" << std::endl;
+		if (verifyAssets) {
+			int bad = assetPack().verify();
+			std::cout << "에셋 팩 내용 검사: " << (bad == 0 ? "이상 없음" : std::to_string(bad) + "개 불일치") << std::endl;
+			if (bad != 0) assetPack().close();
+		}
+	}
+	if (openCachePack(CACHE_PACK_PATH)) {
+		std::cout << "캐시 팩: " << CACHE_PACK_PATH << " (" << cachePack().getEntryCount() << "개, "
+			<< cachePack().getSize() / 1024 << "KB)" << std::endl;
+	}
+
+	if (runHeadless) return runHeadlessBenchmark(headlessConfig);
+
 	//--- 윈도우생성하기
 	glutInit(&argc, argv);
 	glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
@@ -156,36 +338,61 @@ int main(int argc, char** argv)
 
 	std::cout << "GLUT 초기화 완료" << std::endl;
 
-	//--- GLEW 초기화하기
-	glewExperimental = GL_TRUE;
-	GLenum glewStatus = glewInit();
-	if (glewStatus != GLEW_OK) {
-		std::cerr << "GLEW 초기화 실패: " << glewGetErrorString(glewStatus) << std::endl;
-		return 1;
-	}
-
-	// OpenGL 버전 확인
-	std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
-	std::cout << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
-
-	//--- 세이더읽어와서세이더프로그램만들기
-	make_shaderProgram();
-
-	// 셰이더 프로그램이 제대로 생성되었는지 확인
-	if (shaderProgramID == 0) {
-		std::cerr << "셰이더 프로그램 생성 실패" << std::endl;
+	if (!initializeRenderer()) {
 		return 1;
 	}
 
-	std::cout << "셰이더 프로그램 생성 완료" << std::endl;
-
 	// 타이틀 화면 초기화
 	titleScreen.initialize();
 
-	std::cout << "\n=== MINECRAFT SNOWBALL FIGHT ===" << std::endl;
-	std::cout << "1: 1인칭 모드로 게임 시작" << std::endl;
-	std::cout << "3: 3인칭 모드로 게임 시작" << std::endl;
-	std::cout << "ESC: 종료" << std::endl;
+	if (!connectAddress.empty()) {
+		NetAddress serverAddress;
+		if (!Net::initialize() || !NetAddress::parse(connectAddress, DEFAULT_SERVER_PORT, serverAddress)) {
+			std::cerr << "서버 주소 해석 실패: " << connectAddress << std::endl;
+			return 1;
+		}
+		netClient = new GameClient();
+		if (!netClient->connect(serverAddress, netConditions)) {
+			return 1;
+		}
+		// 네트워크 모드는 타이틀 없이 바로 1인칭으로 시작
+		setGameState(GameState::FIRST_PERSON_MODE);
+		initializeGame();
+	}
+	else if (!p2pPeer.empty()) {
+		NetAddress peerAddress;
+		if (!Net::initialize() || !NetAddress::parse(p2pPeer, DEFAULT_SERVER_PORT, peerAddress)) {
+			std::cerr << "상대 주소 해석 실패: " << p2pPeer << std::endl;
+			return 1;
+		}
+		rollbackSession = new RollbackSession();
+		if (!rollbackSession->start(p2pPlayer, p2pPort, netConditions, inputDelay)) {
+			return 1;
+		}
+		rollbackSession->setPeer(peerAddress);
+		setGameState(GameState::FIRST_PERSON_MODE);
+		initializeGame();
+	}
+	else if (!spectateAddress.empty()) {
+		NetAddress relayAddress;
+		if (!Net::initialize() || !NetAddress::parse(spectateAddress, DEFAULT_RELAY_PORT, relayAddress)) {
+			std::cerr << "릴레이 주소 해석 실패: " << spectateAddress << std::endl;
+			return 1;
+		}
+		spectator = new SpectatorClient();
+		if (!spectator->connect(relayAddress)) {
+			return 1;
+		}
+		// 관전은 자유 카메라(3인칭)로 시작
+		setGameState(GameState::THIRD_PERSON_MODE);
+		initializeGame();
+	}
+	else {
+		std::cout << "\n=== MINECRAFT SNOWBALL FIGHT ===" << std::endl;
+		std::cout << "1: 1인칭 모드로 게임 시작" << std::endl;
+		std::cout << "3: 3인칭 모드로 게임 시작" << std::endl;
+		std::cout << "ESC: 종료" << std::endl;
+	}
 
 	//--- 콜백 등록
 	glutDisplayFunc(drawScene);
@@ -202,56 +409,224 @@ int main(int argc, char** argv)
 	return 0;
 }
 
-GLuint loadTexture(const char* path)
+// GL 컨텍스트가 현재로 잡힌 뒤 (창이든 헤드리스든) 한 번
+bool initializeRenderer()
+{
+	//--- GLEW 초기화하기
+	glewExperimental = GL_TRUE;
+	GLenum glewStatus = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	// X 서버 없이 EGL로 만든 컨텍스트: GLX 확장만 못 읽었을 뿐 GL 함수는 다 잡혔다
+	if (headless && glewStatus == GLEW_ERROR_NO_GLX_DISPLAY) glewStatus = GLEW_OK;
+#endif
+	if (glewStatus != GLEW_OK) {
+		std::cerr << "GLEW 초기화 실패: " << glewGetErrorString(glewStatus) << std::endl;
+		return false;
+	}
+
+	// OpenGL 버전 확인
+	std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
+	std::cout << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
+
+	//--- 세이더읽어와서세이더프로그램만들기
+	// 셰이더 프로그램이 제대로 생성되었는지 확인
+	if (!make_shaderProgram()) {
+		std::cerr << "셰이더 프로그램 생성 실패" << std::endl;
+		return false;
+	}
+
+	std::cout << "셰이더 프로그램 생성 완료" << std::endl;
+	GpuTimer::initialize();
+
+	// 텍스처를 하나라도 요청하기 전에 정한다
+	std::string renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+	bool software = renderer.find("llvmpipe") != std::string::npos || renderer.find("softpipe") != std::string::npos ||
+		renderer.find("SwiftShader") != std::string::npos || renderer.find("GDI Generic") != std::string::npos;
+	bool compress = textureCompressionMode == "on" || (textureCompressionMode == "auto" && !software);
+	BlockCompression::setEnabled(compress && Render::backend().supportsBlockCompression());
+	std::cout << "텍스처 압축: " << (BlockCompression::isEnabled() ? "BC1/BC3" : "끔 (RGBA8)")
+		<< (compress && !BlockCompression::isEnabled() ? ", 드라이버가 S3TC를 지원하지 않음" : "") << std::endl;
+	return true;
+}
+
+// 정해진 장면/카메라 경로를 장면마다 frames장씩 그리고 프레임 시간 통계를 낸다.
+// 시뮬레이션은 봇 입력으로 진행하지만 시간은 drawScene만 잰다 (헤드리스는 glFinish까지 포함).
+int runHeadlessBenchmark(const HeadlessConfig& config)
 {
-	GLuint textureID;
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-
-	// 텍스처 파라미터 설정
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	int width, height, channels;
-	stbi_set_flip_vertically_on_load(true);
-	unsigned char* data = stbi_load(path, &width, &height, &channels, 0);
-
-	if (data) {
-		GLenum format;
-		if (channels == 1)
-			format = GL_RED;
-		else if (channels == 3)
-			format = GL_RGB;
-		else if (channels == 4)
-			format = GL_RGBA;
-		else
-			format = GL_RGB;
-
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		std::cout << "텍스처 로드 성공: " << path << " (" << width << "x" << height << ", " << channels << " channels)" << std::endl;
+	HeadlessContext context;
+	const bool nullRender = (config.backend == "null");
+	// 전역 객체(world, 화면들)가 가진 가짜 이름은 종료 때 소멸자가 이 백엔드로 지운다.
+	// 그래서 해제하지 않고 프로세스가 끝날 때까지 현재 백엔드로 둔다 (GL로 돌리면 컨텍스트도
+	// glewInit도 없이 glDelete*를 부르게 된다).
+	Render::NullBackend* nullBackend = nullRender ? new Render::NullBackend() : nullptr;
+	if (nullRender) {
+		// GL 컨텍스트 없이 그리기 명령만 기록: CPU 쪽 렌더 준비 비용만 잰다
+		context.setSize(config.width, config.height);
+		nullBackend->setMultiView(multiViewEnabled);
+		Render::setBackend(nullBackend);
+		BlockCompression::setEnabled(textureCompressionMode != "off");
+		headless = &context;
+		std::cout << "렌더러: null (그리기 명령 기록만)" << std::endl;
 	}
 	else {
-		std::cerr << "텍스처 로드 실패: " << path << std::endl;
-		unsigned char whitePixel[3] = { 255, 255, 255 };
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, whitePixel);
+		if (config.backend != "gl") std::cerr << "알 수 없는 백엔드: " << config.backend << " (gl, null), gl 사용" << std::endl;
+		if (!context.createContext(config.width, config.height)) return 1;
+		headless = &context;
+		if (!initializeRenderer() || !context.createFramebuffer()) {
+			headless = nullptr;
+			return 1;
+		}
+		std::cout << "렌더러: " << glGetString(GL_RENDERER) << std::endl;
 	}
 
-	stbi_image_free(data);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	titleScreen.initialize();
+
+	// 경기장 가운데를 도는 자유 카메라 경로
+	const glm::vec3 arenaCenter(MAP_WIDTH * BLOCK_SIZE * 0.5f, 0.0f, MAP_DEPTH * BLOCK_SIZE * 0.5f);
+	const float orbitRadius = 14.0f;
+	const float orbitHeight = 9.0f;
+
+	InputBot bots[PLAYER_COUNT] = { InputBot(0, 1), InputBot(1, 2) };
+	bool gameReady = false;
+	int result = 0;
+
+	std::cout << "\n=== 헤드리스 렌더 벤치마크: " << config.width << "x" << config.height << ", 장면당 "
+		<< config.frames << "프레임 ===" << std::endl;
+
+	std::stringstream sceneList(config.scenes);
+	std::string scene;
+	while (std::getline(sceneList, scene, ',')) {
+		bool simulate = false;
+		if (scene == "title") {
+			setGameState(GameState::TITLE_SCREEN);
+		}
+		else if (scene == "world" || scene.compare(0, 5, "split") == 0 || scene == "finish") {
+			// splitN: 분할 화면 N칸 (그냥 split이면 --split-views)
+			bool split = scene.compare(0, 5, "split") == 0;
+			if (split && scene.size() > 5) localViewCount = std::max(1, std::min(atoi(scene.c_str() + 5), ViewportLayout::MAX_VIEWS));
+			GameState state = split ? GameState::FIRST_PERSON_MODE : GameState::THIRD_PERSON_MODE;
+			setGameState(state);
+			if (!gameReady) {
+				initializeGame();
+				gameReady = true;
+			}
+			splitScreenMode = split;
+			if (scene == "finish") {
+				finishScreen.setWinner(Winner::STEVE);
+				setGameState(GameState::FINISH_SCREEN);
+			}
+			else simulate = true;
+		}
+		else {
+			std::cerr << "알 수 없는 장면: " << scene << " (title, world, split, split1~4, finish)" << std::endl;
+			result = 1;
+			continue;
+		}
+
+		// 캡처와 측정 프레임에 자리표시가 섞이지 않게 이 장면이 요청한 텍스처를 먼저 다 올린다
+		Render::textureLoader().finish();
+
+		std::vector<double> frameSeconds;
+		frameSeconds.reserve(config.frames);
+		for (int frame = 0; frame < config.frames; ++frame) {
+			if (simulate) {
+				SimLog::Mute mute;
+				PlayerInput inputs[PLAYER_COUNT] = { bots[0].next(), bots[1].next() };
+				world.tick(inputs);
+			}
+			if (scene == "world") {
+				float angle = glm::radians(360.0f) * frame / config.frames;
+				glm::vec3 eye = arenaCenter + glm::vec3(orbitRadius * std::cos(angle), orbitHeight, orbitRadius * std::sin(angle));
+				glm::vec3 dir = glm::normalize(arenaCenter - eye);
+				camera.setPosition(eye);
+				camera.setAngles(glm::degrees(std::atan2(dir.z, dir.x)), glm::degrees(std::asin(dir.y)));
+				cameraPos = camera.position;
+				cameraFront = camera.front;
+			}
+
+			double start = Profiler::now();
+			drawScene();
+			frameSeconds.push_back(Profiler::now() - start);
+		}
+
+		printFrameTimeReport(scene, frameSeconds, config.warmupFrames);
+		if (simulate) {
+			const Render::RenderQueue::Stats& q = worldQueue.getLastStats();
+			std::cout << "  [컬링] 블록 " << lastCull.blocks << "/" << lastCull.blocksTotal << ", 캐릭터/눈덩이 "
+				<< lastCull.entities << "/" << lastCull.entitiesTotal << std::endl;
+			if (splitScreenMode && splitLayout.getViewCount() > 1) {
+				std::cout << "  [분할 화면] " << splitLayout.getViewCount() << "칸, "
+					<< (Render::backend().supportsMultiView() ? "한 번 제출 (시점별 인스턴스)" : "시점마다 다시 제출")
+					<< ", 패스 " << q.passes << std::endl;
+			}
+			std::cout << "  [큐] 그리기 " << q.draws << ", 텍스처 전환 " << q.textureChanges << ", 메시 전환 "
+				<< q.meshChanges << ", 블렌드 전환 " << q.blendChanges
+				<< ", 셰이더 변형 전환 " << q.variantChanges << std::endl;
+		}
+		if (!nullRender) {
+			const GlState::Counters& state = GlState::lastFrame();
+			std::cout << "  [GL 상태] 보냄 " << state.totalIssued() << ", 생략 " << state.totalElided() << " (";
+			for (int k = 0; k < GlState::KIND_COUNT; ++k) {
+				std::cout << (k ? ", " : "") << GlState::kindName(k) << " " << state.issued[k] << "/" << state.elided[k];
+			}
+			std::cout << ")" << std::endl;
+		}
+		if (nullRender) {
+			const Render::NullBackend::FrameRecord& last = nullBackend->getLastFrame();
+			std::cout << "  [null] 마지막 프레임: 그리기 " << last.draws.size() << ", 패스 " << last.passes.size()
+				<< ", 뷰포트 " << last.viewports << ", 정점 " << last.vertices << std::endl;
+		}
+		else if (config.capture) context.savePpm("headless_" + scene + ".ppm");
+	}
+
+	const Render::TextureLoader::Stats& textures = Render::textureLoader().getStats();
+	std::cout << "[텍스처 스트리밍] 읽음 " << textures.completed << "개 (캐시 " << textures.cacheHits << ", 실패 " << textures.failed << ", 워커 "
+		<< textures.decodeSeconds * 1000.0 << " ms), 업로드 " << textures.uploadSeconds * 1000.0
+		<< " ms (update 한 번 최대 " << textures.maxFrameUploadSeconds * 1000.0 << " ms, PBO 경유 " << textures.staged << "개)" << std::endl;
+	const Render::TextureArray& array = Render::worldTextures();
+	std::cout << "[텍스처 메모리] 2D " << textures.textureBytes / 1024 << "KB (RGBA8이면 " << textures.uncompressedBytes / 1024
+		<< "KB), 월드 배열 " << array.getLayerCount() << "층 " << BlockCompression::formatName(array.getFormat()) << " "
+		<< array.getGpuBytes() / 1024 << "KB (RGBA8이면 "
+		<< BlockCompression::encodedSize(GL_RGBA8, Render::TextureArray::LAYER_SIZE, Render::TextureArray::LAYER_SIZE) * array.getLayerCount() / 1024
+		<< "KB)" << std::endl;
+
+	if (nullRender) {
+		std::cout << "[null] 메시 업로드 " << nullBackend->getMeshUploads() << ", 텍스처 업로드 "
+			<< nullBackend->getTextureUploads() << std::endl;
+	}
+	headless = nullptr;
+	return result;
+}
+
+// PACKED_ASSETS를 path 팩으로 묶고 다시 열어 매니페스트와 내용 해시를 확인한다
+int packAssets(const std::string& path)
+{
+	std::vector<std::string> files(PACKED_ASSETS, PACKED_ASSETS + sizeof(PACKED_ASSETS) / sizeof(PACKED_ASSETS[0]));
+	if (!AssetPack::build(path, files)) return 1;
+
+	AssetPack check;
+	if (!check.open(path) || check.verify() != 0) {
+		std::cerr << "에셋 팩 검사 실패: " << path << std::endl;
+		return 1;
+	}
+	return 0;
+}
 
-	return textureID;
+Render::Texture loadTexture(const char* path)
+{
+	// 디코드는 워커에서 하고, 끝날 때까지는 흰색 1x1 (예전 로드 실패 때와 같은 색)
+	Render::TextureDesc desc;
+	desc.wrap = GL_REPEAT;
+	desc.minFilter = GL_LINEAR;
+	return Render::textureLoader().load(path, desc, glm::vec3(1.0f));
 }
 
 void loadFaceTextures()
 {
 	if (faceTexturesLoaded) return;
 
-	steveFaceTextureID = loadTexture("steve_face.png");
-	alexFaceTextureID = loadTexture("alex_face.png");
+	steveFaceTexture = loadTexture("steve_face.png");
+	alexFaceTexture = loadTexture("alex_face.png");
 
 	faceTexturesLoaded = true;
 	std::cout << "얼굴 텍스처 로드 완료" << std::endl;
@@ -261,31 +636,7 @@ void initializeFaceBuffers()
 {
 	if (faceBuffersInitialized) return;
 
-	float quadVertices[] = {
-		-1.0f,  1.0f,  0.0f, 1.0f,
-		-1.0f, -1.0f,  0.0f, 0.0f,
-		 1.0f, -1.0f,  1.0f, 0.0f,
-
-		-1.0f,  1.0f,  0.0f, 1.0f,
-		 1.0f, -1.0f,  1.0f, 0.0f,
-		 1.0f,  1.0f,  1.0f, 1.0f
-	};
-
-	glGenVertexArrays(1, &faceVAO);
-	glGenBuffers(1, &faceVBO);
-
-	glBindVertexArray(faceVAO);
-
-	glBindBuffer(GL_ARRAY_BUFFER, faceVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
-
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-
-	glBindVertexArray(0);
+	Render::uploadQuad(faceMesh);
 
 	faceBuffersInitialized = true;
 	std::cout << "얼굴 렌더링 버퍼 초기화 완료" << std::endl;
@@ -297,81 +648,82 @@ void renderCharacterFace(GLuint textureID, float x, float y, float size, int scr
 		initializeFaceBuffers();
 	}
 
-	glDisable(GL_DEPTH_TEST);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-
-	glm::mat4 projection = glm::ortho(0.0f, (float)screenWidth, 0.0f, (float)screenHeight);
-	glm::mat4 view = glm::mat4(1.0f);
-	glm::mat4 model = glm::mat4(1.0f);
-
-	model = glm::translate(model, glm::vec3(x, y, 0.0f));
-	model = glm::scale(model, glm::vec3(size, size, 1.0f));
-
-	GLint modelLoc = glGetUniformLocation(shaderProgramID, "model");
-	GLint viewLoc = glGetUniformLocation(shaderProgramID, "view");
-	GLint projLoc = glGetUniformLocation(shaderProgramID, "projection");
-	GLint useTextureLoc = glGetUniformLocation(shaderProgramID, "useTexture");
-	GLint lightingEnabledLoc = glGetUniformLocation(shaderProgramID, "lightingEnabled");
-	GLint vColorLoc = glGetUniformLocation(shaderProgramID, "vColor");
-	GLint textureLoc = glGetUniformLocation(shaderProgramID, "texture1");
-
-	if (modelLoc != -1) glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &model[0][0]);
-	if (viewLoc != -1) glUniformMatrix4fv(viewLoc, 1, GL_FALSE, &view[0][0]);
-	if (projLoc != -1) glUniformMatrix4fv(projLoc, 1, GL_FALSE, &projection[0][0]);
-	if (useTextureLoc != -1) glUniform1i(useTextureLoc, 1);
-	if (lightingEnabledLoc != -1) glUniform1i(lightingEnabledLoc, 0);
-	if (vColorLoc != -1) glUniform3f(vColorLoc, 1.0f, 1.0f, 1.0f);
-	if (textureLoc != -1) glUniform1i(textureLoc, 0);
-
-	glBindVertexArray(faceVAO);
-	glDrawArrays(GL_TRIANGLES, 0, 6);
-	glBindVertexArray(0);
-
-	glEnable(GL_DEPTH_TEST);
-	glDisable(GL_BLEND);
+	Render::PassState pass;
+	pass.projection = glm::ortho(0.0f, (float)screenWidth, 0.0f, (float)screenHeight);
+	pass.depthTest = false;
+	Render::backend().beginPass(pass);
+
+	Render::DrawItem item(faceMesh);
+	item.texture = textureID;
+	item.model = glm::translate(item.model, glm::vec3(x, y, 0.0f));
+	item.model = glm::scale(item.model, glm::vec3(size, size, 1.0f));
+	item.blend = true;
+	Render::backend().draw(item);
 }
 
 void drawCharacterFaces(int winW, int winH)
 {
-	if (!splitScreenMode || currentGameState != GameState::FIRST_PERSON_MODE) return;
+	if (isNetworkGame() || !splitScreenMode || currentGameState != GameState::FIRST_PERSON_MODE) return;
 	if (!faceTexturesLoaded) return;
 
 	const float faceSize = 40.0f;
 	const float margin = 40.0f;
 
-	float steveX = margin;
-	float steveY = winH - faceSize - margin;
-
-	float alexX = margin;
-	float alexY = winH - faceSize - margin;
+	// 칸마다 왼쪽 위에 그 칸 카메라가 붙은 캐릭터 얼굴
+	for (int i = 0; i < splitLayout.getViewCount(); ++i) {
+		const ViewportRect& r = splitLayout.getViewport(i);
+		GLuint faceTexture = localCameras[i].getPlayer() == 0 ? steveFaceTexture.get() : alexFaceTexture.get();
+		Render::backend().setViewport(r.x, r.y, r.width, r.height);
+		renderCharacterFace(faceTexture, margin, r.height - faceSize - margin, faceSize, r.width, r.height);
+	}
 
-	glViewport(0, 0, winW / 2, winH);
-	renderCharacterFace(steveFaceTextureID, steveX, steveY, faceSize, winW / 2, winH);
+	Render::backend().setViewport(0, 0, winW, winH);
+}
 
-	glViewport(winW / 2, 0, winW - winW / 2, winH);
-	renderCharacterFace(alexFaceTextureID, alexX, alexY, faceSize, winW - winW / 2, winH);
+GameWorld& activeWorld()
+{
+	if (netClient) return netClient->getWorld();
+	if (rollbackSession) return rollbackSession->getWorld();
+	if (spectator) return spectator->getWorld();
+	return world;
+}
 
-	glViewport(0, 0, winW, winH);
+bool isNetworkGame()
+{
+	return netClient != nullptr || rollbackSession != nullptr;
 }
 
-void initializeGame() {
-	lightManager.setupDefaultLighting();
+bool isSpectating()
+{
+	return spectator != nullptr;
+}
 
-	gameMap.initialize();
-	std::cout << "맵 초기화 완료" << std::endl;
+// 화면 전환은 모두 여기를 거쳐 비행 기록에 남긴다
+void setGameState(GameState state)
+{
+	static const char* const names[] = { "TITLE_SCREEN", "FIRST_PERSON_MODE", "THIRD_PERSON_MODE", "FINISH_SCREEN" };
+	if (state != currentGameState) {
+		FlightRecorder::event("state %s -> %s", names[static_cast<int>(currentGameState)], names[static_cast<int>(state)]);
+	}
+	currentGameState = state;
+}
 
-	steve = new Steve::Character("steve.png");
-	std::cout << "Steve 캐릭터 초기화 완료" << std::endl;
+// 이 창에서 조작하는 캐릭터 (아직 정해지지 않았으면 -1)
+int networkPlayerIndex()
+{
+	if (netClient) return netClient->getPlayerIndex();
+	if (rollbackSession) return rollbackSession->getLocalPlayer();
+	return -1;
+}
 
-	alex = new Alex::Character("alex.png");
-	std::cout << "Alex 캐릭터 초기화 완료" << std::endl;
+void initializeGame() {
+	lightManager.setupDefaultLighting();
 
-	snowSystem.clearAll();
-	std::cout << "눈 초기화 완료" << std::endl;
+	// 네트워크/관전 모드에서는 서버 접속/P2P 세션/릴레이 프레임이 월드를 만든다
+	if (!isNetworkGame() && !isSpectating()) {
+		world.initialize();
+		std::cout << "눈 초기화 완료" << std::endl;
+	}
 
 	initializeFaceBuffers();
 	loadFaceTextures();
@@ -393,9 +745,21 @@ void initializeGame() {
 		std::cout << "IJKL: 선택된 캐릭터 이동 (앞/왼/뒤/오른)" << std::endl;
 		std::cout << "TAB: 캐릭터 선택 (Steve/Alex)" << std::endl;
 	}
+	if (isNetworkGame()) {
+		splitScreenMode = false;
+		std::cout << "\n=== 네트워크 모드 ===" << std::endl;
+		std::cout << "Steve로 접속하면 WASD/E, Alex로 접속하면 IJKL/O로 조작" << std::endl;
+	}
+	if (isSpectating()) {
+		std::cout << "\n=== 관전 모드 ===" << std::endl;
+		std::cout << "화살표 키/마우스 휠: 자유 카메라로 경기장을 둘러보기" << std::endl;
+	}
 	std::cout << "E: Steve 눈덩이 발사" << std::endl;
 	std::cout << "O: Alex 눈덩이 발사" << std::endl;
 	std::cout << "X: 모든 눈 제거" << std::endl;
+	std::cout << "F3: 성능 HUD" << std::endl;
+	std::cout << "F4: " << Profiler::DEFAULT_TRACE_SECONDS << "초 트레이스 캡처 (" << Profiler::DEFAULT_TRACE_PATH << ")" << std::endl;
+	std::cout << "F5: GL 호출 집계 (HUD에 표시), F6: 다음 프레임 GL 호출 기록 (" << GL_DUMP_PATH << ")" << std::endl;
 	std::cout << "ESC: 종료" << std::endl;
 
 	finishScreen.initialize();
@@ -406,7 +770,7 @@ void Keyboard(unsigned char key, int x, int y)
 	if (currentGameState == GameState::TITLE_SCREEN) {
 		GameState newState = titleScreen.handleKeyInput(key);
 		if (newState != GameState::TITLE_SCREEN) {
-			currentGameState = newState;
+			setGameState(newState);
 			initializeGame();
 		}
 		glutPostRedisplay();
@@ -416,14 +780,10 @@ void Keyboard(unsigned char key, int x, int y)
 	if (currentGameState == GameState::FINISH_SCREEN) {
 		if (key == 'q' || key == 'Q' || key == 27) {
 			exit(0);
-		} else if (key == 'r' || key == 'R') {
-			if (steve) { delete steve; steve = nullptr; }
-			if (alex) { delete alex; alex = nullptr; }
-			snowballs.clear();
-			snowSystem.clearAll();
+		} else if ((key == 'r' || key == 'R') && !isNetworkGame() && !isSpectating()) {
+			world.reset();
 
-			winner = Winner::NONE;
-			currentGameState = GameState::TITLE_SCREEN;
+			setGameState(GameState::TITLE_SCREEN);
 
 			titleScreen.initialize();
 
@@ -447,24 +807,15 @@ void Keyboard(unsigned char key, int x, int y)
 		activeCharacter = (activeCharacter == STEVE) ? ALEX : STEVE;
 		std::cout << "현재 선택된 캐릭터: " << (activeCharacter == STEVE ? "Steve" : "Alex") << std::endl;
 		break;
-	case 'e': case 'E': // Steve 눈덩이 차징 시작
-		if (!steveCharging && steve && steve->armState < 2) {
-			steveCharging = true;
-			steveChargeStartTime = glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
-			steve->enterCharge();
-			std::cout << "Steve 던지기 준비..." << std::endl;
-		}
+	case 'e': case 'E': // Steve 눈덩이 차징 시작 (다음 틱에 반영)
+		steveThrowFlag = true;
 		break;
-	case 'o': case 'O': // Alex 눈덩이 차징 시작
-		if (!alexCharging && alex && alex->armState < 2) {
-			alexCharging = true;
-			alexChargeStartTime = glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
-			alex->enterCharge();
-			std::cout << "Alex 던지기 준비..." << std::endl;
-		}
+	case 'o': case 'O': // Alex 눈덩이 차징 시작 (다음 틱에 반영)
+		alexThrowFlag = true;
 		break;
 	case 'x': case 'X':
-		snowSystem.clearAll();
+		if (isNetworkGame() || isSpectating()) break;
+		world.snowSystem.clearAll();
 		std::cout << "모든 눈 제거됨" << std::endl;
 		break;
 	default:
@@ -480,121 +831,32 @@ void KeyboardUp(unsigned char key, int x, int y)
 		return;
 	}
 
+	// 던지기 키를 떼면 다음 틱에서 GameWorld가 발사를 처리한다
 	input.releaseKey(static_cast<int>(key));
 
-	switch (key) {
-	case 'e': case 'E': // Steve 눈덩이 발사
-		if (steveCharging) {
-			fireSteveSnowball();
-			if (steve) steve->enterThrow();
-		}
-		break;
-	case 'o': case 'O': // Alex 눈덩이 발사
-		if (alexCharging) {
-			fireAlexSnowball();
-			if (alex) alex->enterThrow();
-		}
-		break;
-	}
-
 	glutPostRedisplay();
 }
 
-
-void fireSteveSnowball()
-{
-    if (!steve) return;
-    float currentTime = glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
-    float chargeTime = currentTime - steveChargeStartTime;
-    float chargeRatio = std::min(chargeTime / maxChargeTime, 1.0f);
-
-    float speed = minSpeed + (maxSpeed - minSpeed) * chargeRatio;
-    speed *= steve->throwingSpeed;
-    speed = std::min(speed, maxSpeed);
-
-    glm::vec3 shootDirection = steveCamera.getFront();
-    glm::vec3 startPos = steve->pos + shootDirection * 1.0f + glm::vec3(0, 1, 0) * 0.5f;
-    glm::vec3 direction = shootDirection + glm::vec3(0, 1, 0) * 0.3f;
-
-    Snowball newSnowball(startPos, direction, speed, 0.15f);
-    snowballs.push_back(newSnowball);
-    steveCharging = false;
-}
-
-void fireAlexSnowball()
-{
-	if (!alex) return;
-
-	float currentTime = glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
-	float chargeTime = currentTime - alexChargeStartTime;
-	float chargeRatio = std::min(chargeTime / maxChargeTime, 1.0f);
-	float speed = minSpeed + (maxSpeed - minSpeed) * chargeRatio;
-
-	speed *= alex->throwingSpeed;
-	speed = std::min(speed, maxSpeed);
-
-	glm::vec3 shootDirection = alexCamera.getFront();
-	glm::vec3 startPos = alex->pos + shootDirection * 1.0f + glm::vec3(0, 1, 0) * 0.5f;
-	glm::vec3 direction = shootDirection + glm::vec3(0, 1, 0) * 0.3f;
-
-	Snowball newSnowball(startPos, direction, speed, 0.15f);
-	snowballs.push_back(newSnowball);
-
-	std::cout << "Alex 눈덩이 발사! 차징 시간: " << chargeTime << "초, 속도: " << speed
-		<< " (현재 " << snowballs.size() << "개)" << std::endl;
-
-	alexCharging = false;
-}
-
-bool checkSnowballCharacterCollision(const Snowball& snowball, const glm::vec3& characterPos, const glm::vec3& boundingBoxSize)
-{
-	if (!snowball.getIsActive()) return false;
-
-	glm::vec3 snowballPos = snowball.getPosition();
-	float snowballRadius = snowball.getRadius();
-
-	glm::vec3 characterMin = characterPos - boundingBoxSize / 2.0f;
-	glm::vec3 characterMax = characterPos + boundingBoxSize / 2.0f;
-
-	float closestX = std::max(characterMin.x, std::min(snowballPos.x, characterMax.x));
-	float closestY = std::max(characterMin.y, std::min(snowballPos.y, characterMax.y));
-	float closestZ = std::max(characterMin.z, std::min(snowballPos.z, characterMax.z));
-
-	glm::vec3 closestPoint(closestX, closestY, closestZ);
-
-	glm::vec3 distance = snowballPos - closestPoint;
-	float distanceSquared = glm::dot(distance, distance);
-
-	return distanceSquared <= (snowballRadius * snowballRadius);
-}
-
-void checkAllSnowballCollisions()
+void SpecialKeyboard(int key, int x, int y)
 {
-	for (const auto& snowball : snowballs) {
-		if (!snowball.getIsActive()) continue;
-
-		if (steve && checkSnowballCharacterCollision(snowball, steve->pos, steve->boundingBoxSize)) {
-			std::cout << "\n=== 경기 종료 ===\nSteve가 눈덩이에 맞았습니다!" << std::endl;
-
-			winner = Winner::ALEX;
-			finishScreen.setWinner(winner);
-			currentGameState = GameState::FINISH_SCREEN;
-			return;
-		}
-
-		if (alex && checkSnowballCharacterCollision(snowball, alex->pos, alex->boundingBoxSize)) {
-			std::cout << "\n=== 경기 종료 ===\nAlex가 눈덩이에 맞았습니다!" << std::endl;
-
-			winner = Winner::STEVE;
-			finishScreen.setWinner(winner);
-			currentGameState = GameState::FINISH_SCREEN;
-			return;
-		}
+	if (key == GLUT_KEY_F3) {
+		PerfHud::toggle();
+		glutPostRedisplay();
+		return;
+	}
+	if (key == GLUT_KEY_F4) {
+		Profiler::startCapture(Profiler::DEFAULT_TRACE_SECONDS, Profiler::DEFAULT_TRACE_PATH);
+		return;
+	}
+	if (key == GLUT_KEY_F5) {
+		GlIntercept::setEnabled(!GlIntercept::isEnabled());
+		return;
+	}
+	if (key == GLUT_KEY_F6) {
+		GlIntercept::requestDump(GL_DUMP_PATH);
+		return;
 	}
-}
 
-void SpecialKeyboard(int key, int x, int y)
-{
 	if (currentGameState == GameState::TITLE_SCREEN) {
 		return;
 	}
@@ -630,8 +892,7 @@ void Mouse(int button, int state, int x, int y)
 	// 마우스 휠로 줌 인/아웃
 	if (button == 3) { // 휠 위로
 		if (splitScreenMode) {
-			steveCamera.processMouseScroll(1);
-			alexCamera.processMouseScroll(1);
+			for (FirstPersonCamera& localCamera : localCameras) localCamera.processMouseScroll(1);
 		}
 		else {
 			camera.processMouseScroll(1);
@@ -641,8 +902,7 @@ void Mouse(int button, int state, int x, int y)
 	}
 	else if (button == 4) { // 휠 아래로
 		if (splitScreenMode) {
-			steveCamera.processMouseScroll(-1);
-			alexCamera.processMouseScroll(-1);
+			for (FirstPersonCamera& localCamera : localCameras) localCamera.processMouseScroll(-1);
 		}
 		else {
 			camera.processMouseScroll(-1);
@@ -657,172 +917,260 @@ void MouseMotion(int x, int y)
 
 }
 
-void make_shaderProgram()
+// vertex.glsl/fragment.glsl의 변형을 전부 미리 만들어서 GL 백엔드에 넘긴다. 지난 실행의 바이너리 캐시에
+// 있는 변형은 컴파일하지 않으므로, 변형이 늘어도 두 번째 실행부터 첫 화면까지의 시간은 거의 그대로다.
+// 정점 셰이더에서 뷰포트를 고를 수 없는 드라이버면 MULTIVIEW 변형은 만들지 않고, 분할 화면은 시점마다 따로 그린다.
+bool make_shaderProgram()
 {
-
-	// 먼저 파일에서 읽기 시도
-	vertexSource = filetobuf("vertex.glsl");
-	fragmentSource = filetobuf("fragment.glsl");
-
-	// 버텍스 셰이더
-	vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, (const GLchar**)&vertexSource, 0);
-	glCompileShader(vertexShader);
-
-	GLint result;
-	GLchar errorLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &result);
-	if (!result)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, errorLog);
-		std::cerr << "ERROR: vertex shader 컴파일 실패\n" << errorLog << std::endl;
-		return;
+	shaderLibrary.setCachePath(shaderCacheEnabled ? SHADER_CACHE_PATH : nullptr);
+	if (!shaderLibrary.load("vertex.glsl", "fragment.glsl")) return false;
+
+	bool multiView = multiViewEnabled;
+	if (multiView && (!(GLEW_ARB_viewport_array || GLEW_VERSION_4_1) ||
+		!(GLEW_ARB_shader_viewport_layer_array || GLEW_AMD_vertex_shader_viewport_index))) {
+		std::cout << "분할 화면: 정점 셰이더 뷰포트 선택 미지원, 시점마다 따로 그림" << std::endl;
+		multiView = false;
 	}
 
-	// 프래그먼트 셰이더
-	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, (const GLchar**)&fragmentSource, 0);
-	glCompileShader(fragmentShader);
-
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &result);
-	if (!result)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, errorLog);
-		std::cerr << "ERROR: fragment shader 컴파일 실패\n" << errorLog << std::endl;
-		return;
-	}
-
-	// 셰이더 프로그램 생성
-	shaderProgramID = glCreateProgram();
-	glAttachShader(shaderProgramID, vertexShader);
-	glAttachShader(shaderProgramID, fragmentShader);
-	glLinkProgram(shaderProgramID);
-
-	// 링크 상태 확인
-	glGetProgramiv(shaderProgramID, GL_LINK_STATUS, &result);
-	if (!result) {
-		glGetProgramInfoLog(shaderProgramID, 512, NULL, errorLog);
-		std::cerr << "ERROR: shader program 링크 실패\n" << errorLog << std::endl;
-		return;
+	double start = Profiler::now();
+	int compiled = shaderLibrary.compileAll(multiView);
+	const ShaderLibrary::Stats& shaderStats = shaderLibrary.getStats();
+	std::cout << "셰이더 변형 " << compiled << "개 (캐시 " << shaderStats.cached << ", 컴파일 " << shaderStats.compiled
+		<< (shaderStats.parallel ? ", 병렬 컴파일" : "") << ", " << (Profiler::now() - start) * 1000.0 << "ms)" << std::endl;
+
+	Render::GlBackend& gl = Render::glBackend();
+	gl.setShaders(&shaderLibrary, multiView);
+	if (!gl.isReady()) return false;
+	if (multiViewEnabled) {
+		std::cout << "분할 화면: " << (gl.supportsMultiView() ? "한 번 제출 (시점별 인스턴스)" : "시점마다 따로 그림") << std::endl;
 	}
-
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	glUseProgram(shaderProgramID);
-	glUniform1i(glGetUniformLocation(shaderProgramID, "texture1"), 0);
-	std::cout << "셰이더 프로그램이 성공적으로 생성되었습니다." << std::endl;
+	return true;
 }
 
 GLvoid drawScene()
 {
-	if (shaderProgramID == 0) return;
-	glUseProgram(shaderProgramID);
-	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	// 프레임 = 이전 drawScene 시작부터 이번 시작까지 (그 사이의 틱 포함)
+	PROFILE_FRAME_END();
+	FlightRecorder::endFrame();
+	GlIntercept::endFrame();
+	GlState::endFrame();
+	GPU_FRAME_BEGIN();
+	PROFILE_SCOPE("draw");
+
+	if (!Render::backend().isReady()) return;
+	{
+		PROFILE_SCOPE("texture.upload");
+		Render::textureLoader().update();
+	}
+	Render::backend().beginFrame(glm::vec3(0.1f, 0.1f, 0.1f));
 
 	if (currentGameState == GameState::TITLE_SCREEN) {
-		titleScreen.render(shaderProgramID);
-		glutSwapBuffers();
+		{
+			PROFILE_SCOPE("render.title");
+			GPU_SCOPE("gpu.title");
+			titleScreen.render();
+		}
+		presentFrame();
 		return;
 	}
 
 	if (currentGameState == GameState::FINISH_SCREEN) {
-		finishScreen.render(shaderProgramID);
-		glutSwapBuffers();
+		{
+			PROFILE_SCOPE("render.finish");
+			GPU_SCOPE("gpu.finish");
+			finishScreen.render();
+		}
+		presentFrame();
 		return;
 	}
 
-	int winW = glutGet(GLUT_WINDOW_WIDTH);
-	int winH = glutGet(GLUT_WINDOW_HEIGHT);
-	if (winW <= 0) winW = WinX;
-	if (winH <= 0) winH = WinY;
-
-	if (splitScreenMode && currentGameState == GameState::FIRST_PERSON_MODE) {
-		if (steve) steveCamera.updateFromCharacterPosition(steve->pos);
-		if (alex) alexCamera.updateFromCharacterPosition(alex->pos);
+	int winW = windowWidth();
+	int winH = windowHeight();
 
-		// 왼쪽: Steve
-		glViewport(0, 0, winW / 2, winH);
-		glm::mat4 steveView = steveCamera.getViewMatrix();
-		glm::mat4 steveProj = steveCamera.getProjectionMatrix(winW / 2, winH);
-		renderWorld(steveView, steveProj);
+	GameWorld& w = activeWorld();
 
-		glClear(GL_DEPTH_BUFFER_BIT);
+	if (isSpectating() && !w.hasCharacters()) {
+		// 첫 키프레임을 받기 전
+		Render::backend().setViewport(0, 0, winW, winH);
+		presentFrame();
+		return;
+	}
 
-		// 오른쪽: Alex
-		glViewport(winW / 2, 0, winW - winW / 2, winH);
-		glm::mat4 alexView = alexCamera.getViewMatrix();
-		glm::mat4 alexProj = alexCamera.getProjectionMatrix(winW - winW / 2, winH);
-		renderWorld(alexView, alexProj);
+	if (isNetworkGame()) {
+		// 자기 캐릭터 시점으로 전체 화면
+		Render::backend().setViewport(0, 0, winW, winH);
+		if (!w.hasCharacters()) {
+			presentFrame();
+			return;
+		}
+		FirstPersonCamera& localCamera = localCameras[networkPlayerIndex() == 1 ? 1 : 0];
+		localCamera.updateFromCharacterPosition(w.getCharacterPosition(localCamera.getPlayer()));
+		PROFILE_SCOPE("render.view_local");
+		GPU_SCOPE("gpu.view_local");
+		WorldView view = { localCamera.getViewMatrix(), localCamera.getProjectionMatrix(winW, winH), localCamera.getFrustum(winW, winH), 0, 0, winW, winH };
+		renderWorld(&view, 1);
+	}
+	else if (splitScreenMode && currentGameState == GameState::FIRST_PERSON_MODE) {
+		// 칸마다 카메라 하나. 뷰포트가 겹치지 않아서 깊이 버퍼를 같이 쓴다.
+		splitLayout.update(localViewCount, winW, winH);
+		WorldView views[ViewportLayout::MAX_VIEWS];
+		for (int i = 0; i < splitLayout.getViewCount(); ++i) {
+			FirstPersonCamera& localCamera = localCameras[i];
+			const ViewportRect& r = splitLayout.getViewport(i);
+			if (w.hasCharacters()) localCamera.updateFromCharacterPosition(w.getCharacterPosition(localCamera.getPlayer()));
+			views[i] = WorldView{ localCamera.getViewMatrix(), localCamera.getProjectionMatrix(r.width, r.height),
+				localCamera.getFrustum(r.width, r.height), r.x, r.y, r.width, r.height };
+		}
+		{
+			PROFILE_SCOPE("render.view_split");
+			GPU_SCOPE("gpu.view_split");
+			renderWorld(views, splitLayout.getViewCount());
+		}
 
+		PROFILE_SCOPE("render.hud_faces");
+		GPU_SCOPE("gpu.hud_faces");
 		drawCharacterFaces(winW, winH);
 	}
 	else {
-		glViewport(0, 0, winW, winH);
-		glm::mat4 view = camera.getViewMatrix();
-		glm::mat4 proj = camera.getProjectionMatrix(winW, winH);
-		renderWorld(view, proj);
+		PROFILE_SCOPE("render.view_free");
+		GPU_SCOPE("gpu.view_free");
+		WorldView view = { camera.getViewMatrix(), camera.getProjectionMatrix(winW, winH), camera.getFrustum(winW, winH), 0, 0, winW, winH };
+		renderWorld(&view, 1);
 	}
 
-	glutSwapBuffers();
+	presentFrame();
 }
 
-GLvoid drawSplitScreen() 
+// 성능 HUD를 맨 위에 그리고 화면을 넘긴다
+void presentFrame()
 {
-	
+	Render::backend().endFrame();
+	if (&Render::backend() != &Render::glBackend()) return;   // null 백엔드: 넘길 GL 화면이 없다
+
+	PerfHud::draw(windowWidth(), windowHeight());
+
+	PROFILE_SCOPE("swap");
+	if (headless) {
+		// 넘길 화면이 없으니 GPU가 다 그릴 때까지 기다려서 그 시간까지 프레임에 넣는다
+		glFinish();
+	}
+	else {
+		glutSwapBuffers();
+	}
 }
 
-GLvoid renderWorld(const glm::mat4& view, const glm::mat4& projection)
+// 그릴 대상의 크기 (헤드리스면 FBO 크기)
+int windowWidth()
 {
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
-	glFrontFace(GL_CCW);
-	glEnable(GL_DEPTH_TEST);
-
-	unsigned int modelLoc = glGetUniformLocation(shaderProgramID, "model");
-	unsigned int viewLoc = glGetUniformLocation(shaderProgramID, "view");
-	unsigned int projLoc = glGetUniformLocation(shaderProgramID, "projection");
+	if (headless) return headless->getWidth();
+	int w = glutGet(GLUT_WINDOW_WIDTH);
+	return w > 0 ? w : WinX;
+}
 
-	GLint lightPosLoc = glGetUniformLocation(shaderProgramID, "lightPos");
-	GLint lightColorLoc = glGetUniformLocation(shaderProgramID, "lightColor");
-	GLint viewPosLoc = glGetUniformLocation(shaderProgramID, "viewPos");
-	GLint lightingEnabledLoc = glGetUniformLocation(shaderProgramID, "lightingEnabled");
-	GLint useTextureLoc = glGetUniformLocation(shaderProgramID, "useTexture");
+int windowHeight()
+{
+	if (headless) return headless->getHeight();
+	int h = glutGet(GLUT_WINDOW_HEIGHT);
+	return h > 0 ? h : WinY;
+}
 
-	if (lightingEnabledLoc != -1) glUniform1i(lightingEnabledLoc, 1);
+GLvoid drawSplitScreen() 
+{
+	
+}
 
-	if (lightPosLoc != -1) {
-		glm::vec3 lightPos(5.0f, 8.0f, 7.5f);
-		glUniform3fv(lightPosLoc, 1, &lightPos[0]);
+// 시점이 하나면 그 뷰포트에 그냥 그린다. 여럿이면 컬링, 캐릭터 애니메이션 행렬, 목록 채우기를
+// 한 번만 하고 (어느 시점에라도 보이는 것), 패스 하나로 각 시점의 뷰포트에 같이 그린다.
+// 시점이 늘어도 늘어나는 일은 절두체 검사 몇 번과 시점별 행렬 하나씩뿐이다.
+GLvoid renderWorld(const WorldView* views, int viewCount)
+{
+	Render::PassState pass;
+	FrustumSet frustums;
+	viewCount = std::min(viewCount, Render::MAX_VIEWS);
+	if (viewCount == 1) Render::backend().setViewport(views[0].x, views[0].y, views[0].width, views[0].height);
+	for (int i = 0; i < viewCount; ++i) {
+		frustums.add(views[i].frustum);
 	}
-	if (lightColorLoc != -1) {
-		glm::vec3 lightColor(1.5f, 1.5f, 1.5f);
-		glUniform3fv(lightColorLoc, 1, &lightColor[0]);
+	pass.view = views[0].view;
+	pass.projection = views[0].projection;
+	pass.viewPos = glm::vec3(glm::inverse(views[0].view)[3]);
+	if (viewCount > 1) {
+		pass.viewCount = viewCount;
+		for (int i = 0; i < viewCount; ++i) {
+			Render::PassView& v = pass.views[i];
+			v.view = views[i].view;
+			v.projection = views[i].projection;
+			v.viewPos = glm::vec3(glm::inverse(views[i].view)[3]);
+			v.x = views[i].x;
+			v.y = views[i].y;
+			v.width = views[i].width;
+			v.height = views[i].height;
+		}
 	}
+	pass.lightPos = glm::vec3(5.0f, 8.0f, 7.5f);
+	pass.lightColor = glm::vec3(1.5f, 1.5f, 1.5f);
+	pass.lighting = true;
+	pass.depthTest = true;
+	pass.cullFace = true;
+	uint32_t passIndex = worldQueue.addPass(pass);
 
-	if (viewLoc != -1) glUniformMatrix4fv(viewLoc, 1, GL_FALSE, &view[0][0]);
-	if (projLoc != -1) glUniformMatrix4fv(projLoc, 1, GL_FALSE, &projection[0][0]);
-
-	if (useTextureLoc != -1) glUniform1i(useTextureLoc, 0);
-	gameMap.render();
+	GameWorld& w = activeWorld();
 
-	if (useTextureLoc != -1) glUniform1i(useTextureLoc, 1);
-	snowSystem.render(shaderProgramID);
-
-	if (useTextureLoc != -1) glUniform1i(useTextureLoc, 1);
+	{
+		PROFILE_SCOPE("render.cull_entities");
+		// 팔을 들어 올리면 충돌 상자 밖으로 이만큼 나온다
+		const glm::vec3 limbReach(0.7f);
+		entityBounds.clear();
+		if (w.steve) entityBounds.add(w.steve->pos - w.steve->boundingBoxSize * 0.5f - limbReach, w.steve->pos + w.steve->boundingBoxSize * 0.5f + limbReach);
+		if (w.alex) entityBounds.add(w.alex->pos - w.alex->boundingBoxSize * 0.5f - limbReach, w.alex->pos + w.alex->boundingBoxSize * 0.5f + limbReach);
+		for (const auto& snowball : w.snowballs) {
+			glm::vec3 radius(snowball.getRadius());
+			entityBounds.add(snowball.getPosition() - radius, snowball.getPosition() + radius);
+		}
+		lastCull.entities = cullAabbs(frustums, entityBounds, entityVisible);
+		lastCull.entitiesTotal = entityBounds.size();
+	}
 
-	if (steve) {
-		steve->draw(modelLoc);
+	// 목록끼리는 독립이라 따로 채울 수 있다. 지금은 수백 개뿐이라 여기서 차례로 채운다.
+	// 깊이 정렬은 첫 시점 기준이다 (반투명은 눈 메시 하나뿐이라 시점마다 순서가 달라질 일이 없다).
+	{
+		PROFILE_SCOPE("render.map");
+		mapList.begin(passIndex, pass.viewPos);
+		w.gameMap.render(mapList, frustums);
+		lastCull.blocks = mapList.size();
+		lastCull.blocksTotal = w.gameMap.getBlockCount();
 	}
-	if (alex) {
-		alex->draw(modelLoc);
+	{
+		PROFILE_SCOPE("render.snow");
+		snowList.begin(passIndex, pass.viewPos);
+		w.snowSystem.render(snowList, frustums);
 	}
-
-	if (useTextureLoc != -1) glUniform1i(useTextureLoc, 0);
-	for (const auto& snowball : snowballs) {
-		snowball.render(shaderProgramID, glm::vec3(1.0f));
+	size_t entity = 0;
+	{
+		PROFILE_SCOPE("render.characters");
+		characterList.begin(passIndex, pass.viewPos);
+		if (w.steve && entityVisible[entity++]) {
+			w.steve->draw(characterList);
+		}
+		if (w.alex && entityVisible[entity++]) {
+			w.alex->draw(characterList);
+		}
+	}
+	{
+		PROFILE_SCOPE("render.snowballs");
+		snowballList.begin(passIndex, pass.viewPos);
+		for (const auto& snowball : w.snowballs) {
+			if (entityVisible[entity++]) snowball.render(snowballList, glm::vec3(1.0f));
+		}
 	}
+
+	PROFILE_SCOPE("render.submit");
+	GPU_SCOPE("gpu.world");
+	worldQueue.append(mapList);
+	worldQueue.append(snowList);
+	worldQueue.append(characterList);
+	worldQueue.append(snowballList);
+	worldQueue.execute(Render::backend());
 }
 
 GLvoid Reshape(int w, int h)
@@ -830,100 +1178,108 @@ GLvoid Reshape(int w, int h)
 	glViewport(0, 0, w, h);
 }
 
-void updateStevePosition(float deltaTime)
+PlayerInput readSteveInput(bool firstPersonControls)
 {
-	steve->moveDir = glm::vec2(0.0f, 0.0f);
+	PlayerInput in;
 
-	if (splitScreenMode) {
-		if (input.isKeyDown('w') || input.isKeyDown('W')) steve->moveDir.y += 1.0f;
-		if (input.isKeyDown('s') || input.isKeyDown('S')) steve->moveDir.y += -1.0f;
-		if (input.isKeyDown('a') || input.isKeyDown('A')) steve->moveDir.x += 1.0f;
-		if (input.isKeyDown('d') || input.isKeyDown('D')) steve->moveDir.x += -1.0f;
+	if (firstPersonControls) {
+		if (input.isKeyDown('w') || input.isKeyDown('W')) in.moveDir.y += 1.0f;
+		if (input.isKeyDown('s') || input.isKeyDown('S')) in.moveDir.y += -1.0f;
+		if (input.isKeyDown('a') || input.isKeyDown('A')) in.moveDir.x += 1.0f;
+		if (input.isKeyDown('d') || input.isKeyDown('D')) in.moveDir.x += -1.0f;
 	}
 	else {
-		if (input.isKeyDown('w') || input.isKeyDown('W')) steve->moveDir.x += 1.0f;
-		if (input.isKeyDown('s') || input.isKeyDown('S')) steve->moveDir.x += -1.0f;
-		if (input.isKeyDown('a') || input.isKeyDown('A')) steve->moveDir.y += -1.0f;
-		if (input.isKeyDown('d') || input.isKeyDown('D')) steve->moveDir.y += 1.0f;
+		if (input.isKeyDown('w') || input.isKeyDown('W')) in.moveDir.x += 1.0f;
+		if (input.isKeyDown('s') || input.isKeyDown('S')) in.moveDir.x += -1.0f;
+		if (input.isKeyDown('a') || input.isKeyDown('A')) in.moveDir.y += -1.0f;
+		if (input.isKeyDown('d') || input.isKeyDown('D')) in.moveDir.y += 1.0f;
 	}
+
+	in.throwHeld = input.isKeyDown('e') || input.isKeyDown('E') || steveThrowFlag;
+	steveThrowFlag = false;
+	in.aim = localCameras[0].getFront();
+	return in;
 }
 
-void updateAlexPosition(float deltaTime)
+PlayerInput readAlexInput(bool firstPersonControls)
 {
-	alex->moveDir = glm::vec2(0.0f, 0.0f);
-	if (splitScreenMode) {
-		if (input.isKeyDown('i') || input.isKeyDown('I')) alex->moveDir.y += -1.0f;
-		if (input.isKeyDown('k') || input.isKeyDown('K')) alex->moveDir.y += 1.0f;
-		if (input.isKeyDown('j') || input.isKeyDown('J')) alex->moveDir.x += -1.0f;
-		if (input.isKeyDown('l') || input.isKeyDown('L')) alex->moveDir.x += 1.0f;
+	PlayerInput in;
+
+	if (firstPersonControls) {
+		if (input.isKeyDown('i') || input.isKeyDown('I')) in.moveDir.y += -1.0f;
+		if (input.isKeyDown('k') || input.isKeyDown('K')) in.moveDir.y += 1.0f;
+		if (input.isKeyDown('j') || input.isKeyDown('J')) in.moveDir.x += -1.0f;
+		if (input.isKeyDown('l') || input.isKeyDown('L')) in.moveDir.x += 1.0f;
 	}
 	else {
-		if (input.isKeyDown('i') || input.isKeyDown('I')) alex->moveDir.x += 1.0f;
-		if (input.isKeyDown('k') || input.isKeyDown('K')) alex->moveDir.x += -1.0f;
-		if (input.isKeyDown('j') || input.isKeyDown('J')) alex->moveDir.y += -1.0f;
-		if (input.isKeyDown('l') || input.isKeyDown('L')) alex->moveDir.y += 1.0f;
+		if (input.isKeyDown('i') || input.isKeyDown('I')) in.moveDir.x += 1.0f;
+		if (input.isKeyDown('k') || input.isKeyDown('K')) in.moveDir.x += -1.0f;
+		if (input.isKeyDown('j') || input.isKeyDown('J')) in.moveDir.y += -1.0f;
+		if (input.isKeyDown('l') || input.isKeyDown('L')) in.moveDir.y += 1.0f;
 	}
-}
 
-void checkSteveMoving()
-{
-	bool moving = input.isKeyDown('w') || input.isKeyDown('W') ||
-		input.isKeyDown('s') || input.isKeyDown('S') ||
-		input.isKeyDown('a') || input.isKeyDown('A') ||
-		input.isKeyDown('d') || input.isKeyDown('D');
-	if (!moving && steve) steve->changeState(1, 0);
-}
-
-
-void checkAlexMoving()
-{
-	bool moving = input.isKeyDown('i') || input.isKeyDown('I') ||
-		input.isKeyDown('j') || input.isKeyDown('J') ||
-		input.isKeyDown('k') || input.isKeyDown('K') ||
-		input.isKeyDown('l') || input.isKeyDown('L');
-	if (!moving && alex) alex->changeState(1, 0);
+	in.throwHeld = input.isKeyDown('o') || input.isKeyDown('O') || alexThrowFlag;
+	alexThrowFlag = false;
+	in.aim = localCameras[1].getFront();
+	return in;
 }
 
 void TimerFunction(int value)
 {
+	Profiler::updateCapture();
+	PROFILE_SCOPE("tick");
+
 	if (currentGameState == GameState::TITLE_SCREEN) {
 		glutPostRedisplay();
 		glutTimerFunc(16, TimerFunction, 1);
 		return;
 	}
 
-	float deltaTime = 0.016f;
-
-	snowSystem.updateAnimations(deltaTime);
+	if (netClient) {
+		PlayerInput in = (netClient->getPlayerIndex() == 1) ? readAlexInput(true) : readSteveInput(true);
+		netClient->update(in);
 
-	for (auto& sb : snowballs) sb.update(deltaTime, snowSystem, gameMap);
-	snowballs.erase(std::remove_if(snowballs.begin(), snowballs.end(),
-		[](const Snowball& s) { return !s.getIsActive(); }), snowballs.end());
-
-	checkAllSnowballCollisions();
-
-	if (steve && steveCharging && steve->armState == 2) {
-		float currentTime = glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
-		float chargeTime = currentTime - steveChargeStartTime;
-		float chargeRatio = std::min(chargeTime / maxChargeTime, 1.0f);
-		steve->armAngle = -glm::radians(180.0f) * chargeRatio;
+		// 서버가 경기 종료/재시작을 결정한다
+		Winner serverWinner = netClient->getWorld().winner;
+		if (serverWinner != Winner::NONE && currentGameState != GameState::FINISH_SCREEN) {
+			finishScreen.setWinner(serverWinner);
+			setGameState(GameState::FINISH_SCREEN);
+		}
+		else if (serverWinner == Winner::NONE && currentGameState == GameState::FINISH_SCREEN) {
+			setGameState(GameState::FIRST_PERSON_MODE);
+		}
 	}
-	if (alex && alexCharging && alex->armState == 2) {
-		float currentTime = glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
-		float chargeTime = currentTime - alexChargeStartTime;
-		float chargeRatio = std::min(chargeTime / maxChargeTime, 1.0f);
-		alex->armAngle = -glm::radians(180.0f) * chargeRatio;
+	else if (rollbackSession) {
+		PlayerInput in = (rollbackSession->getLocalPlayer() == 1) ? readAlexInput(true) : readSteveInput(true);
+		rollbackSession->advanceFrame(in);
+
+		Winner p2pWinner = rollbackSession->getWorld().winner;
+		if (p2pWinner != Winner::NONE && currentGameState != GameState::FINISH_SCREEN) {
+			finishScreen.setWinner(p2pWinner);
+			setGameState(GameState::FINISH_SCREEN);
+		}
 	}
+	else if (spectator) {
+		spectator->update();
 
-	// 캐릭터 업데이트
-	updateStevePosition(deltaTime);
-	updateAlexPosition(deltaTime);
-
-	if (steve) steve->update(gameMap, snowSystem);
-	if (alex) alex->update(gameMap, snowSystem);
+		Winner relayWinner = spectator->getWorld().winner;
+		if (relayWinner != Winner::NONE && currentGameState != GameState::FINISH_SCREEN) {
+			finishScreen.setWinner(relayWinner);
+			setGameState(GameState::FINISH_SCREEN);
+		}
+		else if (relayWinner == Winner::NONE && currentGameState == GameState::FINISH_SCREEN) {
+			setGameState(GameState::THIRD_PERSON_MODE);
+		}
+	}
+	else {
+		PlayerInput inputs[PLAYER_COUNT] = { readSteveInput(splitScreenMode), readAlexInput(splitScreenMode) };
+		world.tick(inputs);
 
-	checkSteveMoving();
-	checkAlexMoving();
+		if (world.winner != Winner::NONE && currentGameState != GameState::FINISH_SCREEN) {
+			finishScreen.setWinner(world.winner);
+			setGameState(GameState::FINISH_SCREEN);
+		}
+	}
 
 	cameraPos = camera.position;
 	cameraFront = camera.front;
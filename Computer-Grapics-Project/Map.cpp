@@ -1,5 +1,7 @@
 #include "Map.h"
 #include <gl/glew.h>
+#include <map>
+#include <cmath>
 
 Map::Map() : frontGround(MAP_WIDTH, 5, BLOCK_SIZE), backGround(MAP_WIDTH, 5, BLOCK_SIZE)
 {
@@ -27,11 +29,73 @@ void Map::initialize()
         
         surroundingWall.createVerticalWall(MAP_WIDTH * BLOCK_SIZE, wallY, 0.0f, MAP_DEPTH, BLOCK_SIZE);
     }
+
+    buildChunks();
+}
+
+void Map::render(Render::DrawList& out, const FrustumSet& frustums) const
+{
+    cullAabbs(frustums, chunkBounds, chunkVisible);
+
+    const glm::vec3 groundColor = frontGround.getColor();
+    const glm::vec3 wallColor = surroundingWall.getColor();
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (!chunkVisible[c]) continue;
+        for (const ChunkBlock& block : chunks[c]) {
+            getChunkBlock(block).render(out, block.part == 2 ? wallColor : groundColor);
+        }
+    }
+}
+
+size_t Map::getBlockCount() const
+{
+    return static_cast<size_t>(frontGround.getWidth() * frontGround.getDepth())
+        + static_cast<size_t>(backGround.getWidth() * backGround.getDepth())
+        + surroundingWall.getBlockCount();
 }
 
-void Map::render() const
+const Block& Map::getChunkBlock(const ChunkBlock& block) const
 {
-    frontGround.render();
-    backGround.render(); 
-    surroundingWall.render();
+    if (block.part == 0) return frontGround.getBlock(block.a, block.b);
+    if (block.part == 1) return backGround.getBlock(block.a, block.b);
+    return surroundingWall.getBlock(block.a);
+}
+
+void Map::buildChunks()
+{
+    std::map<std::pair<int, int>, std::vector<ChunkBlock>> cells;
+    auto addBlock = [&](const ChunkBlock& entry) {
+        const Block& block = getChunkBlock(entry);
+        //  -1ĭ ϹǷ  ĭ о 
+        int cx = static_cast<int>(std::floor((block.getX() / BLOCK_SIZE + 1.0f) / CHUNK_SIZE));
+        int cz = static_cast<int>(std::floor((block.getZ() / BLOCK_SIZE + 1.0f) / CHUNK_SIZE));
+        cells[std::make_pair(cx, cz)].push_back(entry);
+    };
+
+    const Ground* grounds[2] = { &frontGround, &backGround };
+    for (uint8_t part = 0; part < 2; ++part) {
+        for (int x = 0; x < grounds[part]->getWidth(); ++x) {
+            for (int z = 0; z < grounds[part]->getDepth(); ++z) {
+                addBlock(ChunkBlock{ part, static_cast<uint16_t>(x), static_cast<uint16_t>(z) });
+            }
+        }
+    }
+    for (size_t i = 0; i < surroundingWall.getBlockCount(); ++i) {
+        addBlock(ChunkBlock{ 2, static_cast<uint16_t>(i), 0 });
+    }
+
+    chunks.clear();
+    chunkBounds.clear();
+    for (auto& cell : cells) {
+        glm::vec3 min(1e9f), max(-1e9f);
+        for (const ChunkBlock& entry : cell.second) {
+            const Block& block = getChunkBlock(entry);
+            glm::vec3 center(block.getX(), block.getY(), block.getZ());
+            glm::vec3 half(block.getSize() * 0.5f);
+            min = glm::min(min, center - half);
+            max = glm::max(max, center + half);
+        }
+        chunks.push_back(std::move(cell.second));
+        chunkBounds.add(min, max);
+    }
 }
@@ -1,6 +1,9 @@
 #pragma once
 #include "Ground.h"
 #include "Wall.h"
+#include "Frustum.h"
+#include <cstdint>
+#include <vector>
 
 constexpr int MAP_WIDTH = 10;
 constexpr int MAP_DEPTH = 15;
@@ -11,6 +14,20 @@ private:
     Ground frontGround;
     Ground backGround;
     Wall surroundingWall;
+
+    // ø : ٴڰ   XZ 鿡 CHUNK_SIZEĭ ´.
+    //  ּ  ( , ȣ) Ѽ Map ص ϴ.
+    static const int CHUNK_SIZE = 4;
+    struct ChunkBlock {
+        uint8_t part;          // 0  ٴ, 1  ٴ, 2 
+        uint16_t a, b;         // ٴ (x, z),  a
+    };
+    std::vector<std::vector<ChunkBlock>> chunks;
+    AabbList chunkBounds;
+    mutable std::vector<uint8_t> chunkVisible;
+
+    void buildChunks();
+    const Block& getChunkBlock(const ChunkBlock& block) const;
     
 public:
     Map();
@@ -25,6 +42,9 @@ public:
     const Ground& getBackGround() const { return backGround; }
     const Wall& getWall() const { return surroundingWall; }
     
-    void render() const;
+    // ü  ϳ ģ ûũ ϸ ִ´ ( ȭ  θ  )
+    void render(Render::DrawList& out, const FrustumSet& frustums) const;
+
+    size_t getBlockCount() const;
 };
 
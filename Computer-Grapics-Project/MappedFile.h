@@ -0,0 +1,36 @@
+﻿#pragma once
+#include <cstddef>
+#include <string>
+
+// 파일 하나를 읽기 전용으로 메모리에 매핑한다. 내용은 페이지 단위로 필요할 때 읽히고,
+// 복사 없이 data()를 그대로 GL 업로드나 파서에 넘길 수 있다. 복사는 막고 이동만 된다.
+// 매핑한 파일을 다른 쪽이 바꿀 때는 제자리에 쓰지 말고 새 파일을 써서 바꿔 넣어야 한다
+// (POSIX는 옛 내용이 매핑에 남고, Windows는 매핑된 파일을 바꿔 넣지 못해 실패한다).
+class MappedFile
+{
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 없거나 빈 파일이면 false
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return bytes != nullptr; }
+    const unsigned char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    void swap(MappedFile& other);
+
+    const unsigned char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* file = nullptr;       // HANDLE
+    void* mapping = nullptr;    // HANDLE
+#endif
+};
@@ -0,0 +1,218 @@
+﻿#include "MatchHost.h"
+#include "SimLog.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct MatchReport {
+    int match = 0;
+    int worker = 0;
+    uint16_t port = 0;
+    int clients = 0;
+    TickTiming timing;
+};
+
+// 워커 하나가 자기 경기들을 전부 소유한다. 다른 스레드와 공유하는 것은
+// 주기적으로 복사해 두는 보고서뿐이고, 그것도 워커별 뮤텍스로 보호한다.
+class MatchWorker
+{
+public:
+    MatchWorker(int index, const MatchHostConfig& config, std::vector<int> matches)
+        : index(index), config(config), matchIndices(std::move(matches)) {
+    }
+
+    void start() {
+        running = true;
+        thread = std::thread(&MatchWorker::run, this);
+    }
+
+    void stop() {
+        running = false;
+        if (thread.joinable()) thread.join();
+    }
+
+    void collect(std::vector<MatchReport>& out, double& busy, double& elapsed) {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        out.insert(out.end(), reports.begin(), reports.end());
+        busy = busySeconds;
+        elapsed = elapsedSeconds;
+    }
+
+private:
+    void run() {
+        SimLog::Mute mute;
+        Profiler::setThreadName("worker " + std::to_string(index));
+
+        // 경기 상태는 이 스레드에서 만들어 이 스레드에서만 만진다
+        std::vector<std::unique_ptr<GameServer>> servers;
+        for (int match : matchIndices) {
+            std::unique_ptr<GameServer> server(new GameServer());
+            uint16_t port = config.basePort ? static_cast<uint16_t>(config.basePort + match) : 0;
+            if (!server->start(port, config.conditions)) continue;
+            server->setBotsEnabled(config.bots, static_cast<unsigned int>(match));
+            server->setInterestConfig(config.interest);
+            servers.push_back(std::move(server));
+        }
+
+        double start = Net::now();
+        double nextTick = start;
+        double lastReport = 0.0;
+        double busy = 0.0;
+        while (running) {
+            double frameStart = Net::now();
+            {
+                PROFILE_SCOPE("worker.update");
+                for (auto& server : servers) server->update();
+            }
+            busy += Net::now() - frameStart;
+
+            if (Net::now() - lastReport >= 1.0) {
+                std::vector<MatchReport> snapshot;
+                for (size_t i = 0; i < servers.size(); ++i) {
+                    MatchReport r;
+                    r.match = matchIndices[i];
+                    r.worker = index;
+                    r.port = servers[i]->getPort();
+                    r.clients = servers[i]->getClientCount();
+                    r.timing = servers[i]->getTickTiming();
+                    snapshot.push_back(r);
+                }
+                std::lock_guard<std::mutex> lock(reportMutex);
+                reports.swap(snapshot);
+                busySeconds = busy;
+                elapsedSeconds = Net::now() - start;
+                lastReport = Net::now();
+            }
+
+            nextTick += TICK_DELTA_TIME;
+            double wait = nextTick - Net::now();
+            if (wait > 0.0) Net::sleepMs(static_cast<int>(wait * 1000.0));
+            else if (wait < -0.25) nextTick = Net::now();   // 과부하: 따라잡기 포기
+        }
+
+        for (auto& server : servers) server->stop();
+    }
+
+    int index;
+    const MatchHostConfig& config;
+    std::vector<int> matchIndices;
+    std::thread thread;
+    std::atomic<bool> running{ false };
+
+    std::mutex reportMutex;
+    std::vector<MatchReport> reports;
+    double busySeconds = 0.0;
+    double elapsedSeconds = 0.0;
+};
+
+void writeTimingCsv(const std::string& path, const std::vector<MatchReport>& reports)
+{
+    std::ofstream out(path.c_str());
+    if (!out) {
+        std::cerr << "타이밍 파일 저장 실패: " << path << std::endl;
+        return;
+    }
+    out << "match,worker,port,clients,ticks,avg_us,p99_us,max_us,over_budget\n";
+    for (const auto& r : reports) {
+        out << r.match << "," << r.worker << "," << r.port << "," << r.clients << "," << r.timing.ticks << ","
+            << r.timing.average() * 1e6 << "," << r.timing.percentile(0.99) * 1e6 << ","
+            << r.timing.maxSeconds * 1e6 << "," << r.timing.overBudget << "\n";
+    }
+}
+
+} // namespace
+
+int runMatchHost(const MatchHostConfig& config)
+{
+    Init::graphicsEnabled() = false;
+    if (!Net::initialize()) return 1;
+
+    int workerCount = config.workerCount > 0 ? config.workerCount : static_cast<int>(std::thread::hardware_concurrency());
+    workerCount = std::max(1, std::min(workerCount, config.matchCount));
+
+    // 경기 i는 워커 i % workerCount가 맡는다
+    std::vector<std::vector<int>> assignments(workerCount);
+    for (int i = 0; i < config.matchCount; ++i) assignments[i % workerCount].push_back(i);
+
+    std::vector<std::unique_ptr<MatchWorker>> workers;
+    for (int w = 0; w < workerCount; ++w) {
+        workers.push_back(std::unique_ptr<MatchWorker>(new MatchWorker(w, config, assignments[w])));
+        workers.back()->start();
+    }
+    std::cout << "경기 " << config.matchCount << "개, 워커 " << workerCount << "개 시작 (포트 "
+        << config.basePort << "~" << config.basePort + config.matchCount - 1 << ")" << std::endl;
+
+    double start = Net::now();
+    double lastPrint = start;
+    std::vector<MatchReport> reports;
+    while (config.seconds <= 0.0f || Net::now() - start < config.seconds) {
+        Net::sleepMs(250);
+        Profiler::updateCapture();
+        if (Net::now() - lastPrint < 5.0) continue;
+        lastPrint = Net::now();
+
+        reports.clear();
+        double busyMax = 0.0;
+        for (auto& worker : workers) {
+            double busy = 0.0, elapsed = 0.0;
+            worker->collect(reports, busy, elapsed);
+            if (elapsed > 0.0) busyMax = std::max(busyMax, busy / elapsed);
+        }
+
+        uint64_t ticks = 0;
+        int clients = 0;
+        double worstP99 = 0.0;
+        uint32_t overBudget = 0;
+        for (const auto& r : reports) {
+            ticks += r.timing.ticks;
+            clients += r.clients;
+            worstP99 = std::max(worstP99, r.timing.percentile(0.99));
+            overBudget += r.timing.overBudget;
+        }
+        std::cout << "[호스트] 경기 " << reports.size() << ", 접속 " << clients << ", 초당 틱 "
+            << ticks / (Net::now() - start) << ", 최악 p99 " << worstP99 * 1e6 << "us, 예산 초과 " << overBudget
+            << ", 가장 바쁜 워커 " << busyMax * 100.0 << "%" << std::endl;
+        writeTimingCsv(config.timingCsvPath, reports);
+    }
+
+    for (auto& worker : workers) worker->stop();
+    Profiler::finishCapture();
+
+    reports.clear();
+    double busySum = 0.0, elapsedSum = 0.0;
+    for (auto& worker : workers) {
+        double busy = 0.0, elapsed = 0.0;
+        worker->collect(reports, busy, elapsed);
+        busySum += busy;
+        elapsedSum += elapsed;
+    }
+    std::sort(reports.begin(), reports.end(), [](const MatchReport& a, const MatchReport& b) { return a.match < b.match; });
+    writeTimingCsv(config.timingCsvPath, reports);
+
+    TickTiming total;
+    for (const auto& r : reports) {
+        total.ticks += r.timing.ticks;
+        total.totalSeconds += r.timing.totalSeconds;
+        total.maxSeconds = std::max(total.maxSeconds, r.timing.maxSeconds);
+        total.overBudget += r.timing.overBudget;
+        for (int i = 0; i < TickTiming::BUCKET_COUNT; ++i) total.histogram[i] += r.timing.histogram[i];
+    }
+    double elapsed = Net::now() - start;
+    std::cout << "\n=== 멀티 경기 서버 종료 (" << elapsed << "초) ===" << std::endl;
+    std::cout << "경기 " << reports.size() << "개, 총 틱 " << total.ticks << " (경기당 초당 "
+        << (reports.empty() ? 0.0 : total.ticks / elapsed / reports.size()) << ")" << std::endl;
+    std::cout << "틱 비용: 평균 " << total.average() * 1e6 << "us, p99 " << total.percentile(0.99) * 1e6
+        << "us, 최대 " << total.maxSeconds * 1e6 << "us, 예산 초과 " << total.overBudget << std::endl;
+    std::cout << "워커 평균 사용률 " << (elapsedSum > 0.0 ? busySum / elapsedSum * 100.0 : 0.0) << "%" << std::endl;
+    std::cout << "경기별 타이밍: " << config.timingCsvPath << std::endl;
+
+    Net::shutdown();
+    return 0;
+}
@@ -0,0 +1,18 @@
+﻿#pragma once
+#include <string>
+#include "NetGame.h"
+
+// 한 프로세스에서 여러 경기를 동시에 돌리는 서버 설정.
+// 경기 i는 basePort + i 포트를 쓰고, 경기들은 워커 스레드에 고르게 나뉜다.
+struct MatchHostConfig {
+    int matchCount = 1;
+    int workerCount = 0;                 // 0이면 하드웨어 스레드 수
+    uint16_t basePort = DEFAULT_SERVER_PORT;
+    NetConditions conditions;
+    bool bots = false;                   // 빈 자리를 봇으로 채움
+    InterestConfig interest;             // 관심 영역 복제 (기본 꺼짐)
+    float seconds = 0.0f;                // 0이면 계속 실행
+    std::string timingCsvPath = "match_timing.csv";
+};
+
+int runMatchHost(const MatchHostConfig& config);
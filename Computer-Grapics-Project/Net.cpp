@@ -0,0 +1,284 @@
+﻿#include "Net.h"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef int socklen_t;
+typedef SOCKET NativeSocket;
+static const intptr_t INVALID_HANDLE = (intptr_t)INVALID_SOCKET;
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+typedef int NativeSocket;
+static const intptr_t INVALID_HANDLE = -1;
+#endif
+
+static NativeSocket native(intptr_t handle)
+{
+    return static_cast<NativeSocket>(handle);
+}
+
+bool Net::initialize()
+{
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "WSAStartup 실패" << std::endl;
+        return false;
+    }
+#endif
+    return true;
+}
+
+void Net::shutdown()
+{
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+double Net::now()
+{
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+void Net::sleepMs(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+bool NetAddress::parse(const std::string& text, uint16_t defaultPort, NetAddress& out)
+{
+    std::string host = text;
+    uint16_t port = defaultPort;
+    size_t colon = text.rfind(':');
+    if (colon != std::string::npos) {
+        host = text.substr(0, colon);
+        port = static_cast<uint16_t>(std::atoi(text.c_str() + colon + 1));
+    }
+    if (host.empty() || host == "localhost") host = "127.0.0.1";
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        return false;
+    }
+    const sockaddr_in* sin = reinterpret_cast<const sockaddr_in*>(result->ai_addr);
+    out.ip = ntohl(sin->sin_addr.s_addr);
+    out.port = port;
+    freeaddrinfo(result);
+    return true;
+}
+
+std::string NetAddress::toString() const
+{
+    return std::to_string((ip >> 24) & 0xFF) + "." + std::to_string((ip >> 16) & 0xFF) + "." +
+        std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF) + ":" + std::to_string(port);
+}
+
+UdpSocket::UdpSocket() : handle(INVALID_HANDLE), rng(12345)
+{
+}
+
+UdpSocket::~UdpSocket()
+{
+    close();
+}
+
+bool UdpSocket::open(uint16_t port)
+{
+    close();
+
+    handle = (intptr_t)socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == INVALID_HANDLE) {
+        std::cerr << "UDP 소켓 생성 실패" << std::endl;
+        return false;
+    }
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(native(handle), reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cerr << "UDP 포트 바인드 실패: " << port << std::endl;
+        close();
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    getsockname(native(handle), reinterpret_cast<sockaddr*>(&addr), &len);
+    localPort = ntohs(addr.sin_port);
+
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(native(handle), FIONBIO, &nonBlocking);
+#else
+    fcntl(native(handle), F_SETFL, O_NONBLOCK);
+#endif
+    return true;
+}
+
+void UdpSocket::close()
+{
+    if (handle == INVALID_HANDLE) return;
+#ifdef _WIN32
+    closesocket(native(handle));
+#else
+    ::close(native(handle));
+#endif
+    handle = INVALID_HANDLE;
+    delayed.clear();
+}
+
+bool UdpSocket::isOpen() const
+{
+    return handle != INVALID_HANDLE;
+}
+
+bool UdpSocket::send(const NetAddress& to, const uint8_t* data, size_t size)
+{
+    if (!isOpen()) return false;
+
+    if (!conditions.enabled()) {
+        return sendNow(to, data, size);
+    }
+
+    std::uniform_real_distribution<float> chance(0.0f, 100.0f);
+    if (chance(rng) < conditions.lossPercent) {
+        bytesSent += size;
+        return true;
+    }
+
+    double delay = conditions.latencyMs / 1000.0;
+    if (conditions.jitterMs > 0) {
+        std::uniform_int_distribution<int> jitter(0, conditions.jitterMs);
+        delay += jitter(rng) / 1000.0;
+    }
+
+    DelayedPacket packet;
+    packet.sendTime = Net::now() + delay;
+    packet.to = to;
+    packet.data.assign(data, data + size);
+
+    // 지터가 있어도 도착 순서가 섞이도록 정렬 삽입
+    auto it = std::upper_bound(delayed.begin(), delayed.end(), packet.sendTime,
+        [](double t, const DelayedPacket& p) { return t < p.sendTime; });
+    delayed.insert(it, std::move(packet));
+    bytesSent += size;
+    return true;
+}
+
+void UdpSocket::flush()
+{
+    double t = Net::now();
+    while (!delayed.empty() && delayed.front().sendTime <= t) {
+        const DelayedPacket& p = delayed.front();
+        sendNow(p.to, p.data.data(), p.data.size());
+        delayed.pop_front();
+    }
+}
+
+bool UdpSocket::sendNow(const NetAddress& to, const uint8_t* data, size_t size)
+{
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(to.ip);
+    addr.sin_port = htons(to.port);
+
+    int sent = sendto(native(handle), reinterpret_cast<const char*>(data), (int)size, 0,
+        reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    if (!conditions.enabled()) bytesSent += size;
+    return sent == (int)size;
+}
+
+int UdpSocket::receive(NetAddress& from, uint8_t* buffer, size_t capacity)
+{
+    if (!isOpen()) return 0;
+
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    int received = recvfrom(native(handle), reinterpret_cast<char*>(buffer), (int)capacity, 0,
+        reinterpret_cast<sockaddr*>(&addr), &len);
+    if (received <= 0) return 0;
+
+    from.ip = ntohl(addr.sin_addr.s_addr);
+    from.port = ntohs(addr.sin_port);
+    bytesReceived += received;
+    return received;
+}
+
+void BitWriter::writeBits(uint32_t value, int bits)
+{
+    for (int i = 0; i < bits; ++i) {
+        if ((bitPos & 7) == 0) bytes.push_back(0);
+        if (value & (1u << i)) bytes.back() |= static_cast<uint8_t>(1u << (bitPos & 7));
+        ++bitPos;
+    }
+}
+
+void BitWriter::writeFloat(float value, float minValue, float maxValue, int bits)
+{
+    uint32_t maxInt = (bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1);
+    float t = (value - minValue) / (maxValue - minValue);
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    writeBits(static_cast<uint32_t>(std::lround(t * maxInt)), bits);
+}
+
+void BitWriter::writeSigned(int value, int bits)
+{
+    // 범위를 넘으면 감싸지 않고 끝값으로 (writeFloat와 같이)
+    int half = 1 << (bits - 1);
+    value = std::min(std::max(value, -half), half - 1);
+    writeBits(static_cast<uint32_t>(value + half), bits);
+}
+
+uint32_t BitReader::readBits(int bits)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < bits; ++i) {
+        if ((bitPos >> 3) >= size) {
+            overflow = true;
+            return 0;
+        }
+        if (data[bitPos >> 3] & (1u << (bitPos & 7))) value |= (1u << i);
+        ++bitPos;
+    }
+    return value;
+}
+
+float BitReader::readFloat(float minValue, float maxValue, int bits)
+{
+    uint32_t maxInt = (bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1);
+    return minValue + (maxValue - minValue) * (static_cast<float>(readBits(bits)) / maxInt);
+}
+
+int BitReader::readSigned(int bits)
+{
+    return static_cast<int>(readBits(bits)) - (1 << (bits - 1));
+}
+
+float quantizeFloat(float value, float minValue, float maxValue, int bits)
+{
+    uint32_t maxInt = (1u << bits) - 1;
+    float t = (value - minValue) / (maxValue - minValue);
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    return minValue + (maxValue - minValue) * (static_cast<float>(std::lround(t * maxInt)) / maxInt);
+}
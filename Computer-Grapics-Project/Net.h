@@ -0,0 +1,126 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <random>
+
+// UDP 주소 (IPv4, 호스트 바이트 순서)
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    NetAddress() {}
+    NetAddress(uint32_t ip, uint16_t port) : ip(ip), port(port) {}
+
+    static bool parse(const std::string& text, uint16_t defaultPort, NetAddress& out);
+    std::string toString() const;
+
+    bool operator==(const NetAddress& o) const { return ip == o.ip && port == o.port; }
+    bool operator!=(const NetAddress& o) const { return !(*this == o); }
+    bool operator<(const NetAddress& o) const { return ip != o.ip ? ip < o.ip : port < o.port; }
+};
+
+// 지연/손실을 인위적으로 주입하는 송신 큐 (로컬 루프백 테스트용)
+struct NetConditions {
+    int latencyMs = 0;
+    int jitterMs = 0;
+    float lossPercent = 0.0f;
+
+    bool enabled() const { return latencyMs > 0 || jitterMs > 0 || lossPercent > 0.0f; }
+};
+
+class UdpSocket
+{
+public:
+    UdpSocket();
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // port가 0이면 임의 포트에 바인드
+    bool open(uint16_t port);
+    void close();
+    bool isOpen() const;
+    uint16_t getLocalPort() const { return localPort; }
+
+    void setConditions(const NetConditions& c) { conditions = c; }
+
+    bool send(const NetAddress& to, const uint8_t* data, size_t size);
+    // 받은 바이트 수, 없으면 0
+    int receive(NetAddress& from, uint8_t* buffer, size_t capacity);
+
+    // 지연 큐에 쌓인 패킷 중 보낼 시간이 된 것을 전송
+    void flush();
+
+    uint64_t getBytesSent() const { return bytesSent; }
+    uint64_t getBytesReceived() const { return bytesReceived; }
+
+private:
+    struct DelayedPacket {
+        double sendTime;
+        NetAddress to;
+        std::vector<uint8_t> data;
+    };
+
+    bool sendNow(const NetAddress& to, const uint8_t* data, size_t size);
+
+    intptr_t handle;
+    uint16_t localPort = 0;
+    NetConditions conditions;
+    std::deque<DelayedPacket> delayed;
+    std::mt19937 rng;
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+};
+
+namespace Net {
+    bool initialize();
+    void shutdown();
+    double now();   // 초 단위 단조 시간
+    void sleepMs(int ms);
+}
+
+// 비트 단위 직렬화
+class BitWriter
+{
+public:
+    void writeBits(uint32_t value, int bits);
+    void writeBool(bool b) { writeBits(b ? 1 : 0, 1); }
+    // [minValue, maxValue] 범위를 bits 비트로 양자화
+    void writeFloat(float value, float minValue, float maxValue, int bits);
+    // [-2^(bits-1), 2^(bits-1)-1] 밖의 값은 끝값으로 자른다
+    void writeSigned(int value, int bits);
+
+    const std::vector<uint8_t>& data() const { return bytes; }
+    size_t bitCount() const { return bitPos; }
+    size_t byteCount() const { return (bitPos + 7) / 8; }
+    void clear() { bytes.clear(); bitPos = 0; }
+
+private:
+    std::vector<uint8_t> bytes;
+    size_t bitPos = 0;
+};
+
+class BitReader
+{
+public:
+    BitReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    uint32_t readBits(int bits);
+    bool readBool() { return readBits(1) != 0; }
+    float readFloat(float minValue, float maxValue, int bits);
+    int readSigned(int bits);
+
+    // 패킷 끝을 넘어 읽으면 true (잘린 패킷)
+    bool overflowed() const { return overflow; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t bitPos = 0;
+    bool overflow = false;
+};
+
+float quantizeFloat(float value, float minValue, float maxValue, int bits);
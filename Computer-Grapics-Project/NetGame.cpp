@@ -0,0 +1,1035 @@
+﻿#include "NetGame.h"
+#include "Steve.h"
+#include "Alex.h"
+#include "SimLog.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const uint32_t PROTOCOL_ID = 0x534E4F57; // 'SNOW'
+const float PI = 3.14159265359f;
+
+// values가지 값을 담는 데 필요한 비트 수
+constexpr int bitsFor(uint32_t values)
+{
+    int bits = 1;
+    while (bits < 32 && (static_cast<uint32_t>(1) << bits) < values) ++bits;
+    return bits;
+}
+
+// 양자화 범위: 맵 (MAP_WIDTH x MAP_DEPTH 블록)에 벽 밖으로 튕겨 나간 눈덩이 몫의 여유를 더한다.
+// 높이는 벽 5단 위로 던진 포물선까지. 맵 크기가 바뀌면 범위와 비트 수가 같이 따라간다.
+constexpr float POS_MARGIN = 6.0f * BLOCK_SIZE;
+constexpr float POS_MIN_X = -POS_MARGIN, POS_MAX_X = MAP_WIDTH * BLOCK_SIZE + POS_MARGIN;
+constexpr float POS_MIN_Y = -2.0f * BLOCK_SIZE, POS_MAX_Y = 14.0f * BLOCK_SIZE;
+constexpr float POS_MIN_Z = -POS_MARGIN, POS_MAX_Z = MAP_DEPTH * BLOCK_SIZE + POS_MARGIN;
+constexpr float POS_STEPS_PER_UNIT = 2048.0f;   // 약 0.5mm 단위
+constexpr int POS_BITS_X = bitsFor(static_cast<uint32_t>((POS_MAX_X - POS_MIN_X) * POS_STEPS_PER_UNIT) + 1);
+constexpr int POS_BITS_Y = bitsFor(static_cast<uint32_t>((POS_MAX_Y - POS_MIN_Y) * POS_STEPS_PER_UNIT) + 1);
+constexpr int POS_BITS_Z = bitsFor(static_cast<uint32_t>((POS_MAX_Z - POS_MIN_Z) * POS_STEPS_PER_UNIT) + 1);
+constexpr int POS_BITS = POS_BITS_X + POS_BITS_Y + POS_BITS_Z;
+static_assert(POS_BITS_X <= 24 && POS_BITS_Y <= 24 && POS_BITS_Z <= 24, "맵이 너무 커서 위치를 양자화할 수 없다");
+
+// 눈 칸 좌표는 맵 안 (0..MAP_WIDTH-1, 0..MAP_DEPTH-1)이므로 부호 없이 맵 크기만큼의 비트로 보낸다
+constexpr int CELL_BITS_X = bitsFor(MAP_WIDTH);
+constexpr int CELL_BITS_Z = bitsFor(MAP_DEPTH);
+static_assert(CELL_BITS_X + CELL_BITS_Z <= 24, "맵이 너무 커서 눈 칸 좌표를 보낼 수 없다");
+const float VEL_RANGE = 32.0f;
+const float ANGLE_RANGE = 4.0f;
+const double CLIENT_TIMEOUT = 5.0;
+const double FINISH_RESTART_SECONDS = 3.0;
+const float SNOWBALL_LEAD_SMOOTHING = 0.1f;     // 스냅샷마다 앞선 틱 수를 따라가는 비율
+const float SNOWBALL_ERROR_KEEP = 0.5f;         // 눈덩이 위치 차이를 틱마다 이만큼 남긴다 (3틱이면 1/8)
+const float SNOWBALL_SNAP_DISTANCE = 2.0f * BLOCK_SIZE;  // 이보다 멀면 섞지 않고 바로 옮긴다
+
+bool seqNewer(uint16_t a, uint16_t b)
+{
+    return static_cast<int16_t>(a - b) > 0;
+}
+
+void writeVec3(BitWriter& w, const glm::vec3& v)
+{
+    w.writeFloat(v.x, POS_MIN_X, POS_MAX_X, POS_BITS_X);
+    w.writeFloat(v.y, POS_MIN_Y, POS_MAX_Y, POS_BITS_Y);
+    w.writeFloat(v.z, POS_MIN_Z, POS_MAX_Z, POS_BITS_Z);
+}
+
+glm::vec3 readVec3(BitReader& r)
+{
+    glm::vec3 v;
+    v.x = r.readFloat(POS_MIN_X, POS_MAX_X, POS_BITS_X);
+    v.y = r.readFloat(POS_MIN_Y, POS_MAX_Y, POS_BITS_Y);
+    v.z = r.readFloat(POS_MIN_Z, POS_MAX_Z, POS_BITS_Z);
+    return v;
+}
+
+void writeCharacter(BitWriter& w, const CharacterState& s)
+{
+    writeVec3(w, s.pos);
+    w.writeSigned(static_cast<int>(s.moveDir.x), 2);
+    w.writeSigned(static_cast<int>(s.moveDir.y), 2);
+    w.writeBits(s.armState, 2);
+    w.writeFloat(s.armAngle, -ANGLE_RANGE, ANGLE_RANGE, 12);
+    w.writeBool(s.armDir > 0.0f);
+    w.writeBits(s.legState, 1);
+    w.writeFloat(s.legAngle, -ANGLE_RANGE, ANGLE_RANGE, 12);
+    w.writeBool(s.legDir > 0.0f);
+}
+
+CharacterState readCharacter(BitReader& r)
+{
+    CharacterState s;
+    s.pos = readVec3(r);
+    s.moveDir.x = static_cast<float>(r.readSigned(2));
+    s.moveDir.y = static_cast<float>(r.readSigned(2));
+    s.armState = static_cast<GLint>(r.readBits(2));
+    s.armAngle = r.readFloat(-ANGLE_RANGE, ANGLE_RANGE, 12);
+    s.armDir = r.readBool() ? 1.0f : -1.0f;
+    s.legState = static_cast<GLint>(r.readBits(1));
+    s.legAngle = r.readFloat(-ANGLE_RANGE, ANGLE_RANGE, 12);
+    s.legDir = r.readBool() ? 1.0f : -1.0f;
+    return s;
+}
+
+void writePlayer(BitWriter& w, const NetPlayerState& p)
+{
+    w.writeBool(p.charging);
+    w.writeBool(p.throwHeld);
+    w.writeBits(static_cast<uint32_t>(p.chargeTicks), 7);
+}
+
+NetPlayerState readPlayer(BitReader& r)
+{
+    NetPlayerState p;
+    p.charging = r.readBool();
+    p.throwHeld = r.readBool();
+    p.chargeTicks = static_cast<int>(r.readBits(7));
+    return p;
+}
+
+void writeSnowball(BitWriter& w, const NetSnowball& s)
+{
+    writeVec3(w, s.pos);
+    w.writeFloat(s.vel.x, -VEL_RANGE, VEL_RANGE, 14);
+    w.writeFloat(s.vel.y, -VEL_RANGE, VEL_RANGE, 14);
+    w.writeFloat(s.vel.z, -VEL_RANGE, VEL_RANGE, 14);
+}
+
+NetSnowball readSnowball(BitReader& r)
+{
+    NetSnowball s;
+    s.pos = readVec3(r);
+    s.vel.x = r.readFloat(-VEL_RANGE, VEL_RANGE, 14);
+    s.vel.y = r.readFloat(-VEL_RANGE, VEL_RANGE, 14);
+    s.vel.z = r.readFloat(-VEL_RANGE, VEL_RANGE, 14);
+    return s;
+}
+
+} // namespace
+
+void writePacketHeader(BitWriter& w, NetPacketType type)
+{
+    w.writeBits(PROTOCOL_ID, 32);
+    w.writeBits(type, 3);
+}
+
+bool readPacketHeader(BitReader& r, uint32_t& type)
+{
+    if (r.readBits(32) != PROTOCOL_ID) return false;
+    type = r.readBits(3);
+    return !r.overflowed();
+}
+
+void writePlayerInput(BitWriter& w, const PlayerInput& in)
+{
+    w.writeSigned(static_cast<int>(in.moveDir.x), 2);
+    w.writeSigned(static_cast<int>(in.moveDir.y), 2);
+    w.writeBool(in.throwHeld);
+    float yaw = std::atan2(in.aim.z, in.aim.x);
+    float pitch = std::asin(std::min(std::max(in.aim.y, -1.0f), 1.0f));
+    w.writeFloat(yaw, -PI, PI, 12);
+    w.writeFloat(pitch, -PI / 2.0f, PI / 2.0f, 11);
+}
+
+PlayerInput readPlayerInput(BitReader& r)
+{
+    PlayerInput in;
+    in.moveDir.x = static_cast<float>(r.readSigned(2));
+    in.moveDir.y = static_cast<float>(r.readSigned(2));
+    in.throwHeld = r.readBool();
+    float yaw = r.readFloat(-PI, PI, 12);
+    float pitch = r.readFloat(-PI / 2.0f, PI / 2.0f, 11);
+    in.aim = glm::vec3(std::cos(pitch) * std::cos(yaw), std::sin(pitch), std::cos(pitch) * std::sin(yaw));
+    return in;
+}
+
+namespace {
+
+// 인코딩 후 다시 읽어서 양쪽이 똑같이 갖게 될 양자화 값을 얻는다
+template <typename T, typename W, typename R>
+T roundTrip(const T& value, W writeFn, R readFn)
+{
+    BitWriter w;
+    writeFn(w, value);
+    BitReader r(w.data().data(), w.byteCount());
+    return readFn(r);
+}
+
+bool sameCharacter(const CharacterState& a, const CharacterState& b)
+{
+    return a.pos == b.pos && a.moveDir == b.moveDir && a.armState == b.armState &&
+        a.armAngle == b.armAngle && a.armDir == b.armDir && a.legState == b.legState &&
+        a.legAngle == b.legAngle && a.legDir == b.legDir;
+}
+
+bool samePlayer(const NetPlayerState& a, const NetPlayerState& b)
+{
+    return a.charging == b.charging && a.throwHeld == b.throwHeld && a.chargeTicks == b.chargeTicks;
+}
+
+} // namespace
+
+NetView buildNetView(const GameWorld& world)
+{
+    NetView view;
+    view.tick = world.tickCount;
+    view.winner = static_cast<uint8_t>(world.winner);
+
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        view.characters[i] = roundTrip(world.getCharacterState(i), writeCharacter, readCharacter);
+
+        const PlayerState& ps = world.players[i];
+        NetPlayerState p;
+        p.charging = ps.charging;
+        p.throwHeld = ps.throwHeld;
+        p.chargeTicks = ps.charging ? static_cast<int>(std::min(world.tickCount - ps.chargeStartTick, 127u)) : 0;
+        view.players[i] = p;
+    }
+
+    for (const auto& sb : world.snowballs) {
+        if (!sb.getIsActive()) continue;
+        NetSnowball s;
+        s.pos = sb.getPosition();
+        s.vel = sb.getVelocity();
+        view.snowballs[sb.getId()] = roundTrip(s, writeSnowball, readSnowball);
+        view.snowballs[sb.getId()].tick = world.tickCount;
+    }
+
+    for (const auto& cell : world.snowSystem.getSnowData()) {
+        // 맵 밖 칸은 생기지 않지만 생기더라도 CELL_BITS로 좌표를 담을 수 없으므로 보내지 않는다
+        const std::pair<int, int>& key = cell.first;
+        if (key.first < 0 || key.first >= MAP_WIDTH || key.second < 0 || key.second >= MAP_DEPTH) continue;
+        int steps = static_cast<int>(std::lround(cell.second.targetHeight / 0.5f));
+        if (steps > 0) view.snow[cell.first] = std::min(steps, 7);
+    }
+    return view;
+}
+
+void encodeNetViewDelta(BitWriter& w, const NetView& base, const NetView& target, NetView& sent,
+    size_t budgetBytes, const NetViewOrder* order)
+{
+    // 예산은 패킷 전체다 (w에 이미 쓴 헤더 포함). 캐릭터와 플레이어는 크기가 정해져 있고 언제나 보내므로
+    // 먼저 쓰고, 그 뒤 목록은 남은 비트에 들어가는 만큼만 보낸다. 못 보낸 항목은 sent에 반영하지 않아서
+    // 다음 스냅샷이 다시 보낸다.
+    const size_t budgetBits = budgetBytes * 8;
+    const size_t countBits = 8;             // 목록마다 앞에 붙는 개수 필드
+    sent = base;
+    sent.tick = target.tick;
+    sent.winner = target.winner;
+
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        bool changed = !sameCharacter(base.characters[i], target.characters[i]);
+        w.writeBool(changed);
+        if (changed) writeCharacter(w, target.characters[i]);
+        sent.characters[i] = target.characters[i];
+    }
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        bool changed = !samePlayer(base.players[i], target.players[i]);
+        w.writeBool(changed);
+        if (changed) writePlayer(w, target.players[i]);
+        sent.players[i] = target.players[i];
+    }
+
+    // 사라진 눈덩이: 크기가 작으니 먼저 보낸다. 뒤 두 목록의 개수 필드 자리는 남겨 둔다.
+    std::vector<uint16_t> removed;
+    for (const auto& s : base.snowballs) {
+        if (target.snowballs.find(s.first) == target.snowballs.end()) removed.push_back(s.first);
+    }
+    size_t removedCount = 0;
+    while (removedCount < removed.size() && removedCount < 255 &&
+        w.bitCount() + countBits + (removedCount + 1) * 16 + 2 * countBits <= budgetBits) {
+        ++removedCount;
+    }
+    w.writeBits(static_cast<uint32_t>(removedCount), 8);
+    for (size_t i = 0; i < removedCount; ++i) {
+        w.writeBits(removed[i], 16);
+        sent.snowballs.erase(removed[i]);
+    }
+
+    const size_t snowballBits = 16 + POS_BITS + 42;
+    const size_t cellBits = CELL_BITS_X + CELL_BITS_Z + 3;
+
+    // 순서가 주어지면 그 순서대로, 그 안에 있는 항목만 보낸다 (관심 영역 우선순위)
+    std::vector<std::pair<uint16_t, NetSnowball>> added;
+    if (order) {
+        for (uint16_t id : order->snowballs) {
+            auto it = target.snowballs.find(id);
+            if (it != target.snowballs.end() && base.snowballs.find(id) == base.snowballs.end()) added.push_back(*it);
+        }
+    }
+    else {
+        for (const auto& s : target.snowballs) {
+            if (base.snowballs.find(s.first) == base.snowballs.end()) added.push_back(s);
+        }
+    }
+    size_t addedCount = 0;
+    while (addedCount < added.size() && addedCount < 255 &&
+        w.bitCount() + countBits + (addedCount + 1) * snowballBits + countBits <= budgetBits) {
+        ++addedCount;
+    }
+    w.writeBits(static_cast<uint32_t>(addedCount), 8);
+    for (size_t i = 0; i < addedCount; ++i) {
+        w.writeBits(added[i].first, 16);
+        writeSnowball(w, added[i].second);
+        sent.snowballs[added[i].first] = added[i].second;
+    }
+
+    std::vector<std::pair<std::pair<int, int>, int>> cells;
+    if (order) {
+        for (const auto& key : order->cells) {
+            auto t = target.snow.find(key);
+            auto b = base.snow.find(key);
+            int targetSteps = (t == target.snow.end()) ? 0 : t->second;
+            int baseSteps = (b == base.snow.end()) ? 0 : b->second;
+            if (targetSteps != baseSteps) cells.push_back(std::make_pair(key, targetSteps));
+        }
+    }
+    else {
+        for (const auto& c : target.snow) {
+            auto it = base.snow.find(c.first);
+            if (it == base.snow.end() || it->second != c.second) cells.push_back(c);
+        }
+        for (const auto& c : base.snow) {
+            if (target.snow.find(c.first) == target.snow.end()) cells.push_back(std::make_pair(c.first, 0));
+        }
+    }
+    size_t cellCount = 0;
+    while (cellCount < cells.size() && cellCount < 255 &&
+        w.bitCount() + countBits + (cellCount + 1) * cellBits <= budgetBits) {
+        ++cellCount;
+    }
+    w.writeBits(static_cast<uint32_t>(cellCount), 8);
+    for (size_t i = 0; i < cellCount; ++i) {
+        w.writeBits(static_cast<uint32_t>(cells[i].first.first), CELL_BITS_X);
+        w.writeBits(static_cast<uint32_t>(cells[i].first.second), CELL_BITS_Z);
+        w.writeBits(static_cast<uint32_t>(cells[i].second), 3);
+        if (cells[i].second > 0) sent.snow[cells[i].first] = cells[i].second;
+        else sent.snow.erase(cells[i].first);
+    }
+}
+
+bool decodeNetViewDelta(BitReader& r, const NetView& base, NetView& view)
+{
+    uint32_t tick = view.tick;
+    uint8_t winner = view.winner;
+    view = base;
+    view.tick = tick;
+    view.winner = winner;
+
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        if (r.readBool()) view.characters[i] = readCharacter(r);
+    }
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        if (r.readBool()) view.players[i] = readPlayer(r);
+    }
+
+    uint32_t removedCount = r.readBits(8);
+    for (uint32_t i = 0; i < removedCount; ++i) {
+        view.snowballs.erase(static_cast<uint16_t>(r.readBits(16)));
+    }
+    uint32_t addedCount = r.readBits(8);
+    for (uint32_t i = 0; i < addedCount; ++i) {
+        uint16_t id = static_cast<uint16_t>(r.readBits(16));
+        view.snowballs[id] = readSnowball(r);
+        view.snowballs[id].tick = tick;
+    }
+    uint32_t cellCount = r.readBits(8);
+    for (uint32_t i = 0; i < cellCount; ++i) {
+        int gx = static_cast<int>(r.readBits(CELL_BITS_X));
+        int gz = static_cast<int>(r.readBits(CELL_BITS_Z));
+        int steps = static_cast<int>(r.readBits(3));
+        if (steps > 0) view.snow[std::make_pair(gx, gz)] = steps;
+        else view.snow.erase(std::make_pair(gx, gz));
+    }
+    return !r.overflowed();
+}
+
+void applyNetViewObjects(GameWorld& world, const NetView& view, const NetView* previous)
+{
+    // 눈덩이: 새로 생긴 것만 추가하고 사라진 것은 제거
+    world.snowballs.erase(std::remove_if(world.snowballs.begin(), world.snowballs.end(),
+        [&](const Snowball& s) { return view.snowballs.find(s.getId()) == view.snowballs.end(); }),
+        world.snowballs.end());
+    for (const auto& s : view.snowballs) {
+        bool exists = std::any_of(world.snowballs.begin(), world.snowballs.end(),
+            [&](const Snowball& sb) { return sb.getId() == s.first; });
+        if (exists) continue;
+        Snowball sb(s.second.pos, glm::vec3(0, 1, 0), 0.0f, 0.15f);
+        sb.setMotion(s.second.pos, s.second.vel);
+        sb.setId(s.first);
+        world.snowballs.push_back(sb);
+    }
+
+    // 눈: 바뀐 칸만 애니메이션과 함께 반영
+    for (const auto& c : view.snow) {
+        if (previous) {
+            auto it = previous->snow.find(c.first);
+            if (it != previous->snow.end() && it->second == c.second) continue;
+        }
+        world.snowSystem.setTargetHeight(c.first.first, c.first.second, c.second * 0.5f);
+    }
+    if (!previous) return;
+    for (const auto& c : previous->snow) {
+        if (view.snow.find(c.first) == view.snow.end()) {
+            world.snowSystem.setTargetHeight(c.first.first, c.first.second, 0.0f);
+        }
+    }
+}
+
+PlayerInput quantizePlayerInput(const PlayerInput& input)
+{
+    return roundTrip(input, writePlayerInput, readPlayerInput);
+}
+
+//--- 서버
+
+void TickTiming::record(double seconds)
+{
+    ticks++;
+    totalSeconds += seconds;
+    maxSeconds = std::max(maxSeconds, seconds);
+    if (seconds > TICK_DELTA_TIME) overBudget++;
+    int bucket = static_cast<int>(seconds / BUCKET_SECONDS);
+    histogram[std::min(bucket, BUCKET_COUNT - 1)]++;
+}
+
+double TickTiming::percentile(double p) const
+{
+    if (ticks == 0) return 0.0;
+    uint64_t target = static_cast<uint64_t>(std::ceil(ticks * p));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += histogram[i];
+        if (seen >= target) return (i + 1) * BUCKET_SECONDS;
+    }
+    return maxSeconds;
+}
+
+GameServer::GameServer()
+{
+}
+
+void GameServer::setBotsEnabled(bool enabled, unsigned int seed)
+{
+    botsEnabled = enabled;
+    bots.clear();
+    for (int i = 0; i < PLAYER_COUNT; ++i) bots.push_back(InputBot(i, seed * PLAYER_COUNT + i));
+}
+
+bool GameServer::start(uint16_t port, const NetConditions& conditions)
+{
+    if (!socket.open(port)) return false;
+    socket.setConditions(conditions);
+
+    world.initialize();
+    lastTime = Net::now();
+    accumulator = 0.0;
+    SIM_LOG << "서버 시작: 포트 " << socket.getLocalPort() << std::endl;
+    return true;
+}
+
+void GameServer::stop()
+{
+    socket.close();
+    world.reset();
+}
+
+int GameServer::getClientCount() const
+{
+    int count = 0;
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        if (clients[i].connected) ++count;
+    }
+    return count;
+}
+
+double GameServer::getClientBandwidth(int slot) const
+{
+    const ClientSlot& c = clients[slot];
+    double elapsed = Net::now() - c.statsStartTime;
+    if (!c.connected || elapsed <= 0.0) return 0.0;
+    return c.stats.bytesSent / elapsed;
+}
+
+void GameServer::update()
+{
+    double now = Net::now();
+    accumulator += now - lastTime;
+    lastTime = now;
+
+    receivePackets();
+
+    // 너무 밀리면 따라잡기를 포기 (한 번에 최대 5틱)
+    if (accumulator > TICK_DELTA_TIME * 5) accumulator = TICK_DELTA_TIME * 5;
+    while (accumulator >= TICK_DELTA_TIME) {
+        stepTick();
+        accumulator -= TICK_DELTA_TIME;
+    }
+
+    socket.flush();
+}
+
+void GameServer::receivePackets()
+{
+    uint8_t buffer[1500];
+    NetAddress from;
+    int size;
+    while ((size = socket.receive(from, buffer, sizeof(buffer))) > 0) {
+        handlePacket(from, buffer, static_cast<size_t>(size));
+    }
+}
+
+void GameServer::handlePacket(const NetAddress& from, const uint8_t* data, size_t size)
+{
+    BitReader r(data, size);
+    uint32_t type = 0;
+    if (!readPacketHeader(r, type)) return;
+
+    int slot = -1;
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        if (clients[i].connected && clients[i].address == from) slot = i;
+    }
+
+    if (type == PACKET_CONNECT) {
+        if (slot < 0) {
+            for (int i = 0; i < PLAYER_COUNT && slot < 0; ++i) {
+                if (!clients[i].connected) slot = i;
+            }
+            if (slot < 0) return;
+
+            clients[slot] = ClientSlot();
+            clients[slot].connected = true;
+            clients[slot].address = from;
+            clients[slot].statsStartTime = Net::now();
+            std::cout << "클라이언트 접속: " << from.toString() << " -> " << (slot == 0 ? "Steve" : "Alex") << std::endl;
+        }
+        clients[slot].lastReceiveTime = Net::now();
+
+        BitWriter w;
+        writePacketHeader(w, PACKET_ACCEPT);
+        w.writeBits(static_cast<uint32_t>(slot), 1);
+        w.writeBits(matchId, 8);
+        socket.send(from, w.data().data(), w.byteCount());
+        return;
+    }
+
+    if (type == PACKET_SPECTATE) {
+        uint32_t ackTick = r.readBits(32);
+        if (r.overflowed()) return;
+
+        auto it = std::find_if(spectators.begin(), spectators.end(),
+            [&](const ClientSlot& s) { return s.address == from; });
+        if (it == spectators.end()) {
+            if (static_cast<int>(spectators.size()) >= MAX_SPECTATORS) return;
+            ClientSlot s;
+            s.connected = true;
+            s.address = from;
+            s.statsStartTime = Net::now();
+            spectators.push_back(s);
+            it = spectators.end() - 1;
+            std::cout << "관전 릴레이 접속: " << from.toString() << std::endl;
+        }
+        it->lastReceiveTime = Net::now();
+        it->stats.bytesReceived += size;
+        if (ackTick > it->ackTick && it->sentViews.find(ackTick) != it->sentViews.end()) {
+            it->ackTick = ackTick;
+            it->sentViews.erase(it->sentViews.begin(), it->sentViews.find(ackTick));
+        }
+        return;
+    }
+
+    if (slot < 0 || type != PACKET_INPUT) return;
+
+    ClientSlot& c = clients[slot];
+    c.lastReceiveTime = Net::now();
+    c.stats.bytesReceived += size;
+
+    uint32_t ackTick = r.readBits(32);
+    uint16_t newestSeq = static_cast<uint16_t>(r.readBits(16));
+    int count = static_cast<int>(r.readBits(4));
+    PlayerInput inputs[MAX_INPUTS_PER_PACKET];
+    for (int i = 0; i < count && i < MAX_INPUTS_PER_PACKET; ++i) inputs[i] = readPlayerInput(r);
+    if (r.overflowed()) return;
+
+    if (ackTick > c.ackTick && c.sentViews.find(ackTick) != c.sentViews.end()) {
+        c.ackTick = ackTick;
+        c.sentViews.erase(c.sentViews.begin(), c.sentViews.find(ackTick));
+    }
+
+    uint16_t lastQueued = c.pendingInputs.empty() ? c.lastInputSeq : c.pendingInputs.back().first;
+    for (int i = 0; i < count && i < MAX_INPUTS_PER_PACKET; ++i) {
+        uint16_t seq = static_cast<uint16_t>(newestSeq - (count - 1 - i));
+        if (!c.hasInput || seqNewer(seq, lastQueued)) {
+            c.pendingInputs.push_back(std::make_pair(seq, inputs[i]));
+            lastQueued = seq;
+            c.hasInput = true;
+        }
+    }
+    // 입력이 과도하게 쌓이면 오래된 것부터 버려 지연을 제한
+    while (c.pendingInputs.size() > 16) {
+        c.lastInputSeq = c.pendingInputs.front().first;
+        c.pendingInputs.pop_front();
+    }
+}
+
+void GameServer::stepTick()
+{
+    PROFILE_SCOPE("server.tick");
+    double now = Net::now();
+    double tickStart = now;
+    PlayerInput inputs[PLAYER_COUNT];
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        ClientSlot& c = clients[i];
+        if (c.connected && now - c.lastReceiveTime > CLIENT_TIMEOUT) {
+            std::cout << "클라이언트 연결 끊김: " << c.address.toString() << std::endl;
+            c = ClientSlot();
+        }
+        if (!c.connected) {
+            if (botsEnabled) inputs[i] = bots[i].next();
+            continue;
+        }
+
+        if (!c.pendingInputs.empty()) {
+            c.lastInput = c.pendingInputs.front().second;
+            c.lastInputSeq = c.pendingInputs.front().first;
+            c.pendingInputs.pop_front();
+        }
+        inputs[i] = c.lastInput;
+    }
+
+    world.tick(inputs);
+
+    if (world.winner != Winner::NONE) {
+        if (++finishTicks > static_cast<int>(FINISH_RESTART_SECONDS / TICK_DELTA_TIME)) {
+            restartMatch();
+        }
+    }
+
+    for (auto it = spectators.begin(); it != spectators.end();) {
+        if (now - it->lastReceiveTime > CLIENT_TIMEOUT) {
+            std::cout << "관전 릴레이 연결 끊김: " << it->address.toString() << std::endl;
+            it = spectators.erase(it);
+        }
+        else ++it;
+    }
+
+    if (world.tickCount % SNAPSHOT_INTERVAL_TICKS == 0 && (getClientCount() > 0 || !spectators.empty())) {
+        PROFILE_SCOPE("server.snapshots");
+        // 월드 상태 양자화와 공간 격자는 스냅샷마다 한 번만 만들어 모든 수신자가 같이 쓴다
+        NetView full = buildNetView(world);
+        if (interestConfig.enabled) interestGrid.build(full, interestConfig.cellSize);
+        for (int i = 0; i < PLAYER_COUNT; ++i) {
+            if (clients[i].connected) sendSnapshot(clients[i], full, i);
+        }
+        for (auto& s : spectators) sendSnapshot(s, full, -1);
+    }
+
+    timing.record(Net::now() - tickStart);
+}
+
+void GameServer::sendSnapshot(ClientSlot& c, const NetView& full, int player)
+{
+    NetView empty;
+    const NetView* base = &empty;
+    uint32_t baseTick = 0;
+    auto it = c.sentViews.find(c.ackTick);
+    if (c.ackTick != 0 && it != c.sentViews.end()) {
+        base = &it->second;
+        baseTick = c.ackTick;
+    }
+
+    BitWriter w;
+    writePacketHeader(w, PACKET_SNAPSHOT);
+    w.writeBits(matchId, 8);
+    w.writeBits(full.tick, 32);
+    w.writeBits(baseTick, 32);
+    w.writeBits(c.lastInputSeq, 16);
+    w.writeBits(full.winner, 2);
+
+    NetView sent;
+    if (interestConfig.enabled && player >= 0) {
+        NetView target;
+        NetViewOrder order;
+        glm::vec3 eye = world.getCharacterPosition(player);
+        c.interest.select(interestGrid, interestConfig, eye, c.lastInput.aim, full, *base, target, order);
+        encodeNetViewDelta(w, *base, target, sent, interestConfig.snapshotBudget(), &order);
+        c.interest.commit(target, sent);
+    }
+    else {
+        encodeNetViewDelta(w, *base, full, sent);
+    }
+    c.sentViews[full.tick] = sent;
+    while (c.sentViews.size() > 64) c.sentViews.erase(c.sentViews.begin());
+
+    socket.send(c.address, w.data().data(), w.byteCount());
+
+    c.stats.bytesSent += w.byteCount() + UDP_HEADER_BYTES;   // IP/UDP 헤더 포함
+    c.stats.snapshots++;
+    if (baseTick == 0) c.stats.fullSnapshots++;
+    c.stats.maxSnapshotBytes = std::max(c.stats.maxSnapshotBytes, w.byteCount());
+}
+
+void GameServer::restartMatch()
+{
+    SIM_LOG << "새 경기 시작" << std::endl;
+    world.initialize();
+    matchId++;
+    finishTicks = 0;
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        clients[i].sentViews.clear();
+        clients[i].ackTick = 0;
+        clients[i].interest.reset();
+    }
+    for (auto& s : spectators) {
+        s.sentViews.clear();
+        s.ackTick = 0;
+    }
+}
+
+void GameServer::printStats() const
+{
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        const ClientSlot& c = clients[i];
+        if (!c.connected) continue;
+        std::cout << "[서버] " << (i == 0 ? "Steve" : "Alex") << " " << c.address.toString()
+            << " 송신 " << getClientBandwidth(i) / 1024.0 << " KB/s, 스냅샷 " << c.stats.snapshots
+            << " (전체 " << c.stats.fullSnapshots << "), 최대 " << c.stats.maxSnapshotBytes << " bytes" << std::endl;
+        if (interestConfig.enabled) {
+            const InterestStats& s = c.interest.getStats();
+            std::cout << "[서버]   관심 영역: 눈덩이 " << s.visibleSnowballs << ", 눈 칸 " << s.visibleCells
+                << ", 진입 " << s.enters << ", 이탈 " << s.leaves << ", 예산 초과로 미룸 " << s.deferred << std::endl;
+        }
+    }
+}
+
+//--- 클라이언트
+
+GameClient::GameClient()
+{
+}
+
+bool GameClient::connect(const NetAddress& server, const NetConditions& conditions)
+{
+    if (!socket.open(0)) return false;
+    socket.setConditions(conditions);
+    serverAddress = server;
+    connected = false;
+    playerIndex = -1;
+    lastConnectAttempt = -1.0;
+    std::cout << "서버 접속 시도: " << server.toString() << std::endl;
+    return true;
+}
+
+void GameClient::disconnect()
+{
+    socket.close();
+    connected = false;
+    world.reset();
+}
+
+void GameClient::update(const PlayerInput& input)
+{
+    lastSnowballCorrection = 0.0f;
+    receivePackets();
+
+    double now = Net::now();
+    if (!connected) {
+        if (lastConnectAttempt < 0.0 || now - lastConnectAttempt > 0.5) {
+            BitWriter w;
+            writePacketHeader(w, PACKET_CONNECT);
+            socket.send(serverAddress, w.data().data(), w.byteCount());
+            lastConnectAttempt = now;
+        }
+        socket.flush();
+        return;
+    }
+
+    if (now - lastReceiveTime > CLIENT_TIMEOUT) {
+        std::cout << "서버 응답 없음, 연결 종료" << std::endl;
+        connected = false;
+        return;
+    }
+
+    PlayerInput quantized = quantizePlayerInput(input);
+    inputHistory.push_back(std::make_pair(nextInputSeq++, quantized));
+    while (inputHistory.size() > 128) inputHistory.pop_front();
+    sendInputs();
+
+    // 자기 캐릭터는 즉시 예측, 눈덩이는 궤적만 외삽 (충돌/소멸은 서버가 결정)
+    world.snowSystem.updateAnimations(TICK_DELTA_TIME);
+    for (auto& sb : world.snowballs) {
+        sb.integrate(TICK_DELTA_TIME);
+        auto error = snowballErrors.find(sb.getId());
+        if (error == snowballErrors.end()) continue;
+        glm::vec3 remaining = error->second * SNOWBALL_ERROR_KEEP;
+        sb.setMotion(sb.getPosition() - error->second + remaining, sb.getVelocity());
+        lastSnowballCorrection = std::max(lastSnowballCorrection, glm::length(error->second - remaining));
+        error->second = remaining;
+    }
+    world.applyPlayerInput(playerIndex, quantized, false);
+    world.tickCount++;
+
+    if (hasView) {
+        int other = 1 - playerIndex;
+        remoteTicks++;
+        float t = std::min(static_cast<float>(remoteTicks) / SNAPSHOT_INTERVAL_TICKS, 1.0f);
+        CharacterState s = remoteTo;
+        s.pos = glm::mix(remoteFrom.pos, remoteTo.pos, t);
+        world.setCharacterState(other, s);
+    }
+
+    socket.flush();
+}
+
+void GameClient::sendInputs()
+{
+    int count = static_cast<int>(std::min<size_t>(inputHistory.size(), MAX_INPUTS_PER_PACKET));
+
+    BitWriter w;
+    writePacketHeader(w, PACKET_INPUT);
+    w.writeBits(latestView.tick, 32);
+    w.writeBits(inputHistory.back().first, 16);
+    w.writeBits(static_cast<uint32_t>(count), 4);
+    for (size_t i = inputHistory.size() - count; i < inputHistory.size(); ++i) {
+        writePlayerInput(w, inputHistory[i].second);
+    }
+    socket.send(serverAddress, w.data().data(), w.byteCount());
+    stats.bytesSent += w.byteCount() + UDP_HEADER_BYTES;
+}
+
+void GameClient::receivePackets()
+{
+    uint8_t buffer[1500];
+    NetAddress from;
+    int size;
+    while ((size = socket.receive(from, buffer, sizeof(buffer))) > 0) {
+        if (from != serverAddress) continue;
+        stats.bytesReceived += size + UDP_HEADER_BYTES;
+        handlePacket(buffer, static_cast<size_t>(size));
+    }
+}
+
+void GameClient::handlePacket(const uint8_t* data, size_t size)
+{
+    BitReader r(data, size);
+    uint32_t type = 0;
+    if (!readPacketHeader(r, type)) return;
+    lastReceiveTime = Net::now();
+
+    if (type == PACKET_ACCEPT) {
+        int index = static_cast<int>(r.readBits(1));
+        uint8_t match = static_cast<uint8_t>(r.readBits(8));
+        if (connected) return;
+
+        connected = true;
+        playerIndex = index;
+        matchId = match;
+        world.initialize();
+        std::cout << "서버 접속 완료: " << (index == 0 ? "Steve" : "Alex") << " 조작" << std::endl;
+        return;
+    }
+
+    if (type != PACKET_SNAPSHOT || !connected) return;
+
+    uint8_t match = static_cast<uint8_t>(r.readBits(8));
+    NetView view;
+    view.tick = r.readBits(32);
+    uint32_t baseTick = r.readBits(32);
+    uint16_t lastProcessedSeq = static_cast<uint16_t>(r.readBits(16));
+    view.winner = static_cast<uint8_t>(r.readBits(2));
+
+    if (match != matchId) {
+        // 서버가 새 경기를 시작했다
+        if (baseTick != 0) return;
+        matchId = match;
+        world.initialize();
+        receivedViews.clear();
+        latestView = NetView();
+        hasView = false;
+        snowballLead = -1.0f;
+        snowballErrors.clear();
+    }
+    if (hasView && view.tick <= latestView.tick) return;
+
+    NetView empty;
+    const NetView* base = &empty;
+    if (baseTick != 0) {
+        auto it = receivedViews.find(baseTick);
+        if (it == receivedViews.end()) return;
+        base = &it->second;
+    }
+    if (!decodeNetViewDelta(r, *base, view)) return;
+
+    stats.snapshots++;
+    if (baseTick == 0) stats.fullSnapshots++;
+    stats.maxSnapshotBytes = std::max(stats.maxSnapshotBytes, size);
+
+    receivedViews[view.tick] = view;
+    while (receivedViews.size() > 64) receivedViews.erase(receivedViews.begin());
+
+    applyView(view, lastProcessedSeq);
+}
+
+void GameClient::applyView(const NetView& view, uint16_t lastProcessedSeq)
+{
+    const NetView previous = latestView;
+    const bool hadView = hasView;
+    latestView = view;
+    hasView = true;
+
+    world.winner = static_cast<Winner>(view.winner);
+
+    // 상대 캐릭터: 보간 목표 갱신
+    int other = 1 - playerIndex;
+    remoteFrom = hadView ? world.getCharacterState(other) : view.characters[other];
+    remoteTo = view.characters[other];
+    remoteTicks = 0;
+    world.players[other].charging = view.players[other].charging;
+    world.players[other].throwHeld = view.players[other].throwHeld;
+
+    // 자기 캐릭터: 서버 상태로 되돌린 뒤 아직 처리되지 않은 입력을 재적용
+    glm::vec3 predicted = world.getCharacterPosition(playerIndex);
+    world.setCharacterState(playerIndex, view.characters[playerIndex]);
+    PlayerState& ps = world.players[playerIndex];
+    ps.charging = view.players[playerIndex].charging;
+    ps.throwHeld = view.players[playerIndex].throwHeld;
+    ps.chargeStartTick = view.tick - view.players[playerIndex].chargeTicks;
+    world.tickCount = view.tick;
+
+    while (!inputHistory.empty() && !seqNewer(inputHistory.front().first, lastProcessedSeq)) {
+        inputHistory.pop_front();
+    }
+    for (const auto& entry : inputHistory) {
+        world.applyPlayerInput(playerIndex, entry.second, false);
+        world.tickCount++;
+    }
+    lastCorrection = glm::distance(predicted, world.getCharacterPosition(playerIndex));
+
+    std::vector<uint16_t> extrapolated;
+    for (const auto& sb : world.snowballs) extrapolated.push_back(sb.getId());
+    applyNetViewObjects(world, view, hadView ? &previous : nullptr);
+
+    // 눈덩이: 받은 상태로 되돌린 뒤 그 상태의 틱부터 자기 캐릭터처럼 앞서 있는 틱까지 다시 외삽한다.
+    // 스냅샷은 눈덩이를 기준 스냅샷에 없을 때만 보내므로 (궤적은 정해져 있다) 상태는 대개 view.tick보다 오래됐다.
+    // 앞선 틱 수(아직 처리되지 않은 입력 수)는 스냅샷마다 흔들리므로 부드럽게 따라가고 (소수 틱은 마지막에
+    // 짧게 적분한다), 외삽하던 위치와의 차이는 보이는 위치에 남겨 두었다가 update가 틱마다 줄인다.
+    float aheadTicks = static_cast<float>(world.tickCount - view.tick);
+    if (snowballLead < 0.0f) snowballLead = aheadTicks;
+    else snowballLead += (aheadTicks - snowballLead) * SNOWBALL_LEAD_SMOOTHING;
+
+    std::map<uint16_t, glm::vec3> errors;
+    lastSnowballError = 0.0f;
+    for (auto& sb : world.snowballs) {
+        auto found = view.snowballs.find(sb.getId());
+        if (found == view.snowballs.end()) continue;
+        glm::vec3 before = sb.getPosition();
+        float ticks = static_cast<float>(view.tick - found->second.tick) + snowballLead;
+        int wholeTicks = static_cast<int>(ticks);
+        float fractionTicks = ticks - static_cast<float>(wholeTicks);
+        sb.setMotion(found->second.pos, found->second.vel);
+        for (int i = 0; i < wholeTicks; ++i) sb.integrate(TICK_DELTA_TIME);
+        if (fractionTicks > 0.0f) sb.integrate(fractionTicks * TICK_DELTA_TIME);
+        if (std::find(extrapolated.begin(), extrapolated.end(), sb.getId()) == extrapolated.end()) continue;
+
+        glm::vec3 error = before - sb.getPosition();
+        float distance = glm::length(error);
+        lastSnowballError = std::max(lastSnowballError, distance);
+        if (distance > SNOWBALL_SNAP_DISTANCE) {
+            lastSnowballCorrection = std::max(lastSnowballCorrection, distance);
+            continue;
+        }
+        sb.setMotion(before, sb.getVelocity());
+        errors[sb.getId()] = error;
+    }
+    snowballErrors.swap(errors);
+}
+
+//--- 실행 모드
+
+int runNetSelfTest(float seconds, const NetConditions& conditions, const InterestConfig& interest)
+{
+    Init::graphicsEnabled() = false;
+    if (!Net::initialize()) return 1;
+
+    GameServer server;
+    if (!server.start(0, conditions)) return 1;
+    server.setInterestConfig(interest);
+
+    NetAddress address;
+    NetAddress::parse("127.0.0.1", server.getPort(), address);
+
+    GameClient clients[PLAYER_COUNT];
+    for (int i = 0; i < PLAYER_COUNT; ++i) clients[i].connect(address, conditions);
+
+    InputBot bots[PLAYER_COUNT] = { InputBot(0, 7), InputBot(1, 8) };
+    double correctionSum = 0.0;
+    float correctionMax = 0.0f;
+    int correctionSamples = 0;
+    float snowballCorrectionMax = 0.0f;
+    float snowballErrorMax = 0.0f;
+
+    SimLog::Mute mute;
+    double start = Net::now();
+    double nextTick = start;
+    while (Net::now() - start < seconds) {
+        server.update();
+        for (int i = 0; i < PLAYER_COUNT; ++i) {
+            int player = clients[i].getPlayerIndex() < 0 ? i : clients[i].getPlayerIndex();
+            clients[i].update(bots[player].next());
+            if (clients[i].isConnected() && clients[i].getStats().snapshots > 0) {
+                correctionSum += clients[i].getLastCorrection();
+                correctionMax = std::max(correctionMax, clients[i].getLastCorrection());
+                correctionSamples++;
+                snowballCorrectionMax = std::max(snowballCorrectionMax, clients[i].getLastSnowballCorrection());
+                snowballErrorMax = std::max(snowballErrorMax, clients[i].getLastSnowballError());
+            }
+        }
+
+        nextTick += TICK_DELTA_TIME;
+        double wait = nextTick - Net::now();
+        if (wait > 0.0) Net::sleepMs(static_cast<int>(wait * 1000.0));
+    }
+
+    double elapsed = Net::now() - start;
+    bool pass = true;
+    std::cout << "\n=== 네트워크 자체 테스트 (" << elapsed << "초, 지연 " << conditions.latencyMs
+        << "ms, 지터 " << conditions.jitterMs << "ms, 손실 " << conditions.lossPercent << "%) ===" << std::endl;
+    server.printStats();
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        const NetStats& s = clients[i].getStats();
+        double down = s.bytesReceived / elapsed;
+        double up = s.bytesSent / elapsed;
+        std::cout << "클라이언트 " << i << ": 수신 " << down / 1024.0 << " KB/s, 송신 " << up / 1024.0
+            << " KB/s, 스냅샷 " << s.snapshots << ", 최대 " << s.maxSnapshotBytes << " bytes" << std::endl;
+        if (!clients[i].isConnected() || s.snapshots == 0 || down >= CLIENT_BYTES_PER_SECOND) pass = false;
+    }
+    std::cout << "예측 보정 오차: 평균 " << (correctionSamples ? correctionSum / correctionSamples : 0.0)
+        << ", 최대 " << correctionMax << ", 눈덩이 최대 " << snowballCorrectionMax
+        << " (틱당, 스냅샷 차이 최대 " << snowballErrorMax << ")" << std::endl;
+    std::cout << (pass ? "PASS" : "FAIL") << std::endl;
+
+    Net::shutdown();
+    return pass ? 0 : 1;
+}
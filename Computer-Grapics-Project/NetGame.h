@@ -0,0 +1,225 @@
+﻿#pragma once
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+#include "Net.h"
+#include "GameWorld.h"
+#include "InterestManager.h"
+
+constexpr uint16_t DEFAULT_SERVER_PORT = 27015;
+constexpr int SNAPSHOT_INTERVAL_TICKS = 3;          // 62.5Hz 틱 / 3 = 약 20.8Hz
+constexpr size_t UDP_HEADER_BYTES = 28;              // IPv4 + UDP 헤더 (대역폭 통계와 예산에 더한다)
+constexpr double CLIENT_BYTES_PER_SECOND = 16.0 * 1024.0;
+// 스냅샷 간격에서 나온 상한 (지금 값으로 758). 헤더를 더해도 클라이언트당 CLIENT_BYTES_PER_SECOND를 넘지 않는다.
+constexpr size_t MAX_SNAPSHOT_BYTES =
+    static_cast<size_t>(CLIENT_BYTES_PER_SECOND * SNAPSHOT_INTERVAL_TICKS * TICK_DELTA_TIME) - UDP_HEADER_BYTES;
+constexpr int MAX_INPUTS_PER_PACKET = 8;
+constexpr int MAX_SPECTATORS = 4;                    // 서버에 직접 붙는 관전 릴레이 수
+
+// 패킷 종류 (3비트). 관전 릴레이도 같은 프로토콜 ID와 헤더를 쓴다.
+enum NetPacketType {
+    PACKET_CONNECT = 1,
+    PACKET_ACCEPT = 2,
+    PACKET_INPUT = 3,
+    PACKET_SNAPSHOT = 4,
+    PACKET_SPECTATE = 5,       // 릴레이 -> 서버: 관전 구독 + 받은 스냅샷 확인
+    PACKET_RELAY_FRAME = 6,    // 릴레이 -> 시청자: 지연된 관전 프레임
+    PACKET_VIEWER_JOIN = 7     // 시청자 -> 릴레이: 시청 등록/유지
+};
+
+// 클라이언트가 알고 있는 월드 상태 (양자화된 값). 델타 압축의 기준이 된다.
+struct NetSnowball {
+    glm::vec3 pos{ 0.0f };
+    glm::vec3 vel{ 0.0f };
+    uint32_t tick = 0;      // 위 상태가 몇 틱의 것인지 (보내지 않는다: 받는 쪽이 그 항목이 온 스냅샷의 틱으로 채운다)
+};
+
+struct NetPlayerState {
+    bool charging = false;
+    bool throwHeld = false;
+    int chargeTicks = 0;
+};
+
+struct NetView {
+    uint32_t tick = 0;
+    uint8_t winner = 0;
+    CharacterState characters[PLAYER_COUNT];
+    NetPlayerState players[PLAYER_COUNT];
+    std::map<uint16_t, NetSnowball> snowballs;
+    std::map<std::pair<int, int>, int> snow;   // 0.5 단위 목표 높이
+};
+
+// 델타 인코딩 시 눈덩이/눈 칸을 보낼 순서. 여기 없는 항목은 보내지 않는다.
+struct NetViewOrder {
+    std::vector<uint16_t> snowballs;
+    std::vector<std::pair<int, int>> cells;
+};
+
+struct NetStats {
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+    uint32_t snapshots = 0;
+    uint32_t fullSnapshots = 0;
+    size_t maxSnapshotBytes = 0;
+};
+
+// 틱 처리 시간 통계 (25us 단위 히스토그램으로 p99를 낸다)
+struct TickTiming {
+    static const int BUCKET_COUNT = 128;
+    static constexpr double BUCKET_SECONDS = 0.000025;
+
+    uint64_t ticks = 0;
+    double totalSeconds = 0.0;
+    double maxSeconds = 0.0;
+    uint32_t overBudget = 0;               // TICK_DELTA_TIME을 넘긴 틱 수
+    uint32_t histogram[BUCKET_COUNT] = {};
+
+    void record(double seconds);
+    double average() const { return ticks ? totalSeconds / ticks : 0.0; }
+    double percentile(double p) const;
+};
+
+class GameServer
+{
+public:
+    GameServer();
+
+    bool start(uint16_t port, const NetConditions& conditions);
+    void stop();
+
+    // 실시간으로 호출하면 고정 틱으로 시뮬레이션을 진행한다
+    void update();
+    void printStats() const;
+
+    uint16_t getPort() const { return socket.getLocalPort(); }
+    GameWorld& getWorld() { return world; }
+    int getClientCount() const;
+    int getSpectatorCount() const { return static_cast<int>(spectators.size()); }
+    double getClientBandwidth(int slot) const;   // 바이트/초
+    const TickTiming& getTickTiming() const { return timing; }
+
+    // 접속하지 않은 자리는 봇이 조작한다 (부하 측정용)
+    void setBotsEnabled(bool enabled, unsigned int seed);
+    // 플레이어 클라이언트에 관심 영역 안의 것만 예산 안에서 보낸다 (관전 릴레이는 항상 전체)
+    void setInterestConfig(const InterestConfig& config) { interestConfig = config; }
+
+private:
+    struct ClientSlot {
+        bool connected = false;
+        NetAddress address;
+        double lastReceiveTime = 0.0;
+        std::deque<std::pair<uint16_t, PlayerInput>> pendingInputs;
+        PlayerInput lastInput;
+        uint16_t lastInputSeq = 0;
+        bool hasInput = false;
+        uint32_t ackTick = 0;
+        std::map<uint32_t, NetView> sentViews;
+        NetStats stats;
+        double statsStartTime = 0.0;
+        InterestSet interest;
+    };
+
+    void receivePackets();
+    void handlePacket(const NetAddress& from, const uint8_t* data, size_t size);
+    void stepTick();
+    // player가 -1이면 관심 영역 없이 전체를 보낸다
+    void sendSnapshot(ClientSlot& c, const NetView& full, int player);
+    void restartMatch();
+
+    UdpSocket socket;
+    GameWorld world;
+    ClientSlot clients[PLAYER_COUNT];
+    std::vector<ClientSlot> spectators;     // 입력 없이 스냅샷만 받는 관전 릴레이
+    double accumulator = 0.0;
+    double lastTime = 0.0;
+    uint8_t matchId = 0;
+    int finishTicks = 0;
+
+    bool botsEnabled = false;
+    std::vector<InputBot> bots;
+    TickTiming timing;
+
+    InterestConfig interestConfig;
+    InterestGrid interestGrid;
+};
+
+class GameClient
+{
+public:
+    GameClient();
+
+    bool connect(const NetAddress& server, const NetConditions& conditions);
+    void disconnect();
+
+    // 한 틱 진행: 입력 전송, 자기 캐릭터 예측, 스냅샷 반영
+    void update(const PlayerInput& input);
+
+    bool isConnected() const { return connected; }
+    int getPlayerIndex() const { return playerIndex; }
+    GameWorld& getWorld() { return world; }
+    const NetStats& getStats() const { return stats; }
+    float getLastCorrection() const { return lastCorrection; }
+    float getLastSnowballCorrection() const { return lastSnowballCorrection; }
+    float getLastSnowballError() const { return lastSnowballError; }
+    uint32_t getServerTick() const { return latestView.tick; }
+
+private:
+    void receivePackets();
+    void handlePacket(const uint8_t* data, size_t size);
+    void applyView(const NetView& view, uint16_t lastProcessedSeq);
+    void sendInputs();
+
+    UdpSocket socket;
+    NetAddress serverAddress;
+    GameWorld world;
+    bool connected = false;
+    int playerIndex = -1;
+    uint8_t matchId = 0;
+    double lastConnectAttempt = -1.0;
+    double lastReceiveTime = 0.0;
+
+    uint16_t nextInputSeq = 1;
+    std::deque<std::pair<uint16_t, PlayerInput>> inputHistory;
+
+    std::map<uint32_t, NetView> receivedViews;
+    NetView latestView;
+    bool hasView = false;
+
+    // 상대 캐릭터는 최근 두 스냅샷 사이를 보간해서 보여준다
+    CharacterState remoteFrom, remoteTo;
+    int remoteTicks = 0;
+
+    NetStats stats;
+    float lastCorrection = 0.0f;
+    // 눈덩이는 서버 틱보다 snowballLead 틱 앞서 외삽한다. 자기 캐릭터가 앞선 틱(아직 처리되지 않은 입력 수)은
+    // 스냅샷마다 한두 틱씩 흔들리므로 그대로 쓰지 않고 천천히 따라간다 (-1이면 아직 없음).
+    // 스냅샷을 받아 생긴 위치 차이는 snowballErrors에 두고 몇 틱에 걸쳐 줄여서 순간 이동하지 않게 한다.
+    float snowballLead = -1.0f;
+    std::map<uint16_t, glm::vec3> snowballErrors;
+    float lastSnowballCorrection = 0.0f;  // 이번 틱에 눈덩이가 보정으로 움직인 가장 먼 거리 (화면에 보이는 튐)
+    float lastSnowballError = 0.0f;       // 마지막 스냅샷에서 외삽하던 위치와 서버 기준 위치의 가장 먼 차이
+};
+
+void writePacketHeader(BitWriter& w, NetPacketType type);
+bool readPacketHeader(BitReader& r, uint32_t& type);
+
+// 월드 상태 <-> 델타 압축 스냅샷 (서버 스냅샷과 관전 릴레이 프레임이 같은 인코딩을 쓴다)
+NetView buildNetView(const GameWorld& world);
+// target을 base 대비 델타로 인코딩한다. 예산을 넘는 항목은 다음으로 미루고,
+// 실제로 보낸 내용만 반영한 결과를 sent에 돌려준다.
+// order가 있으면 그 우선순위 순서로 예산을 채운다.
+void encodeNetViewDelta(BitWriter& w, const NetView& base, const NetView& target, NetView& sent,
+    size_t budgetBytes = MAX_SNAPSHOT_BYTES, const NetViewOrder* order = nullptr);
+bool decodeNetViewDelta(BitReader& r, const NetView& base, NetView& view);
+// 눈덩이와 눈 칸을 view에 맞춘다. previous가 있으면 바뀐 칸만 건드린다.
+void applyNetViewObjects(GameWorld& world, const NetView& view, const NetView* previous);
+
+// 입력 직렬화 (서버/클라이언트, P2P 롤백이 같은 형식을 쓴다)
+void writePlayerInput(BitWriter& w, const PlayerInput& in);
+PlayerInput readPlayerInput(BitReader& r);
+// 전송했다가 다시 읽은 것과 같은 값. 시뮬레이션에는 항상 이 값을 넣어야 양쪽 결과가 같다.
+PlayerInput quantizePlayerInput(const PlayerInput& input);
+
+// 같은 프로세스에서 서버 + 봇 클라이언트 2개를 루프백으로 돌려 대역폭/보정 오차를 보고
+int runNetSelfTest(float seconds, const NetConditions& conditions, const InterestConfig& interest = InterestConfig());
@@ -0,0 +1,132 @@
+﻿#include "PerfHud.h"
+#include "Profiler.h"
+#include "GpuTimer.h"
+#include <gl/glew.h>
+#include <gl/freeglut.h>
+#include "GlIntercept.h"
+#include "GlState.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int REFRESH_FRAMES = 15;     // 요약 통계는 이 주기로만 다시 계산한다
+const int LINE_HEIGHT = 15;
+
+bool visible = false;
+std::vector<std::string> lines;
+int framesUntilRefresh = 0;
+
+void rebuildLines()
+{
+    lines.clear();
+    char buffer[128];
+
+#if PROFILER_ENABLED
+    Profiler::Summary frame = Profiler::summarize(-1);
+    std::snprintf(buffer, sizeof(buffer), "frame  avg %.2f  p99 %.2f  max %.2f ms  (%.1f fps)",
+        frame.average * 1e3, frame.p99 * 1e3, frame.max * 1e3, frame.average > 0.0 ? 1.0 / frame.average : 0.0);
+    lines.push_back(buffer);
+
+    if (Profiler::historySize() > 0) {
+        const Profiler::FrameStats& last = Profiler::history(0);
+        std::snprintf(buffer, sizeof(buffer), "draw calls %u  triangles %llu",
+            last.drawCalls, static_cast<unsigned long long>(last.triangles));
+        lines.push_back(buffer);
+    }
+
+    if (GpuTimer::isAvailable()) {
+        std::snprintf(buffer, sizeof(buffer), "gpu.* read back %d frames late  (resolved %llu, dropped %llu)",
+            GpuTimer::FRAME_LATENCY, static_cast<unsigned long long>(GpuTimer::resolvedFrames()),
+            static_cast<unsigned long long>(GpuTimer::droppedFrames()));
+        lines.push_back(buffer);
+    }
+
+    {
+        const GlState::Counters& state = GlState::lastFrame();
+        std::string detail = "gl state issued " + std::to_string(state.totalIssued()) + "  elided " + std::to_string(state.totalElided()) + " ";
+        for (int k = 0; k < GlState::KIND_COUNT; ++k) {
+            std::snprintf(buffer, sizeof(buffer), " %s %u/%u", GlState::kindName(k), state.issued[k], state.elided[k]);
+            detail += buffer;
+        }
+        lines.push_back(detail);
+    }
+
+    if (GlIntercept::isEnabled()) {
+        const GlIntercept::Counters& gl = GlIntercept::lastFrame();
+        std::snprintf(buffer, sizeof(buffer), "gl calls %u  redundant %u  upload %lluKB", gl.totalCalls(), gl.totalRedundant(),
+            static_cast<unsigned long long>(gl.uploadBytes / 1024));
+        lines.push_back(buffer);
+        std::string detail = " ";
+        for (int c = 0; c < GlIntercept::CATEGORY_COUNT; ++c) {
+            std::snprintf(buffer, sizeof(buffer), " %s %u/%u", GlIntercept::categoryName(c), gl.calls[c], gl.redundant[c]);
+            detail += buffer;
+        }
+        lines.push_back(detail);
+    }
+
+    std::snprintf(buffer, sizeof(buffer), "%-24s %7s %7s %7s", "zone (ms)", "avg", "p99", "max");
+    lines.push_back(buffer);
+    int count = Profiler::zoneCount();
+    for (int i = 0; i < count; ++i) {
+        Profiler::Summary s = Profiler::summarize(i);
+        if (s.max <= 0.0) continue;
+        std::snprintf(buffer, sizeof(buffer), "%-24s %7.3f %7.3f %7.3f",
+            Profiler::zoneName(i), s.average * 1e3, s.p99 * 1e3, s.max * 1e3);
+        if (GlIntercept::isEnabled() && GlIntercept::lastFrameZone(i).totalCalls() > 0) {
+            size_t length = std::strlen(buffer);
+            std::snprintf(buffer + length, sizeof(buffer) - length, "  gl %u/%u",
+                GlIntercept::lastFrameZone(i).totalCalls(), GlIntercept::lastFrameZone(i).totalRedundant());
+        }
+        lines.push_back(buffer);
+    }
+#else
+    std::snprintf(buffer, sizeof(buffer), "profiler compiled out (PROFILER_ENABLED=0)");
+    lines.push_back(buffer);
+#endif
+}
+
+} // namespace
+
+bool PerfHud::isVisible()
+{
+    return visible;
+}
+
+void PerfHud::toggle()
+{
+    visible = !visible;
+    framesUntilRefresh = 0;
+    std::cout << "성능 HUD: " << (visible ? "ON" : "OFF") << std::endl;
+}
+
+void PerfHud::draw(int winW, int winH)
+{
+    if (!visible) return;
+    PROFILE_SCOPE("render.perf_hud");
+    GPU_SCOPE("gpu.perf_hud");
+
+    if (--framesUntilRefresh <= 0) {
+        rebuildLines();
+        framesUntilRefresh = REFRESH_FRAMES;
+    }
+
+    // 고정 파이프라인 비트맵 글꼴로 그린다 (그림자 -> 본문 순서)
+    GlState::useProgram(0);
+    GlState::disable(GL_DEPTH_TEST);
+    glViewport(0, 0, winW, winH);
+    for (int pass = 0; pass < 2; ++pass) {
+        if (pass == 0) glColor3f(0.0f, 0.0f, 0.0f);
+        else glColor3f(1.0f, 1.0f, 0.3f);
+        int y = winH - LINE_HEIGHT - 4;
+        for (const auto& line : lines) {
+            glWindowPos2i(pass == 0 ? 9 : 8, pass == 0 ? y - 1 : y);
+            glutBitmapString(GLUT_BITMAP_8_BY_13, reinterpret_cast<const unsigned char*>(line.c_str()));
+            y -= LINE_HEIGHT;
+        }
+    }
+    GlState::enable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,11 @@
+﻿#pragma once
+
+// F3으로 켜고 끄는 성능 오버레이 (Profiler 기록 링의 평균/p99/최대, 드로우 콜, 삼각형 수)
+namespace PerfHud {
+    bool isVisible();
+    void toggle();
+
+    // 화면을 다 그린 뒤 스왑 직전에 호출. 셰이더 프로그램 바인딩을 풀어 두므로
+    // 다음 프레임은 glUseProgram부터 다시 해야 한다.
+    void draw(int winW, int winH);
+}
@@ -0,0 +1,303 @@
+﻿#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned int MODE_TRIANGLES = 0x0004;   // GL_TRIANGLES
+
+std::mutex zoneMutex;
+const char* zoneNames[Profiler::MAX_ZONES];
+int registeredZones = 0;
+
+// 스레드마다 따로 쌓는다. 기록 링에 들어가는 것은 endFrame을 부르는 메인 스레드 것뿐이다.
+thread_local Profiler::FrameStats current;
+
+Profiler::FrameStats ring[Profiler::HISTORY_FRAMES];
+int ringHead = 0;
+int ringSize = 0;
+double lastFrameEnd = 0.0;
+int frameZone = -1;
+
+//--- 트레이스 캡처
+
+struct TraceEvent {
+    int zone;
+    double start;
+    double end;
+};
+
+// 한 스레드의 이벤트 버퍼. 기록은 그 스레드만 하고, 파일 쓰기는 캡처가 끝난 뒤
+// 메인 스레드가 count까지만 읽는다. 버퍼는 startCapture가 그때 있는 스레드 것을 모두, 캡처 중에 이름을
+// 붙인 스레드는 setThreadName이 잡고 페이지를 미리 건드려 둔다. 그래서 기록 중에는 할당도 첫 페이지 폴트도
+// 없고, 캡처를 한 번도 안 하면 스레드마다 6MB를 잡지 않는다. 버퍼가 없는 트랙의 이벤트는 버린 것으로 센다.
+struct ThreadTrace {
+    std::string name;
+    int tid = 0;
+    std::atomic<TraceEvent*> events{ nullptr };     // 한 번 잡으면 다음 캡처도 같이 쓴다
+    ~ThreadTrace() { delete[] events.load(); }
+    std::atomic<size_t> count{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    // 이 버퍼가 채워지고 있는 캡처. 주인 스레드가 버퍼를 비운 뒤에 release로 쓰고, 파일 쓰기가 acquire로 읽는다.
+    std::atomic<uint32_t> generation{ 0 };
+};
+
+std::mutex traceMutex;
+std::vector<std::unique_ptr<ThreadTrace>> traceThreads;
+thread_local ThreadTrace* localTrace = nullptr;
+ThreadTrace* gpuTrace = nullptr;      // GPU 구간은 스레드가 아니라 별도 트랙에 둔다 (메인 스레드만 쓴다)
+
+std::atomic<bool> capturing{ false };
+std::atomic<uint32_t> captureGeneration{ 0 };
+double captureStart = 0.0;
+double captureEnd = 0.0;
+std::string capturePath;
+
+// traceMutex를 잡고 부른다
+void allocateEvents(ThreadTrace* t)
+{
+    if (t->events.load(std::memory_order_relaxed)) return;
+    TraceEvent* events = new TraceEvent[Profiler::TRACE_EVENTS_PER_THREAD];
+    // 페이지마다 한 번씩 써서 첫 기록 때 페이지 폴트가 나지 않게 한다
+    const size_t stride = 4096 / sizeof(TraceEvent);
+    for (size_t i = 0; i < static_cast<size_t>(Profiler::TRACE_EVENTS_PER_THREAD); i += stride) events[i].zone = -1;
+    t->events.store(events, std::memory_order_release);
+}
+
+ThreadTrace* createTrack(const char* name)
+{
+    std::unique_ptr<ThreadTrace> trace(new ThreadTrace());
+    std::lock_guard<std::mutex> lock(traceMutex);
+    trace->tid = static_cast<int>(traceThreads.size()) + 1;
+    trace->name = name ? std::string(name) : "thread " + std::to_string(trace->tid);
+    traceThreads.push_back(std::move(trace));
+    return traceThreads.back().get();
+}
+
+ThreadTrace* threadTrace()
+{
+    if (!localTrace) localTrace = createTrack(nullptr);
+    return localTrace;
+}
+
+void recordEvent(ThreadTrace* t, int zone, double start, double end)
+{
+    uint32_t generation = captureGeneration.load(std::memory_order_acquire);
+    if (t->generation.load(std::memory_order_relaxed) != generation) {
+        // 새 캡처의 첫 이벤트: 자기 버퍼를 비운다 (버퍼는 이미 잡혀 있다)
+        t->count.store(0, std::memory_order_relaxed);
+        t->dropped.store(0, std::memory_order_relaxed);
+        t->generation.store(generation, std::memory_order_release);
+    }
+    TraceEvent* events = t->events.load(std::memory_order_acquire);
+    size_t n = t->count.load(std::memory_order_relaxed);
+    if (!events || n >= static_cast<size_t>(Profiler::TRACE_EVENTS_PER_THREAD)) {
+        t->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    events[n].zone = zone;
+    events[n].start = start;
+    events[n].end = end;
+    t->count.store(n + 1, std::memory_order_release);
+}
+
+void writeJsonString(FILE* f, const std::string& s)
+{
+    std::fputc('"', f);
+    for (char c : s) {
+        if (c == '"' || c == '\\') std::fputc('\\', f);
+        std::fputc(c, f);
+    }
+    std::fputc('"', f);
+}
+
+void writeTrace()
+{
+    FILE* f = std::fopen(capturePath.c_str(), "wb");
+    if (!f) {
+        std::cerr << "트레이스 파일 저장 실패: " << capturePath << std::endl;
+        return;
+    }
+
+    std::vector<std::string> names;
+    int zones = Profiler::zoneCount();
+    for (int i = 0; i < zones; ++i) names.push_back(Profiler::zoneName(i));
+
+    uint32_t generation = captureGeneration.load();
+    size_t written = 0;
+    uint64_t dropped = 0;
+    bool first = true;
+    std::fputs("{\"traceEvents\":[\n", f);
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    for (const auto& t : traceThreads) {
+        std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+            first ? "" : ",\n", t->tid);
+        writeJsonString(f, t->name);
+        std::fputs("}}", f);
+        first = false;
+
+        if (t->generation.load(std::memory_order_acquire) != generation) continue;
+        size_t count = t->count.load(std::memory_order_acquire);
+        dropped += t->dropped.load();
+        const TraceEvent* events = t->events.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& e = events[i];
+            if (e.start < captureStart || e.zone < 0 || e.zone >= zones) continue;
+            std::fputs(",\n{\"name\":", f);
+            writeJsonString(f, names[e.zone]);
+            std::fprintf(f, ",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                (e.start - captureStart) * 1e6, (e.end - e.start) * 1e6, t->tid);
+            written++;
+        }
+    }
+    std::fprintf(f, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":%llu}}\n",
+        static_cast<unsigned long long>(dropped));
+    std::fclose(f);
+
+    std::cout << "트레이스 저장: " << capturePath << " (이벤트 " << written << "개, 버퍼 초과로 버림 " << dropped << "개)" << std::endl;
+}
+
+} // namespace
+
+int Profiler::registerZone(const char* name)
+{
+    std::lock_guard<std::mutex> lock(zoneMutex);
+    for (int i = 0; i < registeredZones; ++i) {
+        if (std::string(zoneNames[i]) == name) return i;
+    }
+    // 자리가 모자라면 마지막 칸에 몰아서 센다
+    if (registeredZones >= MAX_ZONES) return MAX_ZONES - 1;
+    zoneNames[registeredZones] = name;
+    return registeredZones++;
+}
+
+int Profiler::zoneCount()
+{
+    std::lock_guard<std::mutex> lock(zoneMutex);
+    return registeredZones;
+}
+
+const char* Profiler::zoneName(int zone)
+{
+    std::lock_guard<std::mutex> lock(zoneMutex);
+    return (zone >= 0 && zone < registeredZones) ? zoneNames[zone] : "?";
+}
+
+void Profiler::endZone(int zone, double start, double end)
+{
+    current.zoneSeconds[zone] += end - start;
+    if (capturing.load(std::memory_order_relaxed)) recordEvent(threadTrace(), zone, start, end);
+}
+
+void Profiler::addGpuZone(int zone, double start, double end)
+{
+    current.zoneSeconds[zone] += end - start;
+    if (capturing.load(std::memory_order_relaxed) && gpuTrace) recordEvent(gpuTrace, zone, start, end);
+}
+
+void Profiler::countDraw(unsigned int mode, int vertexCount)
+{
+    current.drawCalls++;
+    if (mode == MODE_TRIANGLES) current.triangles += vertexCount / 3;
+}
+
+void Profiler::endFrame()
+{
+    double t = now();
+    current.frameSeconds = (lastFrameEnd > 0.0) ? t - lastFrameEnd : 0.0;
+    if (capturing.load(std::memory_order_relaxed) && lastFrameEnd > 0.0) {
+        if (frameZone < 0) frameZone = registerZone("frame");
+        recordEvent(threadTrace(), frameZone, lastFrameEnd, t);
+    }
+    lastFrameEnd = t;
+
+    ringHead = (ringHead + 1) % HISTORY_FRAMES;
+    ring[ringHead] = current;
+    ringSize = std::min(ringSize + 1, HISTORY_FRAMES);
+    current = FrameStats();
+}
+
+int Profiler::historySize()
+{
+    return ringSize;
+}
+
+const Profiler::FrameStats& Profiler::history(int ago)
+{
+    return ring[(ringHead - ago + HISTORY_FRAMES) % HISTORY_FRAMES];
+}
+
+Profiler::Summary Profiler::summarize(int zone)
+{
+    Summary s;
+    if (ringSize == 0) return s;
+
+    std::vector<double> samples;
+    samples.reserve(ringSize);
+    for (int i = 0; i < ringSize; ++i) {
+        const FrameStats& f = history(i);
+        samples.push_back(zone < 0 ? f.frameSeconds : f.zoneSeconds[zone]);
+    }
+    double total = 0.0;
+    for (double v : samples) total += v;
+    s.average = total / samples.size();
+
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(samples.size() * 0.99));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    s.p99 = samples[index];
+    s.max = *std::max_element(samples.begin(), samples.end());
+    return s;
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    ThreadTrace* t = threadTrace();
+    std::lock_guard<std::mutex> lock(traceMutex);
+    t->name = name;
+    // 캡처 중에 시작한 스레드는 기록하기 전에 여기서 버퍼를 잡는다
+    if (capturing.load()) allocateEvents(t);
+}
+
+void Profiler::startCapture(double seconds, const std::string& path)
+{
+    if (capturing) {
+        std::cout << "트레이스 캡처가 이미 진행 중" << std::endl;
+        return;
+    }
+    // 지금 있는 트랙의 버퍼를 캡처 시간 밖에서 미리 잡는다 (GPU 트랙은 메인 스레드만 쓰므로 여기서 만든다)
+    if (!gpuTrace) gpuTrace = createTrack("GPU");
+    {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        for (const auto& t : traceThreads) allocateEvents(t.get());
+    }
+    capturePath = path;
+    captureStart = now();
+    captureEnd = captureStart + seconds;
+    captureGeneration.fetch_add(1, std::memory_order_release);
+    capturing = true;
+    std::cout << "트레이스 캡처 시작: " << seconds << "초 -> " << path << std::endl;
+}
+
+bool Profiler::isCapturing()
+{
+    return capturing;
+}
+
+void Profiler::updateCapture()
+{
+    if (capturing && now() >= captureEnd) finishCapture();
+}
+
+void Profiler::finishCapture()
+{
+    if (!capturing) return;
+    capturing = false;
+    writeTrace();
+}
@@ -0,0 +1,108 @@
+﻿#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// CPU 구간 타이머. PROFILER_ENABLED를 0으로 정의하고 빌드하면
+// PROFILE_* 매크로가 모두 빈 문장이 되어 비용이 전혀 없다.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+namespace Profiler {
+    const int MAX_ZONES = 64;
+    const int HISTORY_FRAMES = 240;       // 60fps 기준 4초
+    const int TRACE_EVENTS_PER_THREAD = 1 << 18;   // 스레드당 트레이스 이벤트 수 (캡처를 시작할 때 잡는다)
+    const double DEFAULT_TRACE_SECONDS = 5.0;
+    const char* const DEFAULT_TRACE_PATH = "trace.json";
+
+    // 화면 한 장 동안 메인 스레드에서 잰 값
+    struct FrameStats {
+        double frameSeconds = 0.0;
+        double zoneSeconds[MAX_ZONES] = {};
+        uint32_t drawCalls = 0;
+        uint64_t triangles = 0;
+    };
+
+    struct Summary {
+        double average = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    inline double now() {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 구간 이름은 HUD 비트맵 글꼴로 그리므로 ASCII만 쓴다
+    int registerZone(const char* name);
+    int zoneCount();
+    const char* zoneName(int zone);
+
+    // 현재 스레드의 이번 프레임 누적값에 더하고, 캡처 중이면 트레이스 이벤트로도 남긴다
+    void endZone(int zone, double start, double end);
+    void countDraw(unsigned int mode, int vertexCount);
+    // GPU 타이머 결과 (GpuTimer가 몇 프레임 늦게 읽어 온 값). 이번 프레임 누적값에 더하고
+    // 캡처 중이면 "GPU" 트랙에 남긴다. start/end는 CPU 시계 기준으로 맞춘 값.
+    void addGpuZone(int zone, double start, double end);
+
+    // 메인 스레드에서 화면 한 장이 끝날 때마다 호출: 누적값을 기록 링에 넣고 비운다
+    void endFrame();
+
+    int historySize();
+    // ago = 0이 가장 최근 프레임
+    const FrameStats& history(int ago);
+    // 기록 링 전체의 평균/p99/최대. zone이 -1이면 프레임 시간.
+    Summary summarize(int zone);
+
+    // 트레이스 캡처 (Chrome trace-event JSON, Perfetto/chrome://tracing에서 연다).
+    // 스레드마다 이벤트 버퍼를 startCapture (캡처 중에 시작한 스레드는 setThreadName)에서 한 번 잡고 페이지를
+    // 미리 건드려 두므로 기록 중에는 할당 없이 채우기만 한다. 캡처를 하지 않으면 버퍼를 잡지 않는다.
+    // 이름은 스레드 시작 시 붙여 둔다 (이름 없이 캡처 중에 생긴 스레드의 이벤트는 버린다).
+    void setThreadName(const std::string& name);
+    void startCapture(double seconds, const std::string& path);
+    bool isCapturing();
+    // 메인 루프에서 수시로 호출: 캡처 시간이 끝났으면 멈추고 파일로 쓴다
+    void updateCapture();
+    // 시간이 남았어도 지금 멈추고 쓴다 (프로그램 종료 시)
+    void finishCapture();
+
+    // 지금 스레드에서 가장 안쪽에 열려 있는 구간 (없으면 -1). GL 호출을 구간별로 셀 때 쓴다.
+    inline int& activeZone() {
+        static thread_local int zone = -1;
+        return zone;
+    }
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(int zone) : zone(zone), parent(activeZone()), start(now()) { activeZone() = zone; }
+        ~ScopedTimer() {
+            endZone(zone, start, now());
+            activeZone() = parent;
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        int zone;
+        int parent;
+        double start;
+    };
+}
+
+#if PROFILER_ENABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_CONCAT(profileZone, __LINE__) = Profiler::registerZone(name); \
+    Profiler::ScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(PROFILE_CONCAT(profileZone, __LINE__))
+#define PROFILE_DRAW(mode, vertexCount) Profiler::countDraw((mode), (vertexCount))
+#define PROFILE_FRAME_END() Profiler::endFrame()
+#else
+#define PROFILE_SCOPE(name) do {} while (0)
+#define PROFILE_DRAW(mode, vertexCount) do {} while (0)
+#define PROFILE_FRAME_END() do {} while (0)
+#endif
@@ -0,0 +1,500 @@
+﻿#include "RenderBackend.h"
+#include "BlockCompression.h"
+#include "GlState.h"
+#include "Profiler.h"
+#include "TextureLoader.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    // 정적 객체 소멸자(Block 등)가 프로그램 종료 중에도 부를 수 있게 일부러 해제하지 않는다
+    Render::Backend* current = nullptr;
+
+    void uploadAttribute(GLuint& buffer, GLuint index, GLint components, const void* data, size_t count)
+    {
+        if (buffer == 0) glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, count * components * sizeof(float), data, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(index);
+        glVertexAttribPointer(index, components, GL_FLOAT, GL_FALSE, components * sizeof(float), (void*)0);
+    }
+}
+
+Render::GlBackend& Render::glBackend()
+{
+    static GlBackend* gl = new GlBackend();
+    return *gl;
+}
+
+Render::Backend& Render::backend()
+{
+    if (!current) current = &glBackend();
+    return *current;
+}
+
+void Render::setBackend(Backend* backend)
+{
+    current = backend;
+}
+
+Render::Mesh& Render::Mesh::operator=(Mesh&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        take(other);
+    }
+    return *this;
+}
+
+void Render::Mesh::reset()
+{
+    if (vao != 0) backend().destroyMesh(*this);
+    count = 0;
+}
+
+void Render::Mesh::take(Mesh& other)
+{
+    vao = other.vao;
+    count = other.count;
+    for (int i = 0; i < 4; ++i) {
+        buffers[i] = other.buffers[i];
+        other.buffers[i] = 0;
+    }
+    other.vao = 0;
+    other.count = 0;
+}
+
+Render::Texture& Render::Texture::operator=(Texture&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        name = other.name;
+        other.name = 0;
+    }
+    return *this;
+}
+
+void Render::Texture::reset()
+{
+    if (name == 0) return;
+    textureLoader().forget(name);
+    backend().destroyTexture(name);
+    name = 0;
+}
+
+void Render::uploadQuad(Mesh& mesh)
+{
+    const glm::vec3 positions[] = {
+        { -1.0f,  1.0f, 0.0f }, { -1.0f, -1.0f, 0.0f }, { 1.0f, -1.0f, 0.0f },
+        { -1.0f,  1.0f, 0.0f }, {  1.0f, -1.0f, 0.0f }, { 1.0f,  1.0f, 0.0f }
+    };
+    const glm::vec2 texCoords[] = {
+        { 0.0f, 1.0f }, { 0.0f, 0.0f }, { 1.0f, 0.0f },
+        { 0.0f, 1.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }
+    };
+
+    MeshData data;
+    data.positions = positions;
+    data.texCoords = texCoords;
+    data.count = 6;
+    backend().uploadMesh(mesh, data);
+}
+
+//--- GL 백엔드
+
+void Render::GlBackend::setShaders(ShaderLibrary* library, bool allowMultiView)
+{
+    shaders = library;
+    for (ProgramSlots& s : slots) s = ProgramSlots();
+    activeVariant = NO_VARIANT;
+
+    // 속성 3(정점 알파)이 없는 메시도 ALPHA 변형으로 그릴 수 있게 기본값을 1로
+    glVertexAttrib1f(3, 1.0f);
+
+    ready = shaders && shaders->get(ShaderVariant::TEXTURED | ShaderVariant::LIT) != 0;
+    multiView = ready && allowMultiView && shaders->get(ShaderVariant::MULTIVIEW | ShaderVariant::TEXTURED | ShaderVariant::LIT) != 0;
+    if (multiView && viewBuffer == 0) {
+        glGenBuffers(1, &viewBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, viewBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(ViewBlock), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, 0, viewBuffer);
+    }
+}
+
+Render::GlBackend::ProgramSlots* Render::GlBackend::useVariant(uint32_t variant)
+{
+    ProgramSlots& s = slots[variant];
+    if (!s.resolved) {
+        // 처음 쓰는 변형: 유니폼 위치는 여기서 한 번만 찾는다
+        s.resolved = true;
+        s.program = shaders ? shaders->get(variant) : 0;
+        if (s.program != 0) {
+            GLuint program = s.program;
+            s.modelLoc = glGetUniformLocation(program, "model");
+            s.normalMatrixLoc = glGetUniformLocation(program, "normalMatrix");
+            s.viewLoc = glGetUniformLocation(program, "view");
+            s.projectionLoc = glGetUniformLocation(program, "projection");
+            s.colorLoc = glGetUniformLocation(program, "vColor");
+            s.layerLoc = glGetUniformLocation(program, "layer");
+            s.lightPosLoc = glGetUniformLocation(program, "lightPos");
+            s.lightColorLoc = glGetUniformLocation(program, "lightColor");
+            s.viewPosLoc = glGetUniformLocation(program, "viewPos");
+
+            GlState::useProgram(program);
+            GLint textureLoc = glGetUniformLocation(program, "texture1");
+            if (textureLoc != -1) glUniform1i(textureLoc, 0);
+            if (variant & ShaderVariant::MULTIVIEW) {
+                GLuint blockIndex = glGetUniformBlockIndex(program, "Views");
+                if (blockIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, blockIndex, 0);
+            }
+        }
+        else {
+            std::cerr << "셰이더 변형 없음: " << ShaderVariant::name(variant) << " (이 변형의 그리기는 건너뜀)" << std::endl;
+        }
+    }
+    if (s.program == 0) return nullptr;
+
+    GlState::useProgram(s.program);
+    if (s.passSerial != passSerial) applyPassUniforms(s, variant);
+    activeVariant = variant;
+    return &s;
+}
+
+void Render::GlBackend::applyPassUniforms(ProgramSlots& s, uint32_t variant)
+{
+    s.passSerial = passSerial;
+    if (!(variant & ShaderVariant::MULTIVIEW)) {
+        if (s.viewLoc != -1) glUniformMatrix4fv(s.viewLoc, 1, GL_FALSE, &pass.view[0][0]);
+        if (s.projectionLoc != -1) glUniformMatrix4fv(s.projectionLoc, 1, GL_FALSE, &pass.projection[0][0]);
+        if (s.viewPosLoc != -1) glUniform3fv(s.viewPosLoc, 1, &pass.viewPos[0]);
+    }
+    if (variant & ShaderVariant::LIT) {
+        if (s.lightPosLoc != -1) glUniform3fv(s.lightPosLoc, 1, &pass.lightPos[0]);
+        if (s.lightColorLoc != -1) glUniform3fv(s.lightColorLoc, 1, &pass.lightColor[0]);
+    }
+}
+
+void Render::GlBackend::uploadMesh(Mesh& mesh, const MeshData& data)
+{
+    if (mesh.vao == 0) glGenVertexArrays(1, &mesh.vao);
+    GlState::bindVertexArray(mesh.vao);
+
+    if (data.positions) uploadAttribute(mesh.buffers[0], 0, 3, data.positions, data.count);
+    if (data.normals) uploadAttribute(mesh.buffers[1], 1, 3, data.normals, data.count);
+    if (data.texCoords) uploadAttribute(mesh.buffers[2], 2, 2, data.texCoords, data.count);
+    if (data.alphas) uploadAttribute(mesh.buffers[3], 3, 1, data.alphas, data.count);
+
+    GlState::bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    mesh.count = static_cast<GLsizei>(data.count);
+}
+
+void Render::GlBackend::destroyMesh(Mesh& mesh)
+{
+    if (mesh.vao != 0) GlState::deleteVertexArrays(1, &mesh.vao);
+    for (GLuint& buffer : mesh.buffers) {
+        if (buffer != 0) glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    mesh.vao = 0;
+    mesh.count = 0;
+}
+
+void* Render::GlBackend::mapStaging(int slot, size_t size)
+{
+    if (slot < 0 || slot >= STAGING_SLOTS) return nullptr;
+    StagingSlot& s = staging[slot];
+    if (s.buffer == 0) {
+        if (size == 0) return nullptr;
+        glGenBuffers(1, &s.buffer);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s.buffer);
+    if (s.memory) glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    s.memory = nullptr;
+    s.base = nullptr;
+    // 매번 새 저장 공간을 받는다 (glBufferData로 버리기). 앞 업로드가 아직 이전 공간을 읽고 있어도 기다리지 않는다.
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    if (size > 0) {
+        s.memory = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        s.base = s.memory;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return s.memory;
+}
+
+const void* Render::GlBackend::stagedPixels(int slot, const void* pixels)
+{
+    if (slot < 0 || slot >= STAGING_SLOTS || !staging[slot].base) return pixels;
+
+    // 워커가 채워 둔 PBO다. unmap하면 드라이버가 거기서 텍스처로 옮기고, CPU는 복사하지 않는다.
+    StagingSlot& s = staging[slot];
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s.buffer);
+    if (s.memory) {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        s.memory = nullptr;
+    }
+    return static_cast<const char*>(nullptr) + (static_cast<const char*>(pixels) - static_cast<const char*>(s.base));
+}
+
+void Render::GlBackend::endStaging()
+{
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void Render::GlBackend::uploadTexture(GLuint& texture, const TextureDesc& desc)
+{
+    if (texture == 0) glGenTextures(1, &texture);
+    GlState::activeTexture(GL_TEXTURE0);
+    GlState::bindTexture(GL_TEXTURE_2D, texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, desc.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, desc.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, desc.minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    if (desc.levels && desc.levelCount > 0) {
+        // 단계가 이미 있으면 그대로 올리고 밉맵을 만들지 않는다. 모자란 단계는 샘플링하지 않게 막는다.
+        int count = desc.mipmaps ? desc.levelCount : 1;
+        for (int level = 0; level < count; ++level) {
+            const TextureLevel& l = desc.levels[level];
+            const void* source = stagedPixels(desc.staging, l.pixels);
+            if (desc.format == GL_RGBA8) {
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, l.width, l.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+            }
+            else {
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, desc.format, l.width, l.height, 0, static_cast<GLsizei>(l.size), source);
+            }
+            endStaging();
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, count - 1);
+    }
+    else if (desc.pixels) {
+        GLenum format = GL_RGB;
+        if (desc.channels == 1) format = GL_RED;
+        else if (desc.channels == 4) format = GL_RGBA;
+
+        glTexImage2D(GL_TEXTURE_2D, 0, format, desc.width, desc.height, 0, format, GL_UNSIGNED_BYTE, desc.pixels);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);     // 기본값 (전에 단계를 올린 이름일 수 있다)
+        if (desc.mipmaps) glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    // 텍스처는 바인드된 채로 둔다 (다음 그리기가 어차피 필요한 것을 바인드한다)
+}
+
+void Render::GlBackend::uploadTextureArray(GLuint& texture, const TextureArrayDesc& desc)
+{
+    if (texture == 0) glGenTextures(1, &texture);
+    GlState::activeTexture(GL_TEXTURE0);
+    GlState::bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, desc.wrap);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, desc.wrap);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, desc.minFilter);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // 층 수가 바뀌어도 같은 이름에 저장 공간을 다시 잡는다
+    size_t size = BlockCompression::encodedSize(desc.format, desc.width, desc.height) * desc.layers;
+    if (desc.format == GL_RGBA8) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, desc.width, desc.height, desc.layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, desc.pixels);
+        if (desc.mipmaps) glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+    else {
+        glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, desc.format, desc.width, desc.height, desc.layers, 0,
+            static_cast<GLsizei>(size), desc.pixels);
+    }
+}
+
+void Render::GlBackend::uploadTextureLayer(GLuint texture, int layer, const TextureArrayDesc& desc)
+{
+    if (texture == 0 || !desc.pixels) return;
+    GlState::activeTexture(GL_TEXTURE0);
+    GlState::bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+
+    size_t size = BlockCompression::encodedSize(desc.format, desc.width, desc.height);
+    if (desc.format == GL_RGBA8) {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, desc.width, desc.height, 1, GL_RGBA, GL_UNSIGNED_BYTE, desc.pixels);
+        if (desc.mipmaps) glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+    else {
+        glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, desc.width, desc.height, 1, desc.format,
+            static_cast<GLsizei>(size), desc.pixels);
+    }
+}
+
+void Render::GlBackend::destroyTexture(GLuint& texture)
+{
+    if (texture != 0) GlState::deleteTextures(1, &texture);
+    texture = 0;
+}
+
+void Render::GlBackend::beginFrame(const glm::vec3& clearColor)
+{
+    // PerfHud가 프로그램 바인딩을 풀어 두므로 첫 그리기에서 다시 잡는다
+    activeVariant = NO_VARIANT;
+    instances = 1;
+    glClearColor(clearColor.r, clearColor.g, clearColor.b, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // 텍스처 유닛은 0번 하나만 쓰고 블렌드 식도 하나뿐이다
+    GlState::activeTexture(GL_TEXTURE0);
+    GlState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void Render::GlBackend::setViewport(int x, int y, int width, int height)
+{
+    glViewport(x, y, width, height);
+}
+
+void Render::GlBackend::clearDepth()
+{
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void Render::GlBackend::beginPass(const PassState& newPass)
+{
+    GlState::setEnabled(GL_DEPTH_TEST, newPass.depthTest);
+    GlState::setEnabled(GL_CULL_FACE, newPass.cullFace);
+    if (newPass.cullFace) {
+        GlState::cullFace(GL_BACK);
+        GlState::frontFace(GL_CCW);
+    }
+
+    // 패스 유니폼은 변형 프로그램을 처음 쓸 때 넣는다 (이 패스에서 안 쓰는 변형에는 안 넣는다)
+    pass = newPass;
+    ++passSerial;
+    activeVariant = NO_VARIANT;
+    passBits = pass.lighting ? ShaderVariant::LIT : 0u;
+    instances = 1;
+
+    if (pass.viewCount > 0 && multiView) {
+        // 시점 전부를 유니폼 블록 하나에 올리고, 그리기마다 시점 수만큼 인스턴스를 찍는다
+        passBits |= ShaderVariant::MULTIVIEW;
+        instances = std::min(pass.viewCount, MAX_VIEWS);
+
+        ViewBlock block;
+        for (int i = 0; i < instances; ++i) {
+            const PassView& v = pass.views[i];
+            block.viewProjections[i] = v.projection * v.view;
+            block.viewPositions[i] = glm::vec4(v.viewPos, 1.0f);
+            glViewportIndexedf(i, static_cast<GLfloat>(v.x), static_cast<GLfloat>(v.y),
+                static_cast<GLfloat>(v.width), static_cast<GLfloat>(v.height));
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, viewBuffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ViewBlock), &block);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+}
+
+void Render::GlBackend::draw(const DrawItem& item)
+{
+    uint32_t variant = passBits | itemVariant(item);
+    ProgramSlots* p = (variant == activeVariant) ? &slots[variant] : useVariant(variant);
+    if (!p) return;
+
+    if (p->modelLoc != -1) glUniformMatrix4fv(p->modelLoc, 1, GL_FALSE, &item.model[0][0]);
+    if (p->normalMatrixLoc != -1) {
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(item.model)));
+        glUniformMatrix3fv(p->normalMatrixLoc, 1, GL_FALSE, &normalMatrix[0][0]);
+    }
+    if (p->colorLoc != -1 && item.color != p->color) {
+        glUniform3f(p->colorLoc, item.color.r, item.color.g, item.color.b);
+        p->color = item.color;
+    }
+    // 텍스처 없는 변형은 샘플러가 없으니 바인딩을 그대로 둔다. 배열은 층만 바꾼다.
+    if (variant & ShaderVariant::LAYERED) {
+        GlState::bindTexture(GL_TEXTURE_2D_ARRAY, item.texture);
+        if (p->layerLoc != -1 && item.layer != p->layer) {
+            glUniform1f(p->layerLoc, static_cast<float>(item.layer));
+            p->layer = item.layer;
+        }
+    }
+    else if (variant & ShaderVariant::TEXTURED) {
+        GlState::bindTexture(GL_TEXTURE_2D, item.texture);
+    }
+    GlState::setEnabled(GL_BLEND, item.blend);
+    GlState::bindVertexArray(item.vao);
+
+    if (instances > 1) glDrawArraysInstanced(item.mode, 0, item.count, instances);
+    else glDrawArrays(item.mode, 0, item.count);
+    PROFILE_DRAW(item.mode, item.count * instances);
+}
+
+//--- Null 백엔드
+
+void Render::NullBackend::uploadMesh(Mesh& mesh, const MeshData& data)
+{
+    if (mesh.vao == 0) mesh.vao = nextName++;
+    mesh.count = static_cast<GLsizei>(data.count);
+    ++meshUploads;
+}
+
+void Render::NullBackend::destroyMesh(Mesh& mesh)
+{
+    mesh.vao = 0;
+    mesh.count = 0;
+}
+
+void Render::NullBackend::uploadTexture(GLuint& texture, const TextureDesc&)
+{
+    ++textureUploads;
+    if (texture == 0) texture = nextName++;
+}
+
+void Render::NullBackend::uploadTextureArray(GLuint& texture, const TextureArrayDesc&)
+{
+    ++textureUploads;
+    if (texture == 0) texture = nextName++;
+}
+
+void Render::NullBackend::uploadTextureLayer(GLuint, int, const TextureArrayDesc&)
+{
+    ++textureUploads;
+}
+
+void Render::NullBackend::destroyTexture(GLuint& texture)
+{
+    texture = 0;
+}
+
+void* Render::NullBackend::mapStaging(int slot, size_t size)
+{
+    if (slot < 0 || slot >= STAGING_SLOTS) return nullptr;
+    std::vector<unsigned char>().swap(staging[slot]);
+    staging[slot].resize(size);
+    return size > 0 ? staging[slot].data() : nullptr;
+}
+
+void Render::NullBackend::beginFrame(const glm::vec3&)
+{
+    frame.draws.clear();
+    frame.passes.clear();
+    frame.viewports = 0;
+    frame.vertices = 0;
+}
+
+void Render::NullBackend::setViewport(int, int, int, int)
+{
+    ++frame.viewports;
+}
+
+void Render::NullBackend::beginPass(const PassState& pass)
+{
+    frame.passes.push_back(pass);
+    frame.viewports += static_cast<uint32_t>(pass.viewCount);
+}
+
+void Render::NullBackend::draw(const DrawItem& item)
+{
+    frame.draws.push_back(item);
+    frame.vertices += static_cast<uint32_t>(item.count);
+    PROFILE_DRAW(item.mode, item.count);
+}
+
+void Render::NullBackend::endFrame()
+{
+    // 벡터 용량은 두 기록 사이에서 돌려 쓴다
+    std::swap(frame, lastFrame);
+}
@@ -0,0 +1,348 @@
+﻿#pragma once
+#include <gl/glew.h>
+#include "GlIntercept.h"
+#include <gl/glm/glm.hpp>
+#include "ShaderLibrary.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 그리기 제출 계층. Block, Snow, Snowball, 캐릭터, 화면 클래스는 GL을 직접 부르지 않고
+// 메시/텍스처 생성과 그리기를 현재 백엔드로 넘긴다.
+// GL 백엔드는 실제로 그리고, Null 백엔드는 드라이버 없이 명령만 기록한다. Null로 돌리면
+// 행렬 계산, 유니폼 값 준비 같은 CPU 쪽 렌더 준비 비용만 따로 잴 수 있다 (--headless-backend null).
+namespace Render {
+
+    // GPU 메시. GL 백엔드에서는 VAO와 속성 버퍼 이름, Null 백엔드에서는 가짜 번호다.
+    // 이름의 주인이라 복사할 수 없고, 옮기면 이름이 같이 넘어간다 (vector가 커지거나 원소를 당겨도
+    // GL 객체를 새로 만들거나 지우지 않는다). 소멸할 때 현재 백엔드로 지운다.
+    // 이름과 count는 백엔드만 채운다.
+    struct Mesh {
+        GLuint vao = 0;
+        GLuint buffers[4] = {};       // 위치, 법선, 텍스처 좌표, 알파
+        GLsizei count = 0;
+
+        Mesh() {}
+        Mesh(Mesh&& other) noexcept { take(other); }
+        Mesh& operator=(Mesh&& other) noexcept;
+        Mesh(const Mesh&) = delete;
+        Mesh& operator=(const Mesh&) = delete;
+        ~Mesh() { reset(); }
+
+        // 올린 적이 있는지
+        explicit operator bool() const { return vao != 0; }
+        // 백엔드에 지우게 하고 빈 메시로
+        void reset();
+
+    private:
+        void take(Mesh& other);
+    };
+
+    // 정점 속성 (vertex.glsl 기준 0 위치, 1 법선, 2 텍스처 좌표, 3 알파). nullptr인 속성은 만들지 않는다.
+    struct MeshData {
+        const glm::vec3* positions = nullptr;
+        const glm::vec3* normals = nullptr;
+        const glm::vec2* texCoords = nullptr;
+        const float* alphas = nullptr;
+        size_t count = 0;
+    };
+
+    // 미리 만들어 둔 밉 단계 하나. 형식은 TextureDesc::format (RGBA8이나 S3TC 블록).
+    struct TextureLevel {
+        const unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        size_t size = 0;
+    };
+
+    struct TextureDesc {
+        const unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        int channels = 3;
+        GLint wrap = GL_REPEAT;
+        GLint minFilter = GL_LINEAR;
+        bool mipmaps = true;
+        // 있으면 levels[0]이 pixels 대신 쓰이고, mipmaps면 glGenerateMipmap 없이 단계마다 그대로 올린다
+        const TextureLevel* levels = nullptr;
+        int levelCount = 0;
+        GLenum format = GL_RGBA8;   // levels의 형식. 압축 형식이면 glCompressedTexImage2D로 올린다.
+        // 0 이상이면 levels의 픽셀이 그 스테이징 슬롯(mapStaging) 안에 있다. 백엔드가 슬롯을 unmap하고
+        // 거기서 올린다 (GL은 PBO 오프셋으로). 그 뒤 슬롯은 다시 mapStaging할 때까지 쓸 수 없다.
+        int staging = -1;
+    };
+
+    // 같은 크기의 RGBA 층 여러 장 (GL_TEXTURE_2D_ARRAY). pixels는 층을 차례로 이어 붙인 것.
+    // format이 압축 형식이면 pixels는 층마다 그 형식의 블록이다 (밉맵은 만들 수 없다).
+    struct TextureArrayDesc {
+        const unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        int layers = 0;
+        GLint wrap = GL_REPEAT;
+        GLint minFilter = GL_LINEAR_MIPMAP_LINEAR;
+        bool mipmaps = true;
+        GLenum format = GL_RGBA8;
+    };
+
+    // 텍스처 이름 하나의 주인 (2D나 2D 배열). Mesh처럼 옮길 수만 있고, 소멸할 때 현재 백엔드로 지운다.
+    // TextureLoader가 아직 올리지 않은 이미지가 있으면 그 업로드도 같이 버린다.
+    // 만들기는 백엔드의 upload* 함수가 하고, 받은 이름을 여기에 넘긴다.
+    class Texture
+    {
+    public:
+        Texture() {}
+        explicit Texture(GLuint name) : name(name) {}
+        Texture(Texture&& other) noexcept : name(other.name) { other.name = 0; }
+        Texture& operator=(Texture&& other) noexcept;
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+        ~Texture() { reset(); }
+
+        GLuint get() const { return name; }
+        explicit operator bool() const { return name != 0; }
+        void reset();
+
+    private:
+        GLuint name = 0;
+    };
+
+    // 업로드 스테이징 슬롯 수 (GL에서는 PBO 링)
+    static const int STAGING_SLOTS = 3;
+
+    // 한 패스를 같이 그리는 시점 수의 한계 (분할 화면)
+    static const int MAX_VIEWS = 4;
+
+    // 분할 화면의 시점 하나: 카메라와 그 시점이 차지하는 뷰포트
+    struct PassView {
+        glm::mat4 view{ 1.0f };
+        glm::mat4 projection{ 1.0f };
+        glm::vec3 viewPos{ 0.0f };
+        int x = 0, y = 0, width = 0, height = 0;
+    };
+
+    // 패스마다 한 번 정하는 값 (카메라, 조명, 깊이/컬링)
+    struct PassState {
+        glm::mat4 view{ 1.0f };
+        glm::mat4 projection{ 1.0f };
+        glm::vec3 viewPos{ 0.0f };
+        // 0이면 위의 카메라 하나로 현재 뷰포트에 그린다. 1 이상이면 views의 시점들에
+        // 같은 그리기 목록을 그린다 (view/projection/viewPos는 쓰지 않는다).
+        int viewCount = 0;
+        PassView views[MAX_VIEWS];
+        glm::vec3 lightPos{ 0.0f };
+        glm::vec3 lightColor{ 1.0f };
+        bool lighting = false;
+        bool depthTest = true;
+        bool cullFace = false;
+    };
+
+    // 그리기 하나. texture가 0이면 color 단색으로 칠한다. layer가 0 이상이면 texture는 2D 배열이고
+    // 그 층을 쓴다 (같은 배열을 쓰는 그리기끼리는 텍스처를 다시 바인드하지 않는다).
+    // 조명 그리기의 법선 행렬은 백엔드가 model에서 물체마다 한 번 구한다.
+    struct DrawItem {
+        DrawItem() {}
+        explicit DrawItem(const Mesh& mesh, GLenum mode = GL_TRIANGLES) : vao(mesh.vao), count(mesh.count), mode(mode) {}
+
+        GLuint vao = 0;
+        GLsizei count = 0;
+        GLenum mode = GL_TRIANGLES;
+        GLuint texture = 0;
+        int layer = -1;
+        glm::mat4 model{ 1.0f };
+        glm::vec3 color{ 1.0f };
+        bool blend = false;           // 알파 블렌딩 (SRC_ALPHA, ONE_MINUS_SRC_ALPHA), 정점 알파를 쓴다
+    };
+
+    // 그리기 하나가 정하는 셰이더 변형 비트 (TEXTURED, ALPHA, LAYERED). LIT, MULTIVIEW는 패스가 정한다.
+    inline uint32_t itemVariant(const DrawItem& item)
+    {
+        uint32_t bits = item.blend ? ShaderVariant::ALPHA : 0u;
+        if (item.texture != 0) bits |= ShaderVariant::TEXTURED | (item.layer >= 0 ? ShaderVariant::LAYERED : 0u);
+        return bits;
+    }
+
+    class Backend
+    {
+    public:
+        virtual ~Backend() {}
+
+        virtual const char* getName() const = 0;
+        // 그릴 준비가 됐는지 (GL은 셰이더 프로그램이 있어야 한다)
+        virtual bool isReady() const = 0;
+        // viewCount가 있는 패스를 한 번 제출로 그릴 수 있는지. 안 되면 RenderQueue가
+        // 시점마다 뷰포트와 카메라를 바꿔 가며 같은 목록을 다시 넘긴다.
+        virtual bool supportsMultiView() const = 0;
+        // S3TC(BC1/BC3) 블록을 텍스처로 받을 수 있는지
+        virtual bool supportsBlockCompression() const = 0;
+
+        // mesh에 이미 버퍼가 있으면 다시 만들지 않고 내용만 바꾼다
+        virtual void uploadMesh(Mesh& mesh, const MeshData& data) = 0;
+        // Mesh::reset이 부른다. 이름을 지우고 mesh를 빈 것으로 돌린다.
+        virtual void destroyMesh(Mesh& mesh) = 0;
+        // texture가 0이면 만들고, 있으면 같은 이름에 다시 올린다 (크기가 달라져도 이름은 그대로).
+        // 자리표시 텍스처를 먼저 그리다가 진짜 이미지로 바꿀 때 쓴다.
+        virtual void uploadTexture(GLuint& texture, const TextureDesc& desc) = 0;
+        // texture가 0이면 만들고, 있으면 같은 이름에 층 전체를 다시 올린다 (층이 늘어도 이름은 그대로)
+        virtual void uploadTextureArray(GLuint& texture, const TextureArrayDesc& desc) = 0;
+        // 있는 배열의 layer 하나만 바꾼다. desc.pixels는 그 층 하나, desc.layers는 쓰지 않는다.
+        virtual void uploadTextureLayer(GLuint texture, int layer, const TextureArrayDesc& desc) = 0;
+        // Texture::reset이 부른다
+        virtual void destroyTexture(GLuint& texture) = 0;
+        // 스테이징 슬롯에 size 바이트를 새로 잡아 매핑하고 그 메모리를 돌려준다 (실패하면 nullptr).
+        // GL은 PBO 저장 공간을 버리고 다시 받으므로 앞 업로드가 아직 읽고 있어도 기다리지 않는다.
+        // 부르는 것은 GL 스레드지만 메모리에는 어느 스레드든 쓸 수 있고, TextureDesc::staging으로
+        // 올리거나 다시 mapStaging할 때까지 유효하다. size가 0이면 공간만 돌려준다.
+        virtual void* mapStaging(int slot, size_t size) = 0;
+
+        // 화면 한 장 시작: 색/깊이 지우기
+        virtual void beginFrame(const glm::vec3& clearColor) = 0;
+        virtual void setViewport(int x, int y, int width, int height) = 0;
+        virtual void clearDepth() = 0;
+        virtual void beginPass(const PassState& pass) = 0;
+        virtual void draw(const DrawItem& item) = 0;
+        // 그린 것을 화면에 넘기기 직전
+        virtual void endFrame() = 0;
+    };
+
+    class GlBackend : public Backend
+    {
+    public:
+        const char* getName() const override { return "gl"; }
+        bool isReady() const override { return ready; }
+        bool supportsMultiView() const override { return multiView; }
+        bool supportsBlockCompression() const override { return GLEW_EXT_texture_compression_s3tc != 0; }
+
+        // 변형을 컴파일한 뒤 make_shaderProgram이 한 번 부른다. 그리기마다 (패스 비트 | itemVariant) 변형 프로그램을 여기서 꺼낸다.
+        // allowMultiView면 MULTIVIEW 변형이 있을 때 분할 화면을 한 번에 그린다: 시점 행렬은
+        // Views 유니폼 블록으로 넘기고 인스턴스 번호로 뷰포트를 고른다.
+        void setShaders(ShaderLibrary* library, bool allowMultiView);
+
+        void uploadMesh(Mesh& mesh, const MeshData& data) override;
+        void destroyMesh(Mesh& mesh) override;
+        void uploadTexture(GLuint& texture, const TextureDesc& desc) override;
+        void uploadTextureArray(GLuint& texture, const TextureArrayDesc& desc) override;
+        void uploadTextureLayer(GLuint texture, int layer, const TextureArrayDesc& desc) override;
+        void destroyTexture(GLuint& texture) override;
+        void* mapStaging(int slot, size_t size) override;
+
+        void beginFrame(const glm::vec3& clearColor) override;
+        void setViewport(int x, int y, int width, int height) override;
+        void clearDepth() override;
+        void beginPass(const PassState& pass) override;
+        void draw(const DrawItem& item) override;
+        void endFrame() override {}
+
+    private:
+        // 변형 프로그램 하나의 유니폼 위치와 마지막으로 넣은 값.
+        // (바인드와 켜짐 상태는 GlState가 기억한다. 유니폼은 프로그램에 남으니 프로그램마다 따로 둔다)
+        struct ProgramSlots {
+            GLuint program = 0;
+            bool resolved = false;      // 라이브러리에서 꺼내 위치를 찾았는지
+            uint32_t passSerial = 0;    // 패스 유니폼을 마지막으로 넣은 패스
+            glm::vec3 color{ -1.0f };
+            int layer = -1;
+            GLint modelLoc = -1;
+            GLint normalMatrixLoc = -1;
+            GLint viewLoc = -1;
+            GLint projectionLoc = -1;
+            GLint colorLoc = -1;
+            GLint layerLoc = -1;
+            GLint lightPosLoc = -1;
+            GLint lightColorLoc = -1;
+            GLint viewPosLoc = -1;
+        };
+
+        // Views 블록 (std140): 시점별 projection * view와 눈 위치
+        struct ViewBlock {
+            glm::mat4 viewProjections[MAX_VIEWS];
+            glm::vec4 viewPositions[MAX_VIEWS];
+        };
+
+        static const uint32_t NO_VARIANT = ~0u;
+
+        // 변형 프로그램을 바인드하고 이번 패스 유니폼이 아직이면 넣는다. 프로그램이 없으면 nullptr.
+        ProgramSlots* useVariant(uint32_t variant);
+        void applyPassUniforms(ProgramSlots& slots, uint32_t variant);
+        // 스테이징 슬롯 하나: PBO와 매핑한 메모리. base는 마지막 매핑 주소 (unmap한 뒤 오프셋 계산용)
+        struct StagingSlot {
+            GLuint buffer = 0;
+            void* memory = nullptr;
+            const void* base = nullptr;
+        };
+
+        // slot이 0 이상이면 그 PBO를 unmap해서 GL_PIXEL_UNPACK_BUFFER로 바인드하고 pixels의 버퍼 안
+        // 오프셋을 돌려준다. 아니면 pixels 그대로 (클라이언트 메모리에서 바로 올린다). 다 쓰면 endStaging.
+        const void* stagedPixels(int slot, const void* pixels);
+        void endStaging();
+
+        ShaderLibrary* shaders = nullptr;
+        bool ready = false;
+        bool multiView = false;
+        ProgramSlots slots[ShaderVariant::COUNT];
+        uint32_t activeVariant = NO_VARIANT;
+
+        PassState pass;
+        uint32_t passSerial = 0;
+        uint32_t passBits = 0;          // 패스가 정한 변형 비트 (LIT, MULTIVIEW)
+        GLsizei instances = 1;          // 지금 패스의 시점 수 (그리기 하나를 몇 번 찍는지)
+        GLuint viewBuffer = 0;
+        StagingSlot staging[STAGING_SLOTS];
+    };
+
+    // 드라이버 없이 명령만 기록한다. 자원 번호는 1부터 차례로 주는 가짜 값이다.
+    class NullBackend : public Backend
+    {
+    public:
+        struct FrameRecord {
+            std::vector<DrawItem> draws;
+            std::vector<PassState> passes;
+            uint32_t viewports = 0;
+            uint32_t vertices = 0;
+        };
+
+        const char* getName() const override { return "null"; }
+        bool isReady() const override { return true; }
+        bool supportsMultiView() const override { return multiView; }
+        bool supportsBlockCompression() const override { return true; }
+        // 끄면 GL 대체 경로처럼 RenderQueue가 시점마다 다시 넘긴다 (--no-multiview 비교용)
+        void setMultiView(bool enabled) { multiView = enabled; }
+
+        void uploadMesh(Mesh& mesh, const MeshData& data) override;
+        void destroyMesh(Mesh& mesh) override;
+        void uploadTexture(GLuint& texture, const TextureDesc& desc) override;
+        void uploadTextureArray(GLuint& texture, const TextureArrayDesc& desc) override;
+        void uploadTextureLayer(GLuint texture, int layer, const TextureArrayDesc& desc) override;
+        void destroyTexture(GLuint& texture) override;
+        void* mapStaging(int slot, size_t size) override;
+
+        void beginFrame(const glm::vec3& clearColor) override;
+        void setViewport(int x, int y, int width, int height) override;
+        void clearDepth() override {}
+        void beginPass(const PassState& pass) override;
+        void draw(const DrawItem& item) override;
+        void endFrame() override;
+
+        // 마지막으로 끝난 프레임의 기록
+        const FrameRecord& getLastFrame() const { return lastFrame; }
+        uint64_t getMeshUploads() const { return meshUploads; }
+        uint64_t getTextureUploads() const { return textureUploads; }
+
+    private:
+        FrameRecord frame;
+        FrameRecord lastFrame;
+        GLuint nextName = 1;
+        bool multiView = true;
+        uint64_t meshUploads = 0;
+        uint64_t textureUploads = 0;
+        std::vector<unsigned char> staging[STAGING_SLOTS];
+    };
+
+    // 현재 백엔드 (처음에는 GL). 바꾸려면 자원을 만들기 전에 해야 한다.
+    Backend& backend();
+    void setBackend(Backend* backend);
+    GlBackend& glBackend();
+
+    // 화면 전체를 덮는 (-1~1) 사각형. 타이틀/종료 화면과 HUD 얼굴이 같이 쓴다.
+    void uploadQuad(Mesh& mesh);
+}
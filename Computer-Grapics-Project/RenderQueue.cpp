@@ -0,0 +1,161 @@
+﻿#include "RenderQueue.h"
+#include "GpuTimer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    const float MAX_SORT_DEPTH = 256.0f;
+
+    uint64_t quantizeDepth(float depth)
+    {
+        float t = std::min(std::max(depth / MAX_SORT_DEPTH, 0.0f), 1.0f);
+        return static_cast<uint64_t>(t * 65535.0f);
+    }
+}
+
+uint64_t Render::makeSortKey(uint32_t pass, const DrawItem& item, float depth)
+{
+    uint64_t variant = itemVariant(item);
+    uint64_t texture = item.texture & 0xFFFF;
+    uint64_t mesh = item.vao & 0xFFFF;
+    uint64_t key = static_cast<uint64_t>(pass & 0xF) << 60;
+
+    if (item.blend) {
+        uint64_t farFirst = 0xFFFF - quantizeDepth(depth);
+        key |= 1ull << 59;
+        key |= farFirst << 43;
+        key |= variant << 38;
+        key |= texture << 22;
+        key |= mesh << 6;
+    }
+    else {
+        key |= variant << 54;
+        key |= texture << 38;
+        key |= mesh << 22;
+        key |= quantizeDepth(depth) << 6;
+    }
+    return key;
+}
+
+//--- DrawList
+
+void Render::DrawList::begin(uint32_t newPass, const glm::vec3& newEye)
+{
+    pass = newPass;
+    eye = newEye;
+    entries.clear();
+}
+
+void Render::DrawList::add(const DrawItem& item)
+{
+    float depth = glm::length(glm::vec3(item.model[3]) - eye);
+    Entry entry;
+    entry.key = makeSortKey(pass, item, depth);
+    entry.item = item;
+    entries.push_back(entry);
+}
+
+//--- RenderQueue
+
+void Render::RenderQueue::submitRange(Backend& backend, const PassState& pass, size_t begin, size_t end, Stats& stats)
+{
+    backend.beginPass(pass);
+    ++stats.passes;
+
+    // 정렬하고 나면 맵/눈/캐릭터/눈덩이 그리기가 섞여서 생산자별 GPU 시간은 잴 수 없다.
+    // 대신 패스 안에서 불투명이 먼저, 반투명이 뒤에 모여 있으니 그 경계로 나눠 잰다.
+    size_t split = begin;
+    while (split < end && !entries[order[split].second].item.blend) ++split;
+
+    const DrawItem* previous = nullptr;
+    if (split > begin) {
+        GPU_SCOPE("gpu.opaque");
+        drawRange(backend, begin, split, stats, previous);
+    }
+    if (end > split) {
+        GPU_SCOPE("gpu.blend");
+        drawRange(backend, split, end, stats, previous);
+    }
+}
+
+void Render::RenderQueue::drawRange(Backend& backend, size_t begin, size_t end, Stats& stats, const DrawItem*& previous)
+{
+    for (size_t i = begin; i < end; ++i) {
+        const DrawItem& item = entries[order[i].second].item;
+        if (previous) {
+            if (item.texture != previous->texture) ++stats.textureChanges;
+            if (item.vao != previous->vao) ++stats.meshChanges;
+            if (item.blend != previous->blend) ++stats.blendChanges;
+            if (itemVariant(item) != itemVariant(*previous)) ++stats.variantChanges;
+        }
+        backend.draw(item);
+        ++stats.draws;
+        previous = &item;
+    }
+}
+
+uint32_t Render::RenderQueue::addPass(const PassState& pass)
+{
+    if (passes.size() >= MAX_PASSES) {
+        std::cerr << "렌더 큐 패스 초과 (" << MAX_PASSES << "), 마지막 패스에 합침" << std::endl;
+        return MAX_PASSES - 1;
+    }
+    passes.push_back(pass);
+    return static_cast<uint32_t>(passes.size() - 1);
+}
+
+void Render::RenderQueue::append(const DrawList& list)
+{
+    entries.insert(entries.end(), list.getEntries().begin(), list.getEntries().end());
+}
+
+void Render::RenderQueue::execute(Backend& backend)
+{
+    {
+        PROFILE_SCOPE("queue.sort");
+        // 키가 같으면 넣은 순서대로 (인덱스가 키 뒤에 붙어 있어 결과가 항상 같다)
+        order.clear();
+        order.reserve(entries.size());
+        for (uint32_t i = 0; i < entries.size(); ++i) order.push_back(std::make_pair(entries[i].key, i));
+        std::sort(order.begin(), order.end());
+    }
+
+    PROFILE_SCOPE("queue.submit");
+    Stats stats;
+    const bool multiView = backend.supportsMultiView();
+    size_t begin = 0;
+    while (begin < order.size()) {
+        // 같은 패스의 그리기는 키 맨 위 비트가 같아서 붙어 있다
+        uint32_t pass = static_cast<uint32_t>(order[begin].first >> 60);
+        size_t end = begin + 1;
+        while (end < order.size() && static_cast<uint32_t>(order[end].first >> 60) == pass) ++end;
+
+        if (pass >= passes.size()) {
+            begin = end;
+            continue;
+        }
+        const PassState& state = passes[pass];
+        if (state.viewCount > 0 && !multiView) {
+            // 대체 경로: 시점마다 뷰포트와 카메라만 바꿔 같은 범위를 다시 넘긴다
+            for (int v = 0; v < state.viewCount && v < MAX_VIEWS; ++v) {
+                const PassView& view = state.views[v];
+                PassState single = state;
+                single.viewCount = 0;
+                single.view = view.view;
+                single.projection = view.projection;
+                single.viewPos = view.viewPos;
+                backend.setViewport(view.x, view.y, view.width, view.height);
+                submitRange(backend, single, begin, end, stats);
+            }
+        }
+        else {
+            submitRange(backend, state, begin, end, stats);
+        }
+        begin = end;
+    }
+
+    lastStats = stats;
+    passes.clear();
+    entries.clear();
+}
@@ -0,0 +1,76 @@
+﻿#pragma once
+#include "RenderBackend.h"
+#include <cstdint>
+#include <vector>
+
+// 정렬 그리기 큐. 물체는 백엔드에 바로 그리지 않고 DrawList에 넣고, 큐가 모아서
+// 64비트 키 순서로 정렬한 뒤 한 번에 백엔드로 넘긴다. 같은 텍스처/메시/블렌드를 쓰는
+// 그리기가 붙어서 나오므로 백엔드가 상태를 다시 잡는 횟수가 줄어든다.
+//
+// 키 (상위 비트부터):
+//   불투명  pass 4 | blend 0 | variant 5 | texture 16 | mesh 16 | depth 16 (가까운 것 먼저) | 0 6
+//   반투명  pass 4 | blend 1 | depth 16 (먼 것 먼저) | variant 5 | texture 16 | mesh 16 | 0 6
+// blend 비트가 variant보다 위에 있어서 반투명은 항상 그 패스의 불투명 뒤에 그려진다.
+namespace Render {
+
+    // variant: 그리기가 정하는 셰이더 변형 비트 (TEXTURED, ALPHA, LAYERED). 같은 변형끼리 모여 프로그램 전환이 준다
+    uint64_t makeSortKey(uint32_t pass, const DrawItem& item, float depth);
+
+    // 생산자(맵, 눈, 캐릭터, 눈덩이) 하나가 채우는 목록. 목록끼리는 공유하는 것이 없어서
+    // 따로 채울 수 있고 (스레드마다 하나씩), 다 채운 뒤 RenderQueue::append로 합친다.
+    class DrawList
+    {
+    public:
+        struct Entry {
+            uint64_t key;
+            DrawItem item;
+        };
+
+        // pass는 RenderQueue::addPass가 준 번호, eye는 깊이 정렬 기준 (보통 PassState::viewPos)
+        void begin(uint32_t pass, const glm::vec3& eye);
+        void add(const DrawItem& item);
+
+        size_t size() const { return entries.size(); }
+        const std::vector<Entry>& getEntries() const { return entries; }
+
+    private:
+        uint32_t pass = 0;
+        glm::vec3 eye{ 0.0f };
+        std::vector<Entry> entries;
+    };
+
+    class RenderQueue
+    {
+    public:
+        static const uint32_t MAX_PASSES = 16;
+
+        // 정렬 뒤 실행 순서에서 인접한 그리기끼리 바뀐 상태 수 (draws, passes는 backend에 넘긴 횟수)
+        struct Stats {
+            uint32_t draws = 0;
+            uint32_t passes = 0;
+            uint32_t textureChanges = 0;
+            uint32_t meshChanges = 0;
+            uint32_t blendChanges = 0;
+            uint32_t variantChanges = 0;    // 그리기 쪽 변형 비트가 바뀐 수 (프로그램 전환)
+        };
+
+        uint32_t addPass(const PassState& pass);
+        void append(const DrawList& list);
+
+        // 정렬해서 backend로 넘기고 큐를 비운다. 시점이 여럿인 패스를 backend가 한 번에
+        // 못 그리면 (supportsMultiView) 그 패스의 그리기를 시점마다 다시 넘긴다.
+        void execute(Backend& backend);
+
+        const Stats& getLastStats() const { return lastStats; }
+
+    private:
+        void submitRange(Backend& backend, const PassState& pass, size_t begin, size_t end, Stats& stats);
+        // previous는 바로 앞에 넘긴 그리기 (상태 전환 수를 세는 데 쓴다)
+        void drawRange(Backend& backend, size_t begin, size_t end, Stats& stats, const DrawItem*& previous);
+
+        std::vector<PassState> passes;
+        std::vector<DrawList::Entry> entries;
+        std::vector<std::pair<uint64_t, uint32_t>> order;   // (키, entries 인덱스)
+        Stats lastStats;
+    };
+}
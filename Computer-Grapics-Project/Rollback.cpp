@@ -0,0 +1,337 @@
+﻿#include "Rollback.h"
+#include "NetGame.h"
+#include "SimLog.h"
+#include <algorithm>
+
+namespace {
+
+const uint32_t ROLLBACK_PROTOCOL_ID = 0x534E5242; // 'SNRB'
+const uint32_t NO_TICK = 0xFFFFFFFFu;
+const int MAX_INPUTS_PER_ROLLBACK_PACKET = 16;
+const int STATE_RING = MAX_ROLLBACK_TICKS + 2;
+
+bool sameInput(const PlayerInput& a, const PlayerInput& b)
+{
+    return a.moveDir == b.moveDir && a.aim == b.aim && a.throwHeld == b.throwHeld;
+}
+
+} // namespace
+
+RollbackSession::RollbackSession()
+{
+}
+
+bool RollbackSession::start(int player, uint16_t localPort, const NetConditions& conditions, int delay)
+{
+    if (!socket.open(localPort)) return false;
+    socket.setConditions(conditions);
+
+    localPlayer = player;
+    inputDelay = std::max(0, std::min(delay, MAX_ROLLBACK_TICKS));
+    world.initialize();
+    std::cout << "P2P 세션 시작: 포트 " << socket.getLocalPort() << ", " << (player == 0 ? "Steve" : "Alex")
+        << " 조작, 입력 지연 " << inputDelay << "틱" << std::endl;
+    return true;
+}
+
+void RollbackSession::stop()
+{
+    socket.close();
+    world.reset();
+}
+
+bool RollbackSession::remoteConfirmedThrough(uint32_t tick) const
+{
+    return remoteConfirmed >= static_cast<int64_t>(tick);
+}
+
+PlayerInput RollbackSession::remoteInputFor(uint32_t tick) const
+{
+    const InputSlot& slot = remoteInputs[tick % ROLLBACK_INPUT_RING];
+    if (remoteConfirmedThrough(tick) && slot.tick == tick) return slot.input;
+
+    // 예측: 마지막으로 확정된 입력이 계속된다고 본다
+    if (remoteConfirmed >= 0) return remoteInputs[remoteConfirmed % ROLLBACK_INPUT_RING].input;
+    return PlayerInput();
+}
+
+void RollbackSession::simulateTick(uint32_t tick)
+{
+    SavedState& saved = savedStates[tick % STATE_RING];
+    world.saveState(saved.snapshot);
+    saved.tick = tick;
+
+    // 이 틱 이전의 입력이 모두 확정됐다면 지금 상태는 다시 바뀌지 않는다
+    if (tick == 0 || remoteConfirmedThrough(tick - 1)) {
+        if (confirmedChecksums.find(tick) == confirmedChecksums.end()) {
+            uint32_t hash = world.checksum();
+            confirmedChecksums[tick] = hash;
+            while (confirmedChecksums.size() > 128) confirmedChecksums.erase(confirmedChecksums.begin());
+
+            auto it = peerChecksums.find(tick);
+            if (it != peerChecksums.end()) {
+                stats.checksumsCompared++;
+                if (it->second != hash) {
+                    stats.desyncs++;
+                    std::cerr << "동기화 어긋남 감지: 틱 " << tick << std::endl;
+                }
+                peerChecksums.erase(it);
+            }
+        }
+    }
+
+    const InputSlot& local = localInputs[tick % ROLLBACK_INPUT_RING];
+    PlayerInput inputs[PLAYER_COUNT];
+    inputs[localPlayer] = (local.tick == tick) ? local.input : PlayerInput();
+    inputs[1 - localPlayer] = remoteInputFor(tick);
+    usedRemote[tick % ROLLBACK_INPUT_RING] = inputs[1 - localPlayer];
+
+    world.tick(inputs);
+}
+
+void RollbackSession::advanceFrame(const PlayerInput& localInput)
+{
+    stats.frames++;
+    receivePackets();
+
+    // 1. 예측이 틀린 틱이 있으면 되돌아가서 현재 틱까지 재시뮬레이션
+    lastRollbackDepth = 0;
+    lastResimulateTime = 0.0;
+    if (firstMispredicted < currentTick) {
+        const SavedState& saved = savedStates[firstMispredicted % STATE_RING];
+        if (saved.tick == firstMispredicted) {
+            double start = Net::now();
+            world.loadState(saved.snapshot);
+            {
+                SimLog::Mute mute;
+                for (uint32_t t = firstMispredicted; t < currentTick; ++t) simulateTick(t);
+            }
+            lastResimulateTime = Net::now() - start;
+            lastRollbackDepth = static_cast<int>(currentTick - firstMispredicted);
+
+            stats.rollbacks++;
+            stats.resimulatedTicks += lastRollbackDepth;
+            stats.resimulateTime += lastResimulateTime;
+            stats.maxResimulateTime = std::max(stats.maxResimulateTime, lastResimulateTime);
+        }
+        else {
+            std::cerr << "롤백 상태 없음: 틱 " << firstMispredicted << std::endl;
+        }
+    }
+    firstMispredicted = NO_TICK;
+    stats.depthHistogram[std::min(lastRollbackDepth, MAX_ROLLBACK_TICKS)]++;
+
+    // 2. 상대 입력 없이 너무 멀리 앞서가면 기다린다
+    if (static_cast<int64_t>(currentTick) > remoteConfirmed + MAX_ROLLBACK_TICKS) {
+        stats.stalls++;
+        sendInputs();
+        socket.flush();
+        return;
+    }
+
+    // 3. 상대보다 꾸준히 앞서 있으면 가끔 한 프레임 쉬어서 롤백 깊이를 줄인다
+    int localAdvantage = static_cast<int>(currentTick) - static_cast<int>(peerTick);
+    if (peerTick > 0 && (localAdvantage - peerAdvantage) / 2 >= 1 && currentTick - lastTimeSyncWait > 10) {
+        lastTimeSyncWait = currentTick;
+        stats.timeSyncWaits++;
+        sendInputs();
+        socket.flush();
+        return;
+    }
+
+    // 4. 내 입력은 inputDelay 틱 뒤에 적용 (상대가 미리 받을 시간을 준다)
+    uint32_t inputTick = currentTick + inputDelay;
+    InputSlot& slot = localInputs[inputTick % ROLLBACK_INPUT_RING];
+    slot.input = quantizePlayerInput(localInput);
+    slot.tick = inputTick;
+
+    double start = Net::now();
+    simulateTick(currentTick);
+    stats.simulateTime += Net::now() - start;
+    ++currentTick;
+
+    sendInputs();
+    socket.flush();
+}
+
+void RollbackSession::sendInputs()
+{
+    if (peer.port == 0) return;
+
+    // 상대가 확인한 다음 틱부터 지금까지 정한 입력을 모두 (최대 16개) 다시 보낸다
+    int64_t newest = static_cast<int64_t>(currentTick) + inputDelay - 1;
+    int64_t first = std::max<int64_t>(localAckedByPeer + 1, newest - ROLLBACK_INPUT_RING + 1);
+    first = std::max<int64_t>(first, 0);
+    int count = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(newest - first + 1, MAX_INPUTS_PER_ROLLBACK_PACKET)));
+
+    BitWriter w;
+    w.writeBits(ROLLBACK_PROTOCOL_ID, 32);
+    w.writeBits(currentTick, 32);
+    w.writeSigned(std::max(-127, std::min(127, static_cast<int>(currentTick) - static_cast<int>(peerTick))), 8);
+    w.writeBits(static_cast<uint32_t>(remoteConfirmed + 1), 32);
+    w.writeBits(static_cast<uint32_t>(first), 32);
+    w.writeBits(static_cast<uint32_t>(count), 5);
+    for (int i = 0; i < count; ++i) {
+        uint32_t tick = static_cast<uint32_t>(first + i);
+        const InputSlot& slot = localInputs[tick % ROLLBACK_INPUT_RING];
+        writePlayerInput(w, slot.tick == tick ? slot.input : PlayerInput());
+    }
+
+    bool hasChecksum = !confirmedChecksums.empty();
+    w.writeBool(hasChecksum);
+    if (hasChecksum) {
+        w.writeBits(confirmedChecksums.rbegin()->first, 32);
+        w.writeBits(confirmedChecksums.rbegin()->second, 32);
+    }
+
+    socket.send(peer, w.data().data(), w.byteCount());
+}
+
+void RollbackSession::receivePackets()
+{
+    uint8_t buffer[1500];
+    NetAddress from;
+    int size;
+    while ((size = socket.receive(from, buffer, sizeof(buffer))) > 0) {
+        if (from != peer) continue;
+        handlePacket(buffer, static_cast<size_t>(size));
+    }
+}
+
+void RollbackSession::handlePacket(const uint8_t* data, size_t size)
+{
+    BitReader r(data, size);
+    if (r.readBits(32) != ROLLBACK_PROTOCOL_ID) return;
+
+    uint32_t senderTick = r.readBits(32);
+    int senderAdvantage = r.readSigned(8);
+    int64_t ack = static_cast<int64_t>(r.readBits(32)) - 1;
+    uint32_t first = r.readBits(32);
+    int count = static_cast<int>(r.readBits(5));
+    PlayerInput inputs[MAX_INPUTS_PER_ROLLBACK_PACKET];
+    for (int i = 0; i < count && i < MAX_INPUTS_PER_ROLLBACK_PACKET; ++i) inputs[i] = readPlayerInput(r);
+    bool hasChecksum = r.readBool();
+    uint32_t checksumTick = 0, checksum = 0;
+    if (hasChecksum) {
+        checksumTick = r.readBits(32);
+        checksum = r.readBits(32);
+    }
+    if (r.overflowed()) return;
+
+    if (senderTick >= peerTick) {
+        peerTick = senderTick;
+        peerAdvantage = senderAdvantage;
+    }
+    localAckedByPeer = std::max(localAckedByPeer, ack);
+
+    for (int i = 0; i < count && i < MAX_INPUTS_PER_ROLLBACK_PACKET; ++i) {
+        uint32_t tick = first + i;
+        // 빠짐없이 이어지는 입력만 확정 (빠진 건 다음 패킷에 다시 온다)
+        if (static_cast<int64_t>(tick) != remoteConfirmed + 1) continue;
+
+        InputSlot& slot = remoteInputs[tick % ROLLBACK_INPUT_RING];
+        slot.input = inputs[i];
+        slot.tick = tick;
+        remoteConfirmed = tick;
+
+        if (tick < currentTick && !sameInput(usedRemote[tick % ROLLBACK_INPUT_RING], inputs[i])) {
+            firstMispredicted = std::min(firstMispredicted, tick);
+        }
+    }
+
+    if (hasChecksum) {
+        auto it = confirmedChecksums.find(checksumTick);
+        if (it != confirmedChecksums.end()) {
+            stats.checksumsCompared++;
+            if (it->second != checksum) {
+                stats.desyncs++;
+                std::cerr << "동기화 어긋남 감지: 틱 " << checksumTick << std::endl;
+            }
+        }
+        else if (checksumTick > (confirmedChecksums.empty() ? 0 : confirmedChecksums.rbegin()->first)) {
+            peerChecksums[checksumTick] = checksum;
+            while (peerChecksums.size() > 128) peerChecksums.erase(peerChecksums.begin());
+        }
+    }
+}
+
+void RollbackSession::printStats() const
+{
+    const RollbackStats& s = stats;
+    uint32_t simulated = s.frames - s.stalls - s.timeSyncWaits;
+    double tickCost = simulated ? s.simulateTime / simulated : 0.0;
+
+    std::cout << "[" << (localPlayer == 0 ? "Steve" : "Alex") << "] 프레임 " << s.frames
+        << ", 롤백 " << s.rollbacks << " (" << (s.frames ? 100.0 * s.rollbacks / s.frames : 0.0) << "%)"
+        << ", 대기 " << s.stalls << ", 시간 동기화 " << s.timeSyncWaits << std::endl;
+    std::cout << "  롤백 깊이 분포:";
+    for (int d = 0; d <= MAX_ROLLBACK_TICKS; ++d) std::cout << " " << d << ":" << s.depthHistogram[d];
+    std::cout << std::endl;
+    std::cout << "  재시뮬레이션: 평균 " << (s.rollbacks ? s.resimulatedTicks / static_cast<double>(s.rollbacks) : 0.0)
+        << "틱, " << (s.rollbacks ? s.resimulateTime / s.rollbacks * 1000.0 : 0.0) << "ms/프레임, 최대 "
+        << s.maxResimulateTime * 1000.0 << "ms" << std::endl;
+    std::cout << "  1틱 비용 " << tickCost * 1000000.0 << "us, " << MAX_ROLLBACK_TICKS << "틱 롤백 예상 "
+        << tickCost * MAX_ROLLBACK_TICKS * 1000.0 << "ms (예산 " << TICK_DELTA_TIME * 1000.0 << "ms)" << std::endl;
+    std::cout << "  체크섬 비교 " << s.checksumsCompared << ", 불일치 " << s.desyncs << std::endl;
+}
+
+int runRollbackSelfTest(float seconds, const NetConditions& conditions, int inputDelay)
+{
+    Init::graphicsEnabled() = false;
+    if (!Net::initialize()) return 1;
+
+    RollbackSession sessions[PLAYER_COUNT];
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        if (!sessions[i].start(i, 0, conditions, inputDelay)) return 1;
+    }
+    NetAddress address;
+    NetAddress::parse("127.0.0.1", sessions[1].getPort(), address);
+    sessions[0].setPeer(address);
+    NetAddress::parse("127.0.0.1", sessions[0].getPort(), address);
+    sessions[1].setPeer(address);
+
+    // 봇 입력은 불규칙해서 예측이 자주 틀린다
+    InputBot bots[PLAYER_COUNT] = { InputBot(0, 11), InputBot(1, 12) };
+
+    SimLog::Mute mute;
+    double start = Net::now();
+    double nextFrame = start;
+    double lastReport = start;
+    int frame = 0;
+    int windowMaxDepth = 0;
+    double windowMaxCost = 0.0;
+    while (Net::now() - start < seconds) {
+        for (int i = 0; i < PLAYER_COUNT; ++i) {
+            sessions[i].advanceFrame(bots[i].next());
+            windowMaxDepth = std::max(windowMaxDepth, sessions[i].getLastRollbackDepth());
+            windowMaxCost = std::max(windowMaxCost, sessions[i].getLastResimulateTime());
+        }
+        ++frame;
+
+        if (Net::now() - lastReport >= 1.0) {
+            std::cout << "[" << static_cast<int>(Net::now() - start) << "s] 틱 " << sessions[0].getCurrentTick()
+                << "/" << sessions[1].getCurrentTick() << ", 최대 롤백 깊이 " << windowMaxDepth
+                << ", 최대 재시뮬레이션 " << windowMaxCost * 1000.0 << "ms" << std::endl;
+            lastReport = Net::now();
+            windowMaxDepth = 0;
+            windowMaxCost = 0.0;
+        }
+
+        nextFrame += TICK_DELTA_TIME;
+        double wait = nextFrame - Net::now();
+        if (wait > 0.0) Net::sleepMs(static_cast<int>(wait * 1000.0));
+    }
+
+    std::cout << "\n=== 롤백 자체 테스트 (" << seconds << "초, 지연 " << conditions.latencyMs << "ms, 지터 "
+        << conditions.jitterMs << "ms, 손실 " << conditions.lossPercent << "%, 입력 지연 " << inputDelay << "틱) ===" << std::endl;
+    bool pass = true;
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        sessions[i].printStats();
+        const RollbackStats& s = sessions[i].getStats();
+        if (s.desyncs > 0 || s.checksumsCompared == 0) pass = false;
+    }
+    std::cout << (pass ? "PASS" : "FAIL") << std::endl;
+
+    Net::shutdown();
+    return pass ? 0 : 1;
+}
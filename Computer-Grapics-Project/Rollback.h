@@ -0,0 +1,98 @@
+﻿#pragma once
+#include <cstdint>
+#include <map>
+#include "Net.h"
+#include "GameWorld.h"
+
+constexpr int MAX_ROLLBACK_TICKS = 8;      // 이보다 더 앞서가면 상대 입력을 기다린다
+constexpr int ROLLBACK_INPUT_RING = 64;
+constexpr int DEFAULT_INPUT_DELAY = 2;
+
+struct RollbackStats {
+    uint32_t frames = 0;
+    uint32_t rollbacks = 0;            // 롤백이 일어난 프레임 수
+    uint32_t stalls = 0;               // 상대 입력이 너무 늦어 멈춘 프레임 수
+    uint32_t timeSyncWaits = 0;        // 상대보다 앞서서 한 프레임 쉰 횟수
+    uint32_t depthHistogram[MAX_ROLLBACK_TICKS + 1] = {};
+    uint64_t resimulatedTicks = 0;
+    double resimulateTime = 0.0;       // 초
+    double maxResimulateTime = 0.0;
+    double simulateTime = 0.0;         // 정상 진행 틱에 쓴 시간
+    uint32_t checksumsCompared = 0;
+    uint32_t desyncs = 0;
+};
+
+// GGPO 방식의 1:1 P2P 세션.
+// 상대 입력이 아직 안 왔으면 마지막 입력을 그대로 쓴다고 예측하고 진행하다가,
+// 실제 입력이 예측과 다르면 그 틱의 상태로 되돌아가 현재 틱까지 다시 시뮬레이션한다.
+class RollbackSession
+{
+public:
+    RollbackSession();
+
+    bool start(int localPlayer, uint16_t localPort, const NetConditions& conditions, int inputDelay = DEFAULT_INPUT_DELAY);
+    void setPeer(const NetAddress& address) { peer = address; }
+    void stop();
+
+    // 프레임마다 한 번 호출. 필요하면 롤백 후 한 틱 진행한다.
+    void advanceFrame(const PlayerInput& localInput);
+
+    GameWorld& getWorld() { return world; }
+    int getLocalPlayer() const { return localPlayer; }
+    uint16_t getPort() const { return socket.getLocalPort(); }
+    uint32_t getCurrentTick() const { return currentTick; }
+    int getLastRollbackDepth() const { return lastRollbackDepth; }
+    double getLastResimulateTime() const { return lastResimulateTime; }
+    const RollbackStats& getStats() const { return stats; }
+    void printStats() const;
+
+private:
+    struct InputSlot {
+        PlayerInput input;
+        uint32_t tick = 0xFFFFFFFFu;
+    };
+
+    struct SavedState {
+        WorldSnapshot snapshot;
+        uint32_t tick = 0xFFFFFFFFu;
+    };
+
+    bool remoteConfirmedThrough(uint32_t tick) const;
+    PlayerInput remoteInputFor(uint32_t tick) const;
+    void simulateTick(uint32_t tick);
+    void receivePackets();
+    void handlePacket(const uint8_t* data, size_t size);
+    void sendInputs();
+
+    UdpSocket socket;
+    NetAddress peer;
+    GameWorld world;
+    int localPlayer = 0;
+    int inputDelay = DEFAULT_INPUT_DELAY;
+
+    uint32_t currentTick = 0;                   // 다음에 시뮬레이션할 틱
+    int64_t remoteConfirmed = -1;               // 여기까지 상대 입력을 빠짐없이 받음
+    int64_t localAckedByPeer = -1;              // 상대가 여기까지 내 입력을 받음
+    uint32_t firstMispredicted = 0xFFFFFFFFu;
+
+    InputSlot localInputs[ROLLBACK_INPUT_RING];
+    InputSlot remoteInputs[ROLLBACK_INPUT_RING];
+    PlayerInput usedRemote[ROLLBACK_INPUT_RING]; // 시뮬레이션에 실제로 쓴 (예측) 입력
+    SavedState savedStates[MAX_ROLLBACK_TICKS + 2];
+
+    // 양쪽 입력이 모두 확정된 틱의 상태 해시 (동기화 검사)
+    std::map<uint32_t, uint32_t> confirmedChecksums;
+    std::map<uint32_t, uint32_t> peerChecksums;
+
+    // 시간 동기화: 양쪽이 서로 얼마나 앞서 있는지 (GGPO의 frame advantage)
+    uint32_t peerTick = 0;
+    int peerAdvantage = 0;
+    uint32_t lastTimeSyncWait = 0;
+
+    int lastRollbackDepth = 0;
+    double lastResimulateTime = 0.0;
+    RollbackStats stats;
+};
+
+// 같은 프로세스에서 두 피어를 루프백으로 연결해 롤백 깊이/재시뮬레이션 비용을 보고
+int runRollbackSelfTest(float seconds, const NetConditions& conditions, int inputDelay);
@@ -0,0 +1,410 @@
+﻿#include "ShaderLibrary.h"
+#include "AssetPack.h"
+#include "GlState.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace {
+    const char* const BIT_NAMES[] = { "TEXTURED", "LIT", "ALPHA", "MULTIVIEW", "LAYERED" };
+    const int BIT_COUNT = sizeof(BIT_NAMES) / sizeof(BIT_NAMES[0]);
+
+    // 에셋 팩에 있으면 팩에서, 없으면 작업 폴더에서
+    bool readFile(const char* path, std::string& out)
+    {
+        AssetPack::View packed = assetPack().find(path);
+        if (packed) {
+            out.assign(reinterpret_cast<const char*>(packed.data), packed.size);
+            return true;
+        }
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        out = buffer.str();
+        return true;
+    }
+
+    // 캐시 파일: 헤더 (magic, version, 항목 수) 뒤에 항목마다 키, 바이너리 형식, 길이, 바이너리
+    const uint32_t CACHE_MAGIC = 0x43424853;     // "SHBC"
+    const uint32_t CACHE_VERSION = 1;
+    const uint32_t CACHE_MAX_BINARY = 64u << 20;  // 이보다 큰 길이는 깨진 파일로 본다
+
+    uint64_t fnv1a64(uint64_t hash, const std::string& text)
+    {
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        // 이어 붙인 문자열끼리 경계가 섞이지 않게 구분자도 넣는다
+        hash ^= 0xff;
+        hash *= 1099511628211ull;
+        return hash;
+    }
+
+    std::string glString(GLenum name)
+    {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+
+    // #version은 맨 앞이어야 하니 그 줄 바로 뒤에 넣는다. 상태는 묻지 않는다 (finishBuild에서).
+    GLuint createShader(GLenum type, const std::string& source, uint32_t variant)
+    {
+        std::string text(source);
+        size_t lineEnd = text.find('\n');
+        text.insert(lineEnd == std::string::npos ? text.size() : lineEnd + 1, ShaderVariant::defines(variant));
+        const GLchar* sourceText = text.c_str();
+
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &sourceText, 0);
+        glCompileShader(shader);
+        return shader;
+    }
+
+    // 컴파일에 실패했으면 로그를 찍고 true
+    bool reportCompileError(GLuint shader, const char* stage, uint32_t variant)
+    {
+        GLint result;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
+        if (result) return false;
+
+        GLchar errorLog[512];
+        glGetShaderInfoLog(shader, 512, NULL, errorLog);
+        std::cerr << "ERROR: " << stage << " shader 컴파일 실패 (" << ShaderVariant::name(variant) << ")\n" << errorLog << std::endl;
+        return true;
+    }
+
+    // 캐시 팩 안의 바이트를 복사 없이 istream으로 읽는다
+    struct MemoryBuffer : std::streambuf {
+        MemoryBuffer(const unsigned char* data, size_t size)
+        {
+            char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+            setg(begin, begin, begin + size);
+        }
+    };
+
+    template <typename T>
+    bool readValue(std::istream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    template <typename T>
+    void writeValue(std::ofstream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+}
+
+std::string ShaderVariant::defines(uint32_t variant)
+{
+    std::string out;
+    for (int bit = 0; bit < BIT_COUNT; ++bit) {
+        if (variant & (1u << bit)) out += std::string("#define ") + BIT_NAMES[bit] + "\n";
+    }
+    return out;
+}
+
+std::string ShaderVariant::name(uint32_t variant)
+{
+    std::string out;
+    for (int bit = 0; bit < BIT_COUNT; ++bit) {
+        if (!(variant & (1u << bit))) continue;
+        if (!out.empty()) out += "|";
+        out += BIT_NAMES[bit];
+    }
+    return out.empty() ? "BASE" : out;
+}
+
+ShaderLibrary::Program& ShaderLibrary::Program::operator=(Program&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        name = other.name;
+        other.name = 0;
+    }
+    return *this;
+}
+
+void ShaderLibrary::Program::reset()
+{
+    if (name == 0) return;
+    GlState::useProgram(0);
+    glDeleteProgram(name);
+    name = 0;
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+    // 전역 객체라 GL 컨텍스트보다 늦게 사라질 수 있다. 지우는 것은 destroy에서만.
+    for (Program& program : programs) program.release();
+}
+
+bool ShaderLibrary::load(const char* vertexPath, const char* fragmentPath)
+{
+    destroy();
+    if (!readFile(vertexPath, vertexSource)) {
+        std::cerr << "셰이더 파일 읽기 실패: " << vertexPath << std::endl;
+        return false;
+    }
+    if (!readFile(fragmentPath, fragmentSource)) {
+        std::cerr << "셰이더 파일 읽기 실패: " << fragmentPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+ShaderLibrary::Pending ShaderLibrary::beginBuild(uint32_t variant)
+{
+    Pending pending;
+    pending.vertex = createShader(GL_VERTEX_SHADER, vertexSource, variant);
+    pending.fragment = createShader(GL_FRAGMENT_SHADER, fragmentSource, variant);
+    pending.program = Program(glCreateProgram());
+    GLuint program = pending.program.get();
+    glAttachShader(program, pending.vertex);
+    glAttachShader(program, pending.fragment);
+    if (binaryCacheEnabled()) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+    return pending;
+}
+
+GLuint ShaderLibrary::finishBuild(uint32_t variant, Pending& pending)
+{
+    // 병렬 컴파일 드라이버는 여기서 그 프로그램이 끝날 때까지 기다린다
+    GLint result;
+    GLuint program = pending.program.get();
+    glGetProgramiv(program, GL_LINK_STATUS, &result);
+    if (!result) {
+        // 컴파일이 실패했으면 그 로그를, 아니면 링크 로그를 보여 준다
+        if (!reportCompileError(pending.vertex, "vertex", variant) && !reportCompileError(pending.fragment, "fragment", variant)) {
+            GLchar errorLog[512];
+            glGetProgramInfoLog(program, 512, NULL, errorLog);
+            std::cerr << "ERROR: shader program 링크 실패 (" << ShaderVariant::name(variant) << ")\n" << errorLog << std::endl;
+        }
+        pending.program.reset();
+        program = 0;
+    }
+    glDeleteShader(pending.vertex);
+    glDeleteShader(pending.fragment);
+
+    if (program != 0) storeBinary(variant, program);
+    programs[variant] = std::move(pending.program);
+    pending = Pending();
+    failed[variant] = (program == 0);
+    return program;
+}
+
+GLuint ShaderLibrary::get(uint32_t variant)
+{
+    if (variant >= ShaderVariant::COUNT) return 0;
+    if (programs[variant].get() != 0 || failed[variant]) return programs[variant].get();
+    if (vertexSource.empty() || fragmentSource.empty()) return 0;
+
+    Program cached = loadBinary(variant);
+    GLuint program = cached.get();
+    if (program != 0) {
+        programs[variant] = std::move(cached);
+    }
+    else {
+        Pending pending = beginBuild(variant);
+        program = finishBuild(variant, pending);
+    }
+    if (cacheDirty) writeCache();
+    return program;
+}
+
+int ShaderLibrary::compileAll(bool multiView)
+{
+    stats = Stats();
+    if (vertexSource.empty() || fragmentSource.empty()) return 0;
+
+    // 드라이버가 컴파일 스레드를 쓸 수 있으면 최대한 쓰게 한다
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        stats.parallel = true;
+    }
+    else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+        stats.parallel = true;
+    }
+
+    // 캐시에 없는 변형은 전부 걸어 두기만 하고, 결과는 다 건 뒤에 묻는다
+    Pending pending[ShaderVariant::COUNT];
+    for (uint32_t variant = 0; variant < ShaderVariant::COUNT; ++variant) {
+        if (!ShaderVariant::valid(variant) || ((variant & ShaderVariant::MULTIVIEW) && !multiView)) continue;
+        if (programs[variant].get() != 0 || failed[variant]) continue;
+
+        Program cached = loadBinary(variant);
+        if (cached.get() != 0) {
+            programs[variant] = std::move(cached);
+            ++stats.cached;
+        }
+        else {
+            pending[variant] = beginBuild(variant);
+        }
+    }
+    for (uint32_t variant = 0; variant < ShaderVariant::COUNT; ++variant) {
+        if (pending[variant].program.get() == 0) continue;
+        if (finishBuild(variant, pending[variant]) != 0) ++stats.compiled;
+        else ++stats.failed;
+    }
+    if (cacheDirty) writeCache();
+
+    int built = 0;
+    for (uint32_t variant = 0; variant < ShaderVariant::COUNT; ++variant) {
+        if (!ShaderVariant::valid(variant) || ((variant & ShaderVariant::MULTIVIEW) && !multiView)) continue;
+        if (programs[variant].get() != 0) ++built;
+    }
+    return built;
+}
+
+bool ShaderLibrary::binaryCacheEnabled()
+{
+    if (cachePath.empty()) return false;
+    if (binarySupport < 0) {
+        GLint formats = 0;
+        if (GLEW_ARB_get_program_binary || GLEW_VERSION_4_1) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        binarySupport = formats > 0 ? 1 : 0;
+        if (!binarySupport) std::cout << "셰이더 캐시: 드라이버가 프로그램 바이너리를 지원하지 않아 매번 컴파일함" << std::endl;
+        driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+    }
+    return binarySupport == 1;
+}
+
+uint64_t ShaderLibrary::cacheKey(uint32_t variant) const
+{
+    uint64_t hash = 14695981039346656037ull;
+    hash = fnv1a64(hash, driver);
+    hash = fnv1a64(hash, ShaderVariant::defines(variant));
+    hash = fnv1a64(hash, vertexSource);
+    hash = fnv1a64(hash, fragmentSource);
+    return hash;
+}
+
+ShaderLibrary::Program ShaderLibrary::loadBinary(uint32_t variant)
+{
+    if (!binaryCacheEnabled()) return Program();
+    readCache();
+
+    auto found = cache.find(cacheKey(variant));
+    if (found == cache.end()) return Program();
+
+    Program program(glCreateProgram());
+    glProgramBinary(program.get(), found->second.format, found->second.data.data(), static_cast<GLsizei>(found->second.data.size()));
+    GLint result;
+    glGetProgramiv(program.get(), GL_LINK_STATUS, &result);
+    if (!result) {
+        // 드라이버 문자열이 같아도 거부할 수 있다 (드라이버 설정 변경 등). 다시 컴파일해서 덮어쓴다.
+        std::cout << "셰이더 캐시: " << ShaderVariant::name(variant) << " 바이너리 거부됨, 다시 컴파일" << std::endl;
+        cache.erase(found);
+        cacheDirty = true;
+        return Program();
+    }
+    return program;
+}
+
+void ShaderLibrary::storeBinary(uint32_t variant, GLuint program)
+{
+    if (!binaryCacheEnabled()) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    CachedBinary binary;
+    binary.data.resize(length);
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &binary.format, binary.data.data());
+    if (written <= 0) return;
+    binary.data.resize(written);
+
+    cache[cacheKey(variant)] = std::move(binary);
+    cacheDirty = true;
+}
+
+void ShaderLibrary::readCache()
+{
+    if (cacheRead) return;
+    cacheRead = true;
+
+    // 캐시 팩에 합쳐져 있으면 팩에서 (파일을 따로 열지 않는다), 아니면 지난 실행이 따로 쓴 파일에서
+    AssetPack::View packed = cachePack().find(cachePath);
+    MemoryBuffer memory(packed.data, packed.size);
+    std::ifstream file;
+    if (!packed) {
+        file.open(cachePath.c_str(), std::ios::binary);
+        if (!file) return;
+    }
+    std::istream in(packed ? static_cast<std::streambuf*>(&memory) : file.rdbuf());
+
+    uint32_t magic = 0, version = 0, count = 0;
+    if (!readValue(in, magic) || !readValue(in, version) || !readValue(in, count) ||
+        magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        std::cout << "셰이더 캐시: " << cachePath << " 형식이 달라 무시함" << std::endl;
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t key = 0;
+        uint32_t format = 0, size = 0;
+        if (!readValue(in, key) || !readValue(in, format) || !readValue(in, size) || size == 0 || size > CACHE_MAX_BINARY) break;
+
+        CachedBinary binary;
+        binary.format = format;
+        binary.data.resize(size);
+        if (!in.read(binary.data.data(), size)) break;
+        cache[key] = std::move(binary);
+    }
+}
+
+void ShaderLibrary::writeCache()
+{
+    cacheDirty = false;
+
+    // 지금 소스/드라이버의 키만 남긴다 (고친 셰이더의 옛 바이너리는 여기서 빠진다)
+    std::map<uint64_t, CachedBinary> current;
+    for (uint32_t variant = 0; variant < ShaderVariant::COUNT; ++variant) {
+        auto found = cache.find(cacheKey(variant));
+        if (found != cache.end()) current[found->first] = std::move(found->second);
+    }
+    cache.swap(current);
+
+    // 쓰다가 끊겨도 다음 실행이 반쪽 파일을 읽지 않게 임시 파일에 쓰고 바꿔 넣는다
+    std::string temporary = cachePath + ".tmp";
+    {
+        std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "셰이더 캐시 저장 실패: " << cachePath << std::endl;
+            return;
+        }
+        writeValue(out, CACHE_MAGIC);
+        writeValue(out, CACHE_VERSION);
+        writeValue(out, static_cast<uint32_t>(cache.size()));
+        for (const auto& entry : cache) {
+            writeValue(out, entry.first);
+            writeValue(out, static_cast<uint32_t>(entry.second.format));
+            writeValue(out, static_cast<uint32_t>(entry.second.data.size()));
+            out.write(entry.second.data.data(), entry.second.data.size());
+        }
+        if (!out) {
+            std::cerr << "셰이더 캐시 저장 실패: " << cachePath << std::endl;
+            return;
+        }
+    }
+    std::remove(cachePath.c_str());
+    if (std::rename(temporary.c_str(), cachePath.c_str()) != 0) {
+        std::cerr << "셰이더 캐시 저장 실패: " << cachePath << std::endl;
+        return;
+    }
+    notePendingCache(cachePath);
+}
+
+void ShaderLibrary::destroy()
+{
+    for (uint32_t variant = 0; variant < ShaderVariant::COUNT; ++variant) {
+        programs[variant].reset();
+        failed[variant] = false;
+    }
+}
@@ -0,0 +1,125 @@
+﻿#pragma once
+#include <gl/glew.h>
+#include "GlIntercept.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// 셰이더 변형. vertex.glsl/fragment.glsl 한 벌을 비트에 맞춘 #define으로 특수화해서 컴파일한다.
+// 조각마다 하던 분기(텍스처 사용, 조명 켜짐)가 컴파일 때 정해진다.
+namespace ShaderVariant {
+    enum Bits : uint32_t {
+        TEXTURED = 1u << 0,     // texture1에서 색을 읽는다 (아니면 vColor 단색)
+        LIT = 1u << 1,          // 퐁 조명 (법선은 normalMatrix로 돌린다)
+        ALPHA = 1u << 2,        // 정점 알파(속성 3)를 출력 알파로 (블렌딩하는 그리기)
+        MULTIVIEW = 1u << 3,    // 시점마다 인스턴스 하나, 행렬은 Views 블록 (분할 화면 한 번 그리기)
+        LAYERED = 1u << 4,      // texture1이 2D 배열, layer 유니폼으로 층을 고른다 (TEXTURED와 같이만)
+    };
+    const uint32_t COUNT = 32;
+
+    // 의미 있는 조합인지 (LAYERED는 TEXTURED 없이는 쓸 데가 없다)
+    inline bool valid(uint32_t variant) { return !(variant & LAYERED) || (variant & TEXTURED); }
+
+    // 소스의 #version 줄 뒤에 넣을 "#define TEXTURED\n..."
+    std::string defines(uint32_t variant);
+    // 로그용 이름 ("TEXTURED|LIT", 비트가 없으면 "BASE")
+    std::string name(uint32_t variant);
+}
+
+// 변형별 프로그램. 처음 찾을 때 컴파일하고, 실패한 변형은 다시 시도하지 않는다.
+// 캐시 경로가 있으면 링크한 프로그램을 glGetProgramBinary로 저장해 두고, 다음 실행에서는
+// 컴파일 없이 glProgramBinary로 올린다.
+// GL 컨텍스트가 먼저 사라질 수 있어서 소멸자에서는 지우지 않는다 (destroy를 부를 것).
+class ShaderLibrary
+{
+public:
+    ~ShaderLibrary();
+
+    // 마지막 compileAll의 결과
+    struct Stats {
+        int cached = 0;         // 캐시 바이너리로 올린 변형
+        int compiled = 0;       // 소스에서 컴파일한 변형
+        int failed = 0;
+        bool parallel = false;  // 드라이버 병렬 컴파일 (KHR/ARB_parallel_shader_compile)
+    };
+
+    // 프로그램 바이너리 캐시 파일 (nullptr이나 ""이면 캐시를 쓰지 않는다). load 전에 정한다.
+    // 항목 키는 소스, #define, 드라이버 문자열(제조사/렌더러/버전)의 해시라서 셰이더를 고치거나
+    // 드라이버가 바뀌면 그 항목은 맞지 않아 다시 컴파일되고, 다음 저장 때 빠진다.
+    void setCachePath(const char* path) { cachePath = path ? path : ""; }
+
+    // 소스 파일을 읽어 둔다. 이미 만든 프로그램은 지운다.
+    bool load(const char* vertexPath, const char* fragmentPath);
+
+    // 없으면 컴파일/링크한다. 실패하면 0.
+    GLuint get(uint32_t variant);
+    // 이미 만든 것만 (없으면 0)
+    GLuint find(uint32_t variant) const { return variant < ShaderVariant::COUNT ? programs[variant].get() : 0; }
+
+    // 의미 있는 변형을 전부 미리 만든다 (그리는 도중 컴파일로 멈추지 않게). multiView가 false면 MULTIVIEW 변형은 뺀다.
+    // 캐시에 있는 것은 바이너리로 올리고, 나머지는 컴파일/링크를 전부 먼저 걸어 둔 뒤에 결과를 확인한다
+    // (상태를 묻는 순간 드라이버가 기다리므로, 묻기 전에 모두 넘겨야 드라이버 스레드가 같이 돈다).
+    // 만든 개수를 돌려준다.
+    int compileAll(bool multiView);
+    const Stats& getStats() const { return stats; }
+
+    void destroy();
+
+private:
+    // 프로그램 이름 하나의 주인. 옮기기만 하고, 소멸하거나 reset하면 지운다
+    // (지우는 프로그램이 바인드된 채로 GlState에 남지 않게 바인딩도 푼다).
+    class Program
+    {
+    public:
+        Program() {}
+        explicit Program(GLuint name) : name(name) {}
+        Program(Program&& other) noexcept : name(other.name) { other.name = 0; }
+        Program& operator=(Program&& other) noexcept;
+        Program(const Program&) = delete;
+        Program& operator=(const Program&) = delete;
+        ~Program() { reset(); }
+
+        GLuint get() const { return name; }
+        void reset();
+        // 지우지 않고 손을 뗀다
+        void release() { name = 0; }
+
+    private:
+        GLuint name = 0;
+    };
+
+    // 컴파일/링크를 걸어 두고 결과는 아직 묻지 않은 프로그램
+    struct Pending {
+        Program program;
+        GLuint vertex = 0;
+        GLuint fragment = 0;
+    };
+    struct CachedBinary {
+        GLenum format = 0;
+        std::vector<char> data;
+    };
+
+    Pending beginBuild(uint32_t variant);
+    GLuint finishBuild(uint32_t variant, Pending& pending);
+
+    bool binaryCacheEnabled();
+    uint64_t cacheKey(uint32_t variant) const;
+    Program loadBinary(uint32_t variant);
+    void storeBinary(uint32_t variant, GLuint program);
+    void readCache();
+    void writeCache();
+
+    std::string vertexSource;
+    std::string fragmentSource;
+    Program programs[ShaderVariant::COUNT];
+    bool failed[ShaderVariant::COUNT] = {};
+    Stats stats;
+
+    std::string cachePath;
+    std::string driver;             // 제조사/렌더러/버전 (캐시 키에 들어간다)
+    int binarySupport = -1;         // -1 아직 모름, 0 없음, 1 있음
+    bool cacheRead = false;
+    bool cacheDirty = false;
+    std::map<uint64_t, CachedBinary> cache;
+};
@@ -0,0 +1,19 @@
+﻿#pragma once
+#include <iostream>
+
+// 시뮬레이션 중에 찍는 디버그 로그.
+// 롤백 재시뮬레이션처럼 같은 틱을 여러 번 돌릴 때는 Mute로 잠시 끈다.
+namespace SimLog {
+    inline bool& enabled() {
+        static thread_local bool on = true;
+        return on;
+    }
+
+    struct Mute {
+        bool previous;
+        Mute() : previous(enabled()) { enabled() = false; }
+        ~Mute() { enabled() = previous; }
+    };
+}
+
+#define SIM_LOG if (!SimLog::enabled()) {} else std::cout
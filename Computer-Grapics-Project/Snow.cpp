@@ -1,6 +1,8 @@
 #include "Snow.h"
 #include "Map.h"
-#include "stb_image.h"
+#include "TextureArray.h"
+#include "SimLog.h"
+#include "FlightRecorder.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
@@ -9,64 +11,14 @@ Snow::Snow(const std::string& texturePath) : texturePath(texturePath)
 {
 }
 
-Snow::~Snow()
-{
-    if (vao != 0) {
-        glDeleteVertexArrays(1, &vao);
-        glDeleteBuffers(1, &vbo);
-        glDeleteBuffers(1, &nbo);
-        glDeleteBuffers(1, &tbo);
-        if (alphaVBO != 0) glDeleteBuffers(1, &alphaVBO);
-    }
-
-    if (textureLoaded && textureID != 0) {
-        glDeleteTextures(1, &textureID);
-    }
-}
-
 void Snow::loadTexture() const
 {
     if (textureLoaded) return;
 
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    // ؽó Ķ 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(texturePath.c_str(), &width, &height, &channels, 0);
-
-    if (data) {
-        GLenum format;
-        if (channels == 1)
-            format = GL_RED;
-        else if (channels == 3)
-            format = GL_RGB;
-        else if (channels == 4)
-            format = GL_RGBA;
-        else
-            format = GL_RGB;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        std::cout << " ؽó ε : " << texturePath << " (" << width << "x" << height << ", " << channels << " channels)" << std::endl;
-        textureLoaded = true;
-    }
-    else {
-        std::cerr << " ؽó ε : " << texturePath << std::endl;
-        unsigned char whitePixel[3] = { 255, 255, 255 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, whitePixel);
-        textureLoaded = true;
-    }
-
-    stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // , ĳͿ   ؽó 迭  ϳ
+    layer = Render::worldTextures().addLayer(texturePath);
+    textureID = Render::worldTextures().getTexture();
+    textureLoaded = true;
 }
 
 bool Snow::isValidGroundPosition(float x, float z) const
@@ -84,10 +36,10 @@ bool Snow::isValidGroundPosition(float x, float z) const
 
 void Snow::addSnowAt(float x, float z)
 {
-    std::cout << "ִϸ̼ǰ Բ   õ: (" << x << ", " << z << ")" << std::endl;
+    SIM_LOG << "ִϸ̼ǰ Բ   õ: (" << x << ", " << z << ")" << std::endl;
 
     if (!isValidGroundPosition(x, z)) {
-        std::cout << "Ground ƴ ġԴϴ: (" << x << ", " << z << ")" << std::endl;
+        SIM_LOG << "Ground ƴ ġԴϴ: (" << x << ", " << z << ")" << std::endl;
         return;
     }
 
@@ -96,7 +48,7 @@ void Snow::addSnowAt(float x, float z)
     int targetGridZ = gridPos.second;
 
     if (!canSnowBeGenerated(targetGridX, targetGridZ)) {
-        std::cout << "  Ұ:   " << std::endl;
+        SIM_LOG << "  Ұ:   " << std::endl;
         return;
     }
 
@@ -107,7 +59,7 @@ void Snow::addSnowAt(float x, float z)
     float newTargetHeight = previousHeight + 0.5f;
     if (newTargetHeight > 3.0f) {
         newTargetHeight = 3.0f;
-        std::cout << "̹ ִ ̿ ߽ϴ." << std::endl;
+        SIM_LOG << "̹ ִ ̿ ߽ϴ." << std::endl;
         return;
     }
 
@@ -120,11 +72,43 @@ void Snow::addSnowAt(float x, float z)
     snowAnimData.alphaValue = (previousHeight > 0.0f) ? 1.0f : 0.0f;
     
     needsUpdate = true;
+    FlightRecorder::event("snow added (%d, %d) %.1f -> %.1f", targetGridX, targetGridZ, previousHeight, newTargetHeight);
 
-    std::cout << " ִϸ̼ ! - ׸(" << targetGridX << ", " << targetGridZ
+    SIM_LOG << " ִϸ̼ ! - ׸(" << targetGridX << ", " << targetGridZ
               << ")  : " << previousHeight << " -> ǥ : " << newTargetHeight << std::endl;
 }
 
+void Snow::setTargetHeight(int gridX, int gridZ, float targetHeight)
+{
+    auto it = snowData.find({ gridX, gridZ });
+    if (targetHeight <= 0.0f) {
+        if (it != snowData.end()) {
+            snowData.erase(it);
+            needsUpdate = true;
+        }
+        return;
+    }
+
+    auto& animData = snowData[{gridX, gridZ}];
+    if (animData.targetHeight == targetHeight) return;
+
+    float previousHeight = animData.targetHeight;
+    animData.targetHeight = targetHeight;
+    animData.currentHeight = previousHeight;
+    animData.animationTime = 0.0f;
+    animData.animationDuration = defaultAnimationDuration;
+    animData.isAnimating = true;
+    animData.alphaValue = (previousHeight > 0.0f) ? 1.0f : 0.0f;
+
+    needsUpdate = true;
+}
+
+void Snow::setSnowData(const std::map<std::pair<int, int>, SnowAnimationData>& data)
+{
+    snowData = data;
+    needsUpdate = true;
+}
+
 void Snow::updateAnimations(float deltaTime)
 {
     bool hasActiveAnimations = false;
@@ -157,7 +141,7 @@ void Snow::updateAnimations(float deltaTime)
                 animData.isAnimating = false;
                 animData.currentHeight = animData.targetHeight;
                 animData.alphaValue = 1.0f;
-                std::cout << " ִϸ̼ Ϸ - : " << startHeight 
+                SIM_LOG << " ִϸ̼ Ϸ - : " << startHeight 
                          << " ->  : " << animData.targetHeight << std::endl;
             }
             
@@ -217,12 +201,8 @@ glm::vec3 Snow::gridToWorld(int gridX, int gridZ, float height) const
 
 void Snow::updateBuffers() const
 {
-    if (vao == 0) {
-        glGenVertexArrays(1, &vao);
-        glGenBuffers(1, &vbo);
-        glGenBuffers(1, &nbo);
-        glGenBuffers(1, &tbo);
-        glGenBuffers(1, &alphaVBO);
+    if (mesh.vao == 0) {
+        FlightRecorder::event("snow mesh first build (%d cells)", static_cast<int>(snowData.size()));
     }
 
     std::vector<glm::vec3> allVertices, allNormals;
@@ -244,42 +224,24 @@ void Snow::updateBuffers() const
             animData.alphaValue);
     }
 
-    totalVertexCount = static_cast<GLsizei>(allVertices.size());
-
-    if (totalVertexCount > 0) {
-        glBindVertexArray(vao);
-
-        // ؽ ġ 
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, allVertices.size() * sizeof(glm::vec3),
-            allVertices.data(), GL_STATIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-
-        //  
-        glBindBuffer(GL_ARRAY_BUFFER, nbo);
-        glBufferData(GL_ARRAY_BUFFER, allNormals.size() * sizeof(glm::vec3),
-            allNormals.data(), GL_STATIC_DRAW);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-
-        // ؽó ǥ 
-        glBindBuffer(GL_ARRAY_BUFFER, tbo);
-        glBufferData(GL_ARRAY_BUFFER, allTexCoords.size() * sizeof(glm::vec2),
-            allTexCoords.data(), GL_STATIC_DRAW);
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
-
-        //   
-        glBindBuffer(GL_ARRAY_BUFFER, alphaVBO);
-        glBufferData(GL_ARRAY_BUFFER, allAlphas.size() * sizeof(float),
-            allAlphas.data(), GL_STATIC_DRAW);
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)0);
-
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (allVertices.empty()) {
+        mesh.count = 0;
+        return;
+    }
+
+    boundsMin = boundsMax = allVertices[0];
+    for (const glm::vec3& v : allVertices) {
+        boundsMin = glm::min(boundsMin, v);
+        boundsMax = glm::max(boundsMax, v);
     }
+
+    Render::MeshData data;
+    data.positions = allVertices.data();
+    data.normals = allNormals.data();
+    data.texCoords = allTexCoords.data();
+    data.alphas = allAlphas.data();
+    data.count = allVertices.size();
+    Render::backend().uploadMesh(mesh, data);
 }
 
 void Snow::generateSnowBlock(float x, float y, float z, float width, float height, float depth,
@@ -347,7 +309,7 @@ void Snow::generateSnowBlock(float x, float y, float z, float width, float heigh
     }
 }
 
-void Snow::render(GLuint shaderProgram) const
+void Snow::render(Render::DrawList& out, const FrustumSet& frustums) const
 {
     if (snowData.empty()) return;
 
@@ -360,60 +322,41 @@ void Snow::render(GLuint shaderProgram) const
         loadTexture();
     }
 
-    if (totalVertexCount > 0) {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-        if (textureLoaded && textureID != 0) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, textureID);
-        }
-
-
-        GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
-        GLint useTextureLoc = glGetUniformLocation(shaderProgram, "useTexture");
-        GLint vColorLoc = glGetUniformLocation(shaderProgram, "vColor");
-
-        glm::mat4 model = glm::mat4(1.0f);
-        if (modelLoc != -1) glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &model[0][0]);
-        if (useTextureLoc != -1) glUniform1i(useTextureLoc, textureLoaded ? 1 : 0);
-        if (vColorLoc != -1) glUniform3f(vColorLoc, 1.0f, 1.0f, 1.0f);
-
-        glBindVertexArray(vao);
-        glDrawArrays(GL_TRIANGLES, 0, totalVertexCount);
-        glBindVertexArray(0);
-
-        glDisable(GL_BLEND);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    if (mesh.count > 0 && frustums.intersects(boundsMin, boundsMax)) {
+        Render::DrawItem item(mesh);
+        item.texture = textureLoaded ? textureID : 0;
+        item.layer = layer;
+        item.blend = true;
+        out.add(item);
     }
 }
 
 void Snow::clearAll()
 {
-    std::cout << "  : " << snowData.size() << " " << std::endl;
+    SIM_LOG << "  : " << snowData.size() << " " << std::endl;
     snowData.clear();
     needsUpdate = true;
-    totalVertexCount = 0;
+    mesh.count = 0;
 }
 
 bool Snow::canSnowBeGenerated(int gridX, int gridZ) const
 {
     if (getSnowHeightAt(gridX, gridZ) >= 3.0f) {
-        std::cout << "̹ ִ   ׿" << std::endl;
+        SIM_LOG << "̹ ִ   ׿" << std::endl;
         return false;
     }
 
     if (isAdjacentToWall(gridX, gridZ)) {
-        std::cout << "  ġ -   " << std::endl;
+        SIM_LOG << "  ġ -   " << std::endl;
         return true;
     }
 
     if (isAdjacentToMaxHeightSnow(gridX, gridZ)) {
-        std::cout << "ִ    ġ -   " << std::endl;
+        SIM_LOG << "ִ    ġ -   " << std::endl;
         return true;
     }
 
-    std::cout << "(" << gridX << ", " << gridZ << ")    " << std::endl;
+    SIM_LOG << "(" << gridX << ", " << gridZ << ")    " << std::endl;
     return false;
 }
 
@@ -432,7 +375,7 @@ bool Snow::isAdjacentToMaxHeightSnow(int gridX, int gridZ) const
 
         float adjacentHeight = getSnowHeightAt(checkX, checkZ);
         if (adjacentHeight >= 1.0f) {
-            std::cout << " ġ(" << checkX << ", " << checkZ << ") ִ    (: "
+            SIM_LOG << " ġ(" << checkX << ", " << checkZ << ") ִ    (: "
                 << adjacentHeight << ")" << std::endl;
             return true;
         }
@@ -445,33 +388,33 @@ bool Snow::isAdjacentToWall(int gridX, int gridZ) const
 {
     if (gridZ >= 0 && gridZ < 5) {
         if (gridZ == 0) {
-            std::cout << " (z=0) " << std::endl;
+            SIM_LOG << " (z=0) " << std::endl;
             return true;
         }
 
         if (gridX == 0 || gridX == 9) { // MAP_WIDTH-1 = 9
-            std::cout << "¿ (x=" << gridX << ") " << std::endl;
+            SIM_LOG << "¿ (x=" << gridX << ") " << std::endl;
             return true;
         }
 
         if (gridZ == 4) {
-            std::cout << "߰  (z=4) " << std::endl;
+            SIM_LOG << "߰  (z=4) " << std::endl;
             return true;
         }
     }
     else if (gridZ >= 10 && gridZ < 15) {
         if (gridZ == 14) {
-            std::cout << " (z=14) " << std::endl;
+            SIM_LOG << " (z=14) " << std::endl;
             return true;
         }
 
         if (gridX == 0 || gridX == 9) {
-            std::cout << "¿ (x=" << gridX << ") " << std::endl;
+            SIM_LOG << "¿ (x=" << gridX << ") " << std::endl;
             return true;
         }
 
         if (gridZ == 10) {
-            std::cout << "߰  (z=10) " << std::endl;
+            SIM_LOG << "߰  (z=10) " << std::endl;
             return true;
         }
     }
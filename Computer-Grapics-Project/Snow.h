@@ -1,8 +1,11 @@
 #pragma once
 #include <gl/glew.h>
+#include "GlIntercept.h"
 #include <gl/glm/glm.hpp>
 #include <gl/glm/ext.hpp>
 #include <gl/glm/gtc/matrix_transform.hpp>
+#include "RenderQueue.h"
+#include "Frustum.h"
 #include <map>
 #include <vector>
 #include <string>
@@ -26,15 +29,13 @@ class Snow
 private:
     std::map<std::pair<int, int>, SnowAnimationData> snowData;
 
-    mutable GLuint vao = 0;
-    mutable GLuint vbo = 0;
-    mutable GLuint nbo = 0;
-    mutable GLuint tbo = 0;
-    mutable GLuint alphaVBO = 0;
-    mutable GLsizei totalVertexCount = 0;
+    mutable Render::Mesh mesh;
     mutable bool needsUpdate = true;
+    mutable glm::vec3 boundsMin{ 0.0f };     // ޽ ü AABB (ø)
+    mutable glm::vec3 boundsMax{ 0.0f };
 
     mutable GLuint textureID = 0;
+    mutable int layer = -1;             //  ؽó 迭 
     mutable bool textureLoaded = false;
     std::string texturePath;
 
@@ -62,17 +63,23 @@ private:
 
 public:
     Snow(const std::string& texturePath = "snow.png");
-    ~Snow();
 
     void addSnowAt(float x, float z);
 
+    //    ĭ ǥ ̸  (0̸ )
+    void setTargetHeight(int gridX, int gridZ, float targetHeight);
+
+    const std::map<std::pair<int, int>, SnowAnimationData>& getSnowData() const { return snowData; }
+    // ѹ  
+    void setSnowData(const std::map<std::pair<int, int>, SnowAnimationData>& data);
+
     void updateAnimations(float deltaTime);
 
     float getSnowHeightAt(int gridX, int gridZ) const;
 
     float getSnowHeightAtWorld(float x, float z) const;
 
-    void render(GLuint shaderProgram) const;
+    void render(Render::DrawList& out, const FrustumSet& frustums) const;
 
     void clearAll();
 
@@ -1,62 +1,44 @@
 #include "Snowball.h"
 #include "Snow.h"
 #include "Map.h"
-#include <iostream>
+#include "SimLog.h"
+#include "FlightRecorder.h"
 
 const float SNOWBALL_BLOCK_SIZE = 1.0f;
 const int SNOWBALL_MAP_WIDTH = 10; 
 const int SNOWBALL_MAP_DEPTH = 15;
 
 Snowball::Snowball() 
-    : vao(0), vbo(0), nbo(0), tbo(0), vertexCount(0), isInitialized(false),
+    : id(0),
       position(0.0f), velocity(0.0f), acceleration(0.0f), gravity(-9.8f),
       radius(0.1f), lifeTime(0.0f), maxLifeTime(5.0f), isActive(false)
 {
 }
 
 Snowball::Snowball(const glm::vec3& startPos, const glm::vec3& direction, float speed, float radius)
-    : vao(0), vbo(0), nbo(0), tbo(0), vertexCount(0), isInitialized(false),
+    : id(0),
       position(startPos), gravity(-9.8f), radius(radius), lifeTime(0.0f), 
       maxLifeTime(5.0f), isActive(true)
 {
     velocity = glm::normalize(direction) * speed;
     acceleration = glm::vec3(0.0f, gravity, 0.0f);
-    
-    initializeBuffers();
-}
-
-Snowball::~Snowball()
-{
-    if (isInitialized) {
-        glDeleteVertexArrays(1, &vao);
-        glDeleteBuffers(1, &vbo);
-        glDeleteBuffers(1, &nbo);
-        glDeleteBuffers(1, &tbo);
-    }
 }
 
 Snowball::Snowball(const Snowball& other)
-    : vao(0), vbo(0), nbo(0), tbo(0), vertexCount(0), isInitialized(false),
+    : id(other.id),
       position(other.position), velocity(other.velocity), acceleration(other.acceleration),
       gravity(other.gravity), radius(other.radius), lifeTime(other.lifeTime),
       maxLifeTime(other.maxLifeTime), isActive(other.isActive)
 {
-    if (other.isInitialized) {
-        initializeBuffers();
-    }
 }
 
 Snowball& Snowball::operator=(const Snowball& other)
 {
     if (this != &other) {
-        if (isInitialized) {
-            glDeleteVertexArrays(1, &vao);
-            glDeleteBuffers(1, &vbo);
-            glDeleteBuffers(1, &nbo);
-            glDeleteBuffers(1, &tbo);
-            isInitialized = false;
-        }
+        //  ǵ   ũ ̹  ޽ø ״ 
+        if (radius != other.radius) mesh.reset();
         
+        id = other.id;
         position = other.position;
         velocity = other.velocity;
         acceleration = other.acceleration;
@@ -65,19 +47,12 @@ Snowball& Snowball::operator=(const Snowball& other)
         lifeTime = other.lifeTime;
         maxLifeTime = other.maxLifeTime;
         isActive = other.isActive;
-        
-        vao = vbo = nbo = tbo = 0;
-        vertexCount = 0;
-        
-        if (other.isInitialized) {
-            initializeBuffers();
-        }
     }
     return *this;
 }
 
 void Snowball::generateSphere(float radius, int segments, std::vector<glm::vec3>& vertices, 
-                             std::vector<glm::vec3>& normals, std::vector<glm::vec2>& texCoords)
+                             std::vector<glm::vec3>& normals, std::vector<glm::vec2>& texCoords) const
 {
     vertices.clear();
     normals.clear();
@@ -146,44 +121,20 @@ void Snowball::generateSphere(float radius, int segments, std::vector<glm::vec3>
     texCoords = finalTexCoords;
 }
 
-void Snowball::initializeBuffers()
+void Snowball::initializeBuffers() const
 {
     std::vector<glm::vec3> vertices, normals;
     std::vector<glm::vec2> texCoords;
     
     generateSphere(radius, 16, vertices, normals, texCoords);
-    vertexCount = static_cast<GLsizei>(vertices.size());
-
-    // OpenGL  
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &nbo);
-    glGenBuffers(1, &tbo);
-
-    glBindVertexArray(vao);
-
-    // ؽ ġ 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-
-    //  
-    glBindBuffer(GL_ARRAY_BUFFER, nbo);
-    glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), normals.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-
-    // ؽó ǥ 
-    glBindBuffer(GL_ARRAY_BUFFER, tbo);
-    glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(glm::vec2), texCoords.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    isInitialized = true;
+    FlightRecorder::event("snowball %u mesh build (%d verts)", static_cast<unsigned int>(id), static_cast<int>(vertices.size()));
+
+    Render::MeshData data;
+    data.positions = vertices.data();
+    data.normals = normals.data();
+    data.texCoords = texCoords.data();
+    data.count = vertices.size();
+    Render::backend().uploadMesh(mesh, data);
 }
 
 bool Snowball::checkSnowCollision(const Snow& snowSystem) const
@@ -221,12 +172,12 @@ bool Snowball::checkSnowCollision(const Snow& snowSystem) const
                 bool collisionY = distanceY <= (blockHalfHeight + radius);
                 
                 if (collisionX && collisionZ && collisionY) {
-                    std::cout << "===  浹  ===" << std::endl;
-                    std::cout << " ġ: (" << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
-                    std::cout << "(" << checkGridX << ", " << checkGridZ << ")  : " << snowHeight << std::endl;
-                    std::cout << "  ߽: (" << snowCenterX << ", " << snowCenterY << ", " << snowCenterZ << ")" << std::endl;
-                    std::cout << "   Y: " << snowBottomY << " ~ " << snowTopY << std::endl;
-                    std::cout << "Ÿ X/Z/Y: " << distanceX << "/" << distanceZ << "/" << distanceY << std::endl;
+                    SIM_LOG << "===  浹  ===" << std::endl;
+                    SIM_LOG << " ġ: (" << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
+                    SIM_LOG << "(" << checkGridX << ", " << checkGridZ << ")  : " << snowHeight << std::endl;
+                    SIM_LOG << "  ߽: (" << snowCenterX << ", " << snowCenterY << ", " << snowCenterZ << ")" << std::endl;
+                    SIM_LOG << "   Y: " << snowBottomY << " ~ " << snowTopY << std::endl;
+                    SIM_LOG << "Ÿ X/Z/Y: " << distanceX << "/" << distanceZ << "/" << distanceY << std::endl;
                     return true;
                 }
             }
@@ -242,19 +193,13 @@ void Snowball::update(float deltaTime, Snow& snowSystem, const Map& gameMap)
     lifeTime += deltaTime;
     if (lifeTime >= maxLifeTime) {
         isActive = false;
-        std::cout << "  " << std::endl;
+        SIM_LOG << "  " << std::endl;
         return;
     }
 
     glm::vec3 prevPosition = position;
 
-    velocity += acceleration * deltaTime;
-    position += velocity * deltaTime;
-
-    static int debugCounter = 0;
-    if (++debugCounter % 30 == 0) {
-        std::cout << " ġ: (" << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
-    }
+    integrate(deltaTime);
 
     if (checkWallCollision(gameMap)) {
         glm::vec3 collisionPoint = position;
@@ -280,7 +225,7 @@ void Snowball::update(float deltaTime, Snow& snowSystem, const Map& gameMap)
         snowSystem.addSnowAt(snowX, snowZ);
         
         isActive = false;
-        std::cout << "̰  浹!  ġ(" << snowX << ", " << snowZ << ")  " << std::endl;
+        SIM_LOG << "̰  浹!  ġ(" << snowX << ", " << snowZ << ")  " << std::endl;
         return;
     }
 
@@ -288,35 +233,35 @@ void Snowball::update(float deltaTime, Snow& snowSystem, const Map& gameMap)
         snowSystem.addSnowAt(position.x, position.z);
         
         isActive = false;
-        std::cout << "̰   浹! ġ(" << position.x << ", " << position.z << ")  ߰" << std::endl;
+        SIM_LOG << "̰   浹! ġ(" << position.x << ", " << position.z << ")  ߰" << std::endl;
         return;
     }
 
     const float GROUND_TOP = 0.5f;
     if (position.y - radius <= GROUND_TOP) {
         isActive = false;
-        std::cout << "̰ Ground Ͽ  (  )" << std::endl;
+        SIM_LOG << "̰ Ground Ͽ  (  )" << std::endl;
         return;
     }
 
     if (position.x < -2.0f || position.x > (SNOWBALL_MAP_WIDTH + 2) * SNOWBALL_BLOCK_SIZE || 
         position.z < -2.0f || position.z > (SNOWBALL_MAP_DEPTH + 2) * SNOWBALL_BLOCK_SIZE) {
         isActive = false;
-        std::cout << "̰    " << std::endl;
+        SIM_LOG << "̰    " << std::endl;
         return;
     }
 }
 
+void Snowball::integrate(float deltaTime)
+{
+    velocity += acceleration * deltaTime;
+    position += velocity * deltaTime;
+}
+
 bool Snowball::checkWallCollision(const Map& gameMap) const
 {
     const Wall& wall = gameMap.getWall();
     
-    static bool debugPrinted = false;
-    if (!debugPrinted) {
-        std::cout << "   : " << wall.getBlockCount() << std::endl;
-        debugPrinted = true;
-    }
-    
     for (size_t i = 0; i < wall.getBlockCount(); ++i) {
         const Block& block = wall.getBlock(i);
         
@@ -332,10 +277,10 @@ bool Snowball::checkWallCollision(const Map& gameMap) const
             position.y >= blockMin.y && position.y <= blockMax.y &&
             position.z >= blockMin.z && position.z <= blockMax.z) {
             
-            std::cout << " 浹 !" << std::endl;
-            std::cout << " ġ: (" << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
-            std::cout << " ġ: (" << blockPos.x << ", " << blockPos.y << ", " << blockPos.z << ")" << std::endl;
-            std::cout << " ũ: " << blockSize << std::endl;
+            SIM_LOG << " 浹 !" << std::endl;
+            SIM_LOG << " ġ: (" << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
+            SIM_LOG << " ġ: (" << blockPos.x << ", " << blockPos.y << ", " << blockPos.z << ")" << std::endl;
+            SIM_LOG << " ũ: " << blockSize << std::endl;
             return true;
         }
     }
@@ -343,37 +288,15 @@ bool Snowball::checkWallCollision(const Map& gameMap) const
     return false;
 }
 
-void Snowball::render(GLuint shaderProgram, const glm::vec3& color) const
+void Snowball::render(Render::DrawList& out, const glm::vec3& color) const
 {
-    if (!isActive || !isInitialized) return;
-
-    //  
-    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
-    
-    //  
-    glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
-    
-    GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLint normalMatrixLoc = glGetUniformLocation(shaderProgram, "normalMatrix");
-    GLint vColorLoc = glGetUniformLocation(shaderProgram, "vColor");
-    GLint useTextureLoc = glGetUniformLocation(shaderProgram, "useTexture");
-    
-    if (modelLoc != -1) {
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &model[0][0]);
-    }
-    if (normalMatrixLoc != -1) {
-        glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, &normalMatrix[0][0]);
-    }
-    if (vColorLoc != -1) {
-        glUniform3f(vColorLoc, color.r, color.g, color.b);
-    }
-    if (useTextureLoc != -1) {
-        glUniform1i(useTextureLoc, 0);
-    }
+    if (!isActive) return;
+    if (!mesh) initializeBuffers();
 
-    glBindVertexArray(vao);
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
-    glBindVertexArray(0);
+    Render::DrawItem item(mesh);
+    item.model = glm::translate(glm::mat4(1.0f), position);
+    item.color = color;
+    out.add(item);
 }
 
 bool Snowball::checkCollision(const glm::vec3& point, float distance) const
@@ -390,7 +313,7 @@ Snowball Snowball::createFromPlayer(const glm::vec3& playerPos, const glm::vec3&
     
     glm::vec3 direction = playerFront + playerUp * 0.3f;
     
-    std::cout << "  -  ġ: (" << startPos.x << ", " << startPos.y << ", " << startPos.z 
+    SIM_LOG << "  -  ġ: (" << startPos.x << ", " << startPos.y << ", " << startPos.z 
               << ") : (" << direction.x << ", " << direction.y << ", " << direction.z << ")" << std::endl;
     
     return Snowball(startPos, direction, 12.0f, 0.15f);
@@ -1,8 +1,10 @@
 #pragma once
 #include <gl/glew.h>
+#include "GlIntercept.h"
 #include <gl/glm/glm.hpp>
 #include <gl/glm/ext.hpp>
 #include <gl/glm/gtc/matrix_transform.hpp>
+#include "RenderQueue.h"
 #include <vector>
 #include <cmath>
 
@@ -12,9 +14,9 @@ class Map;
 class Snowball
 {
 private:
-    GLuint vao, vbo, nbo, tbo;
-    GLsizei vertexCount;
-    bool isInitialized;
+    mutable Render::Mesh mesh;          // ó ׸   ( θ )
+
+    unsigned short id;
 
     glm::vec3 position;
     glm::vec3 velocity;
@@ -26,9 +28,9 @@ private:
     bool isActive;
 
     void generateSphere(float radius, int segments, std::vector<glm::vec3>& vertices,
-        std::vector<glm::vec3>& normals, std::vector<glm::vec2>& texCoords);
+        std::vector<glm::vec3>& normals, std::vector<glm::vec2>& texCoords) const;
 
-    void initializeBuffers();
+    void initializeBuffers() const;
 
     bool checkWallCollision(const Map& gameMap) const;
     bool checkSnowCollision(const Snow& snowSystem) const;
@@ -36,17 +38,28 @@ private:
 public:
     Snowball();
     Snowball(const glm::vec3& startPos, const glm::vec3& direction, float speed = 10.0f, float radius = 0.1f);
-    ~Snowball();
 
+    //  ùķ̼ ¸ (ѹ ). ޽ô ű   Ѿ
+    //  Ŀų Ȱ ̸    ޽ø ٽ  ʴ´.
     Snowball(const Snowball& other);
     Snowball& operator=(const Snowball& other);
+    Snowball(Snowball&& other) = default;
+    Snowball& operator=(Snowball&& other) = default;
 
     void update(float deltaTime, Snow& snowSystem, const Map& gameMap);
 
-    void render(GLuint shaderProgram, const glm::vec3& color = glm::vec3(1.0f, 1.0f, 1.0f)) const;
+    // 浹     (Ŭ̾Ʈ  ܻ)
+    void integrate(float deltaTime);
+
+    void render(Render::DrawList& out, const glm::vec3& color = glm::vec3(1.0f, 1.0f, 1.0f)) const;
 
     bool getIsActive() const { return isActive; }
     glm::vec3 getPosition() const { return position; }
+    glm::vec3 getVelocity() const { return velocity; }
+    void setMotion(const glm::vec3& pos, const glm::vec3& vel) { position = pos; velocity = vel; }
+
+    unsigned short getId() const { return id; }
+    void setId(unsigned short newId) { id = newId; }
     float getRadius() const { return radius; }
 
     bool checkCollision(const glm::vec3& point, float distance) const;
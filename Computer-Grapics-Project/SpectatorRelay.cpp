@@ -0,0 +1,545 @@
+﻿#include "SpectatorRelay.h"
+#include "SimLog.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+namespace {
+
+const double UPSTREAM_TIMEOUT = 1.0;     // 이 시간 동안 스냅샷이 없으면 다시 구독
+const double VIEWER_TIMEOUT = 5.0;
+const double VIEWER_JOIN_INTERVAL = 1.0;
+
+void writeFrameHeader(BitWriter& w, uint8_t matchId, uint32_t seq, const NetView& view, bool key, uint32_t keyTick)
+{
+    writePacketHeader(w, PACKET_RELAY_FRAME);
+    w.writeBits(matchId, 8);
+    w.writeBits(seq, 32);
+    w.writeBits(view.tick, 32);
+    w.writeBits(view.winner, 2);
+    w.writeBool(key);
+    if (!key) w.writeBits(keyTick, 32);
+}
+
+} // namespace
+
+//--- 릴레이
+
+SpectatorRelay::SpectatorRelay()
+{
+}
+
+bool SpectatorRelay::start(const NetAddress& server, uint16_t port, double delaySeconds)
+{
+    if (!socket.open(port)) return false;
+    serverAddress = server;
+    delay = std::max(0.0, delaySeconds);
+    lastViewerSweep = Net::now();
+    std::cout << "관전 릴레이 시작: 포트 " << socket.getLocalPort() << ", 서버 " << server.toString()
+        << ", 지연 " << delay << "초" << std::endl;
+    return true;
+}
+
+void SpectatorRelay::stop()
+{
+    socket.close();
+    viewers.clear();
+    pending.clear();
+    keyframePacket.reset();
+}
+
+void SpectatorRelay::update()
+{
+    PROFILE_SCOPE("relay.update");
+    receivePackets();
+
+    double now = Net::now();
+    if (now - lastUpstreamTime > UPSTREAM_TIMEOUT && (lastSubscribeTime < 0.0 || now - lastSubscribeTime > 0.5)) {
+        subscribe(0);
+    }
+
+    // 지연이 지난 프레임은 한 번만 인코딩해서 모두에게 보낸다
+    while (!pending.empty() && now - pending.front().receiveTime >= delay) {
+        SharedPacket packet = encodeFrame(pending.front());
+        pending.pop_front();
+        broadcast(packet);
+    }
+
+    if (now - lastViewerSweep >= 1.0) {
+        for (auto it = viewers.begin(); it != viewers.end();) {
+            if (now - it->second > VIEWER_TIMEOUT) it = viewers.erase(it);
+            else ++it;
+        }
+        lastViewerSweep = now;
+    }
+}
+
+void SpectatorRelay::receivePackets()
+{
+    uint8_t buffer[1500];
+    NetAddress from;
+    int size;
+    while ((size = socket.receive(from, buffer, sizeof(buffer))) > 0) {
+        if (from == serverAddress) {
+            handleSnapshot(buffer, static_cast<size_t>(size));
+            continue;
+        }
+        BitReader r(buffer, static_cast<size_t>(size));
+        uint32_t type = 0;
+        if (readPacketHeader(r, type) && type == PACKET_VIEWER_JOIN) handleViewer(from);
+    }
+}
+
+void SpectatorRelay::subscribe(uint32_t ackTick)
+{
+    BitWriter w;
+    writePacketHeader(w, PACKET_SPECTATE);
+    w.writeBits(ackTick, 32);
+    socket.send(serverAddress, w.data().data(), w.byteCount());
+    lastSubscribeTime = Net::now();
+}
+
+void SpectatorRelay::handleSnapshot(const uint8_t* data, size_t size)
+{
+    BitReader r(data, size);
+    uint32_t type = 0;
+    if (!readPacketHeader(r, type) || type != PACKET_SNAPSHOT) return;
+
+    uint8_t match = static_cast<uint8_t>(r.readBits(8));
+    NetView view;
+    view.tick = r.readBits(32);
+    uint32_t baseTick = r.readBits(32);
+    r.readBits(16);   // 입력 순번 (관전자는 쓰지 않음)
+    view.winner = static_cast<uint8_t>(r.readBits(2));
+
+    if (!hasUpstream || match != upstreamMatch) {
+        if (baseTick != 0) return;
+        upstreamMatch = match;
+        receivedViews.clear();
+        latestView = NetView();
+        hasUpstream = false;
+    }
+    if (hasUpstream && view.tick <= latestView.tick) return;
+
+    NetView empty;
+    const NetView* base = &empty;
+    if (baseTick != 0) {
+        auto it = receivedViews.find(baseTick);
+        if (it == receivedViews.end()) return;
+        base = &it->second;
+    }
+    if (!decodeNetViewDelta(r, *base, view)) return;
+
+    receivedViews[view.tick] = view;
+    while (receivedViews.size() > 64) receivedViews.erase(receivedViews.begin());
+    latestView = view;
+    hasUpstream = true;
+    lastUpstreamTime = Net::now();
+    stats.upstreamSnapshots++;
+    subscribe(view.tick);
+
+    DelayedView frame;
+    frame.receiveTime = lastUpstreamTime;
+    frame.matchId = match;
+    frame.view = view;
+    pending.push_back(frame);
+}
+
+void SpectatorRelay::handleViewer(const NetAddress& from)
+{
+    auto it = viewers.find(from);
+    bool isNew = (it == viewers.end());
+    viewers[from] = Net::now();
+    if (!isNew) return;
+
+    // 다음 키프레임까지 기다리지 않도록 마지막 키프레임을 바로 보내 준다
+    if (keyframePacket) {
+        if (socket.send(from, keyframePacket->data(), keyframePacket->size())) {
+            stats.packetsSent++;
+            stats.bytesSent += keyframePacket->size() + UDP_HEADER_BYTES;
+        }
+        else {
+            stats.sendFailures++;
+        }
+    }
+}
+
+SharedPacket SpectatorRelay::encodeFrame(const DelayedView& frame)
+{
+    double encodeStart = Net::now();
+
+    bool key = !hasKeyframe || frame.matchId != streamMatch || framesSinceKeyframe >= RELAY_KEYFRAME_INTERVAL;
+    NetView empty;
+    const NetView& base = key ? empty : keyframe;
+
+    BitWriter w;
+    writeFrameHeader(w, frame.matchId, ++frameSeq, frame.view, key, keyframe.tick);
+    NetView sent;
+    encodeNetViewDelta(w, base, frame.view, sent);
+
+    if (key) {
+        keyframe = sent;
+        hasKeyframe = true;
+        streamMatch = frame.matchId;
+        framesSinceKeyframe = 0;
+        stats.keyframes++;
+    }
+    framesSinceKeyframe++;
+
+    SharedPacket packet = std::make_shared<const std::vector<uint8_t>>(w.data().begin(), w.data().begin() + w.byteCount());
+    if (key) keyframePacket = packet;
+
+    stats.framesEncoded++;
+    stats.maxFrameBytes = std::max(stats.maxFrameBytes, packet->size());
+    stats.encodeSeconds += Net::now() - encodeStart;
+    return packet;
+}
+
+void SpectatorRelay::broadcast(const SharedPacket& packet)
+{
+    double fanoutStart = Net::now();
+    const uint8_t* data = packet->data();
+    size_t size = packet->size();
+    for (const auto& viewer : viewers) {
+        if (socket.send(viewer.first, data, size)) {
+            stats.packetsSent++;
+            stats.bytesSent += size + UDP_HEADER_BYTES;
+        }
+        else {
+            stats.sendFailures++;
+        }
+    }
+    double elapsed = Net::now() - fanoutStart;
+    stats.fanoutSeconds += elapsed;
+    stats.maxFanoutSeconds = std::max(stats.maxFanoutSeconds, elapsed);
+}
+
+void SpectatorRelay::printStats(double elapsed) const
+{
+    double perFrame = stats.framesEncoded ? static_cast<double>(stats.packetsSent) / stats.framesEncoded : 0.0;
+    std::cout << "[릴레이] 시청자 " << viewers.size() << ", 서버 스냅샷 " << stats.upstreamSnapshots
+        << ", 인코딩 " << stats.framesEncoded << "회 (키프레임 " << stats.keyframes << "), 송신 " << stats.packetsSent
+        << " 패킷 (인코딩 1회당 " << perFrame << "), 실패 " << stats.sendFailures << std::endl;
+    if (stats.framesEncoded == 0) return;
+    std::cout << "[릴레이] 송신 " << (elapsed > 0.0 ? stats.bytesSent / elapsed / (1024.0 * 1024.0) : 0.0)
+        << " MB/s, 최대 프레임 " << stats.maxFrameBytes << " bytes, 인코딩 평균 "
+        << stats.encodeSeconds / stats.framesEncoded * 1e6 << " us, 팬아웃 평균 "
+        << stats.fanoutSeconds / stats.framesEncoded * 1e3 << " ms / 최대 " << stats.maxFanoutSeconds * 1e3 << " ms ("
+        << (stats.packetsSent ? stats.fanoutSeconds / stats.packetsSent * 1e9 : 0.0) << " ns/패킷)" << std::endl;
+}
+
+//--- 시청자
+
+SpectatorClient::SpectatorClient()
+{
+}
+
+bool SpectatorClient::connect(const NetAddress& relay)
+{
+    if (!socket.open(0)) return false;
+    relayAddress = relay;
+    lastJoinTime = -1.0;
+    lastReceiveTime = Net::now();
+    std::cout << "릴레이 시청 시작: " << relay.toString() << std::endl;
+    return true;
+}
+
+void SpectatorClient::disconnect()
+{
+    socket.close();
+    hasView = false;
+    hasKeyframe = false;
+    world.reset();
+}
+
+void SpectatorClient::update()
+{
+    receivePackets();
+
+    double now = Net::now();
+    if (lastJoinTime < 0.0 || now - lastJoinTime >= VIEWER_JOIN_INTERVAL) {
+        BitWriter w;
+        writePacketHeader(w, PACKET_VIEWER_JOIN);
+        socket.send(relayAddress, w.data().data(), w.byteCount());
+        lastJoinTime = now;
+    }
+    if (!timedOut && now - lastReceiveTime > VIEWER_TIMEOUT) {
+        std::cout << "릴레이 응답 없음, 계속 재접속 시도" << std::endl;
+        timedOut = true;
+    }
+
+    if (!hasView) return;
+
+    // 다음 프레임이 올 때까지 두 캐릭터 모두 보간, 눈덩이는 궤적만 외삽
+    interpTicks++;
+    float t = std::min(static_cast<float>(interpTicks) / SNAPSHOT_INTERVAL_TICKS, 1.0f);
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        CharacterState s = to[i];
+        s.pos = glm::mix(from[i].pos, to[i].pos, t);
+        world.setCharacterState(i, s);
+    }
+    world.snowSystem.updateAnimations(TICK_DELTA_TIME);
+    for (auto& sb : world.snowballs) sb.integrate(TICK_DELTA_TIME);
+    world.tickCount++;
+}
+
+void SpectatorClient::receivePackets()
+{
+    uint8_t buffer[1500];
+    NetAddress from;
+    int size;
+    while ((size = socket.receive(from, buffer, sizeof(buffer))) > 0) {
+        if (from != relayAddress) continue;
+        stats.bytesReceived += size + UDP_HEADER_BYTES;
+        handlePacket(buffer, static_cast<size_t>(size));
+    }
+}
+
+void SpectatorClient::handlePacket(const uint8_t* data, size_t size)
+{
+    BitReader r(data, size);
+    uint32_t type = 0;
+    if (!readPacketHeader(r, type) || type != PACKET_RELAY_FRAME) return;
+    lastReceiveTime = Net::now();
+    timedOut = false;
+
+    uint8_t match = static_cast<uint8_t>(r.readBits(8));
+    uint32_t seq = r.readBits(32);
+    NetView view;
+    view.tick = r.readBits(32);
+    view.winner = static_cast<uint8_t>(r.readBits(2));
+    bool key = r.readBool();
+    uint32_t keyTick = key ? 0 : r.readBits(32);
+    if (r.overflowed()) return;
+
+    if (lastSeq != 0 && seq <= lastSeq && !key) return;
+    if (lastSeq != 0 && seq > lastSeq + 1) stats.lost += seq - lastSeq - 1;
+
+    if (key) {
+        NetView empty;
+        if (!decodeNetViewDelta(r, empty, view)) return;
+        if (!hasView || match != matchId) {
+            // 첫 화면이거나 서버가 새 경기를 시작했다
+            world.initialize();
+            hasView = false;
+        }
+        matchId = match;
+        keyframe = view;
+        hasKeyframe = true;
+        stats.keyframes++;
+    }
+    else {
+        if (!hasKeyframe || match != matchId || keyframe.tick != keyTick) {
+            stats.skipped++;
+            return;
+        }
+        if (!decodeNetViewDelta(r, keyframe, view)) return;
+    }
+    if (hasView && view.tick <= latestView.tick) return;
+
+    lastSeq = std::max(lastSeq, seq);
+    stats.frames++;
+    applyView(view);
+}
+
+void SpectatorClient::applyView(const NetView& view)
+{
+    const NetView previous = latestView;
+    const bool hadView = hasView;
+    latestView = view;
+    hasView = true;
+
+    world.winner = static_cast<Winner>(view.winner);
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        from[i] = hadView ? world.getCharacterState(i) : view.characters[i];
+        to[i] = view.characters[i];
+        world.players[i].charging = view.players[i].charging;
+        world.players[i].throwHeld = view.players[i].throwHeld;
+    }
+    interpTicks = 0;
+    world.tickCount = view.tick;
+
+    applyNetViewObjects(world, view, hadView ? &previous : nullptr);
+}
+
+//--- 실행 모드
+
+int runSpectatorRelay(const NetAddress& server, uint16_t port, double delaySeconds, float seconds)
+{
+    Init::graphicsEnabled() = false;
+    if (!Net::initialize()) return 1;
+
+    SpectatorRelay relay;
+    if (!relay.start(server, port, delaySeconds)) return 1;
+
+    double start = Net::now();
+    double lastReport = start;
+    while (seconds <= 0.0f || Net::now() - start < seconds) {
+        relay.update();
+        Profiler::updateCapture();
+        if (Net::now() - lastReport >= 5.0) {
+            relay.printStats(Net::now() - start);
+            lastReport = Net::now();
+        }
+        Net::sleepMs(1);
+    }
+    relay.printStats(Net::now() - start);
+    relay.stop();
+    Net::shutdown();
+    return 0;
+}
+
+namespace {
+
+// 부하 테스트용 가벼운 시청자: 디코딩 없이 순번과 바이트만 센다
+struct LoadViewer {
+    UdpSocket socket;
+    double nextJoinTime = 0.0;
+    uint32_t firstSeq = 0;
+    uint32_t lastSeq = 0;
+    uint32_t received = 0;
+    uint64_t bytes = 0;
+};
+
+} // namespace
+
+int runRelayLoadTest(int viewerCount, float seconds, double delaySeconds)
+{
+    Init::graphicsEnabled() = false;
+    if (!Net::initialize()) return 1;
+
+    GameServer server;
+    SpectatorRelay relay;
+    {
+        SimLog::Mute mute;
+        if (!server.start(0, NetConditions())) return 1;
+        server.setBotsEnabled(true, 1);
+    }
+    NetAddress serverAddress;
+    NetAddress::parse("127.0.0.1", server.getPort(), serverAddress);
+    if (!relay.start(serverAddress, 0, delaySeconds)) return 1;
+    NetAddress relayAddress;
+    NetAddress::parse("127.0.0.1", relay.getPort(), relayAddress);
+
+    // 서버와 릴레이는 각자 스레드에서, 시청자는 이 스레드에서 돌린다
+    std::atomic<bool> running(true);
+    std::thread serverThread([&]() {
+        SimLog::Mute mute;
+        Profiler::setThreadName("server");
+        double nextTick = Net::now();
+        while (running) {
+            server.update();
+            nextTick += TICK_DELTA_TIME;
+            double wait = nextTick - Net::now();
+            if (wait > 0.0) Net::sleepMs(static_cast<int>(wait * 1000.0));
+        }
+    });
+    std::thread relayThread([&]() {
+        Profiler::setThreadName("relay");
+        while (running) {
+            relay.update();
+            Net::sleepMs(1);
+        }
+    });
+
+    std::vector<std::unique_ptr<LoadViewer>> viewers;
+    double start = Net::now();
+    for (int i = 0; i < viewerCount; ++i) {
+        std::unique_ptr<LoadViewer> v(new LoadViewer());
+        if (!v->socket.open(0)) break;
+        // 등록은 첫 1초 동안 고르게 나눠 보낸다
+        v->nextJoinTime = start + static_cast<double>(i) / viewerCount;
+        viewers.push_back(std::move(v));
+    }
+    if (static_cast<int>(viewers.size()) < viewerCount) {
+        std::cerr << "시청자 소켓 " << viewers.size() << "개만 열림 (파일 디스크립터 한도 확인)" << std::endl;
+    }
+
+    // 실제로 디코딩해서 화면 상태를 만드는 시청자 몇 명
+    const int decoderCount = 4;
+    std::vector<std::unique_ptr<SpectatorClient>> decoders;
+    for (int i = 0; i < decoderCount; ++i) {
+        std::unique_ptr<SpectatorClient> d(new SpectatorClient());
+        if (d->connect(relayAddress)) decoders.push_back(std::move(d));
+    }
+
+    SimLog::Mute mute;
+    // 등록 주기를 조금씩 흔든다. 모두 정확히 1초 주기면 같은 시청자가 매번 팬아웃 중인
+    // 릴레이에 등록을 보내게 되어 수신 버퍼가 넘칠 때 계속 같은 시청자만 빠진다.
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<double> joinJitter(0.75, 1.25);
+    uint8_t buffer[1500];
+    BitWriter join;
+    writePacketHeader(join, PACKET_VIEWER_JOIN);
+    double nextDecoderTick = start;
+    while (Net::now() - start < seconds) {
+        Profiler::updateCapture();
+        double now = Net::now();
+        for (auto& v : viewers) {
+            if (now >= v->nextJoinTime) {
+                v->socket.send(relayAddress, join.data().data(), join.byteCount());
+                v->nextJoinTime = now + VIEWER_JOIN_INTERVAL * joinJitter(rng);
+            }
+            NetAddress from;
+            int size;
+            while ((size = v->socket.receive(from, buffer, sizeof(buffer))) > 0) {
+                BitReader r(buffer, static_cast<size_t>(size));
+                uint32_t type = 0;
+                if (!readPacketHeader(r, type) || type != PACKET_RELAY_FRAME) continue;
+                r.readBits(8);
+                uint32_t seq = r.readBits(32);
+                if (v->received == 0) v->firstSeq = seq;
+                v->lastSeq = std::max(v->lastSeq, seq);
+                v->received++;
+                v->bytes += size + UDP_HEADER_BYTES;
+            }
+        }
+        if (now >= nextDecoderTick) {
+            for (auto& d : decoders) d->update();
+            nextDecoderTick += TICK_DELTA_TIME;
+        }
+        Net::sleepMs(1);
+    }
+    double elapsed = Net::now() - start;
+    running = false;
+    serverThread.join();
+    relayThread.join();
+    Profiler::finishCapture();
+
+    // 전달률: 첫 프레임 이후 릴레이가 보낸 프레임 중 받은 비율
+    uint64_t expected = 0, received = 0, bytes = 0;
+    int silent = 0;
+    for (const auto& v : viewers) {
+        if (v->received == 0) {
+            silent++;
+            continue;
+        }
+        expected += v->lastSeq - v->firstSeq + 1;
+        received += v->received;
+        bytes += v->bytes;
+    }
+    double delivery = expected ? 100.0 * received / expected : 0.0;
+    int active = static_cast<int>(viewers.size()) - silent;
+
+    std::cout << "\n=== 관전 릴레이 부하 테스트 (시청자 " << viewers.size() << "명, " << elapsed << "초, 지연 "
+        << delaySeconds << "초) ===" << std::endl;
+    relay.printStats(elapsed);
+    std::cout << "[시청자] 수신 " << active << "명, 못 받음 " << silent << "명, 전달률 " << delivery
+        << "%, 시청자당 " << (active ? bytes / elapsed / active / 1024.0 : 0.0) << " KB/s" << std::endl;
+
+    bool pass = !viewers.empty() && silent == 0 && delivery >= 99.0;
+    for (size_t i = 0; i < decoders.size(); ++i) {
+        const SpectatorStats& s = decoders[i]->getStats();
+        std::cout << "[디코더 " << i << "] 프레임 " << s.frames << " (키프레임 " << s.keyframes << "), 건너뜀 "
+            << s.skipped << ", 유실 " << s.lost << std::endl;
+        if (s.frames == 0 || !decoders[i]->getWorld().hasCharacters()) pass = false;
+    }
+    std::cout << (pass ? "PASS" : "FAIL") << std::endl;
+
+    relay.stop();
+    server.stop();
+    Net::shutdown();
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+﻿#pragma once
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include "NetGame.h"
+
+constexpr uint16_t DEFAULT_RELAY_PORT = 27100;
+constexpr double DEFAULT_SPECTATOR_DELAY = 1.0;     // 관전 화면은 실제 경기보다 이만큼 늦다 (초)
+constexpr int RELAY_KEYFRAME_INTERVAL = 20;         // 프레임 20개(약 1초)마다 키프레임
+constexpr int DEFAULT_LOADTEST_VIEWERS = 5000;
+
+// 한 번 인코딩한 프레임 패킷. 모든 시청자에게 같은 버퍼를 그대로 보낸다.
+typedef std::shared_ptr<const std::vector<uint8_t>> SharedPacket;
+
+struct RelayStats {
+    uint32_t upstreamSnapshots = 0;
+    uint32_t framesEncoded = 0;
+    uint32_t keyframes = 0;
+    uint64_t packetsSent = 0;
+    uint64_t bytesSent = 0;            // IP/UDP 헤더 포함
+    uint64_t sendFailures = 0;
+    size_t maxFrameBytes = 0;
+    double encodeSeconds = 0.0;
+    double fanoutSeconds = 0.0;
+    double maxFanoutSeconds = 0.0;
+};
+
+// 서버에 관전자로 한 번만 구독하고, 받은 경기를 조금 늦춰 많은 시청자에게 다시 뿌린다.
+// 시청자별 기준 상태를 두지 않으므로 델타는 "마지막 키프레임" 대비로 만든다.
+// 델타를 잃으면 그 프레임만 빠지고, 키프레임을 잃으면 다음 키프레임까지 기다린다.
+class SpectatorRelay
+{
+public:
+    SpectatorRelay();
+
+    bool start(const NetAddress& server, uint16_t port, double delaySeconds);
+    void stop();
+
+    // 수시로 호출: 서버 스냅샷/시청자 등록 수신, 지연이 지난 프레임 송출
+    void update();
+    void printStats(double elapsed) const;
+
+    uint16_t getPort() const { return socket.getLocalPort(); }
+    size_t getViewerCount() const { return viewers.size(); }
+    const RelayStats& getStats() const { return stats; }
+
+private:
+    struct DelayedView {
+        double receiveTime;
+        uint8_t matchId;
+        NetView view;
+    };
+
+    void receivePackets();
+    void handleSnapshot(const uint8_t* data, size_t size);
+    void handleViewer(const NetAddress& from);
+    void subscribe(uint32_t ackTick);
+    SharedPacket encodeFrame(const DelayedView& frame);
+    void broadcast(const SharedPacket& packet);
+
+    UdpSocket socket;
+    NetAddress serverAddress;
+    double delay = DEFAULT_SPECTATOR_DELAY;
+
+    // 서버 쪽 (일반 클라이언트와 같은 델타 스냅샷을 받는다)
+    uint8_t upstreamMatch = 0;
+    bool hasUpstream = false;
+    std::map<uint32_t, NetView> receivedViews;
+    NetView latestView;
+    double lastUpstreamTime = 0.0;
+    double lastSubscribeTime = -1.0;
+    std::deque<DelayedView> pending;
+
+    // 시청자 쪽
+    std::map<NetAddress, double> viewers;   // 주소 -> 마지막 등록 시각
+    double lastViewerSweep = 0.0;
+    uint32_t frameSeq = 0;
+    uint8_t streamMatch = 0;
+    bool hasKeyframe = false;
+    NetView keyframe;
+    int framesSinceKeyframe = 0;
+    SharedPacket keyframePacket;           // 새로 들어온 시청자에게 바로 보낸다
+
+    RelayStats stats;
+};
+
+struct SpectatorStats {
+    uint64_t bytesReceived = 0;
+    uint32_t frames = 0;
+    uint32_t keyframes = 0;
+    uint32_t skipped = 0;      // 기준 키프레임이 없어 버린 프레임
+    uint32_t lost = 0;         // 순번이 빈 프레임
+};
+
+// 릴레이에서 관전 프레임을 받아 두 캐릭터를 보간해 보여준다 (조작 없음)
+class SpectatorClient
+{
+public:
+    SpectatorClient();
+
+    bool connect(const NetAddress& relay);
+    void disconnect();
+
+    // 한 틱 진행
+    void update();
+
+    GameWorld& getWorld() { return world; }
+    bool hasFrame() const { return hasView; }
+    const SpectatorStats& getStats() const { return stats; }
+
+private:
+    void receivePackets();
+    void handlePacket(const uint8_t* data, size_t size);
+    void applyView(const NetView& view);
+
+    UdpSocket socket;
+    NetAddress relayAddress;
+    GameWorld world;
+    double lastJoinTime = -1.0;
+    double lastReceiveTime = 0.0;
+    bool timedOut = false;
+
+    uint8_t matchId = 0;
+    bool hasKeyframe = false;
+    NetView keyframe;
+    NetView latestView;
+    bool hasView = false;
+    uint32_t lastSeq = 0;
+
+    CharacterState from[PLAYER_COUNT], to[PLAYER_COUNT];
+    int interpTicks = 0;
+
+    SpectatorStats stats;
+};
+
+// 서버에 붙어 시청자에게 중계만 하는 프로세스 (seconds가 0이면 계속 실행)
+int runSpectatorRelay(const NetAddress& server, uint16_t port, double delaySeconds, float seconds);
+// 봇 경기 서버 + 릴레이 + 시청자 viewerCount명을 한 프로세스에서 돌려 팬아웃 비용/전달률을 보고
+int runRelayLoadTest(int viewerCount, float seconds, double delaySeconds);
@@ -1,4 +1,5 @@
-﻿#include "Character.h"
+﻿#pragma once
+#include "Character.h"
 #include "Map.h"
 #include "Snow.h"
 
@@ -8,6 +9,7 @@ namespace Steve {
 	public:
 		Part gBody, gHead, gArmL, gArmR, gLegL, gLegR, gBoundingBox;
 		GLuint textureID;
+		int textureLayer = -1;
 		glm::vec3 pos = { 4.5f, 1.5f, 2.0f };
 		glm::vec2 moveDir = { 0.0f, 0.0f }; 
 		GLfloat moveSpeed = 0.085f; 
@@ -21,7 +23,7 @@ namespace Steve {
 		glm::vec3 boundingBoxSize; 
 
 		Character(const char* texturePath) {
-			textureID = Init::loadTexture(texturePath);
+			textureID = Init::loadSkin(texturePath, textureLayer);
 
 			const float gap = 0.02f; 
 			glm::vec3 bodyH(0.3f, 0.35f, 0.15f);   
@@ -87,6 +89,20 @@ namespace Steve {
 			armState = 3; // LOWERING
 		}
 
+		CharacterState getState() const {
+			CharacterState s;
+			s.pos = pos; s.moveDir = moveDir;
+			s.armState = armState; s.armAngle = armAngle; s.armDir = armDir;
+			s.legState = legState; s.legAngle = legAngle; s.legDir = legDir;
+			return s;
+		}
+
+		void setState(const CharacterState& s) {
+			pos = s.pos; moveDir = s.moveDir;
+			armState = s.armState; armAngle = s.armAngle; armDir = s.armDir;
+			legState = s.legState; legAngle = s.legAngle; legDir = s.legDir;
+		}
+
 		bool checkCollision(const glm::vec3& characterMin, const glm::vec3& characterMax, const Block& block) {
 			float blockSize = block.getSize();
 			glm::vec3 blockMin = { block.getX() - blockSize / 2.0f, block.getY() - blockSize / 2.0f, block.getZ() - blockSize / 2.0f };
@@ -240,22 +256,19 @@ namespace Steve {
 			}
 		}
 
-		void drawBoundingBox(GLuint modelLoc, const glm::mat4& M) {
-			glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &M[0][0]);
-			glBindVertexArray(gBoundingBox.vao);
-			glDrawArrays(GL_LINES, 0, gBoundingBox.count);
-			glBindVertexArray(0);
+		void drawBoundingBox(Render::DrawList& out, const glm::mat4& M) {
+			Render::DrawItem item(gBoundingBox.mesh, GL_LINES);
+			item.model = M;
+			out.add(item);
 		}
 
-		void draw(GLuint modelLoc) {
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, textureID);
-
+		void draw(Render::DrawList& out) {
 			auto drawVAO = [&](const Part& p, const glm::mat4& M) {
-				glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &M[0][0]);
-				glBindVertexArray(p.vao);
-				glDrawArrays(GL_TRIANGLES, 0, p.count);
-				glBindVertexArray(0);
+				Render::DrawItem item(p.mesh);
+				item.texture = textureID;
+				item.layer = textureLayer;
+				item.model = M;
+				out.add(item);
 				};
 
 			glm::mat4 Mbase = glm::translate(glm::mat4(1.0f), pos);
@@ -0,0 +1,126 @@
+﻿#include "TextureArray.h"
+#include "BlockCompression.h"
+#include "TextureLoader.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    int wrapIndex(int i, int size)
+    {
+        i %= size;
+        return i < 0 ? i + size : i;
+    }
+
+    // RGBA src(width x height)를 dst(size x size)로. GL_REPEAT 텍셀 중심 규칙 그대로 쌍선형으로 뽑는다.
+    void resampleRepeat(const unsigned char* src, int width, int height, unsigned char* dst, int size)
+    {
+        if (width == size && height == size) {
+            std::memcpy(dst, src, static_cast<size_t>(size) * size * 4);
+            return;
+        }
+        for (int y = 0; y < size; ++y) {
+            float v = (y + 0.5f) * height / size - 0.5f;
+            int y0 = static_cast<int>(std::floor(v));
+            float fy = v - y0;
+            int rows[2] = { wrapIndex(y0, height), wrapIndex(y0 + 1, height) };
+            for (int x = 0; x < size; ++x) {
+                float u = (x + 0.5f) * width / size - 0.5f;
+                int x0 = static_cast<int>(std::floor(u));
+                float fx = u - x0;
+                int cols[2] = { wrapIndex(x0, width), wrapIndex(x0 + 1, width) };
+
+                const unsigned char* p00 = src + (rows[0] * width + cols[0]) * 4;
+                const unsigned char* p10 = src + (rows[0] * width + cols[1]) * 4;
+                const unsigned char* p01 = src + (rows[1] * width + cols[0]) * 4;
+                const unsigned char* p11 = src + (rows[1] * width + cols[1]) * 4;
+                unsigned char* out = dst + (y * size + x) * 4;
+                for (int c = 0; c < 4; ++c) {
+                    float top = p00[c] + (p10[c] - p00[c]) * fx;
+                    float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+                    out[c] = static_cast<unsigned char>(top + (bottom - top) * fy + 0.5f);
+                }
+            }
+        }
+    }
+}
+
+const int Render::TextureArray::LAYER_SIZE;
+const unsigned char Render::TextureArray::PLACEHOLDER_VALUE;
+
+int Render::TextureArray::addLayer(const std::string& path)
+{
+    auto found = layers.find(path);
+    if (found != layers.end()) return found->second;
+
+    // 형식은 배열을 처음 만들 때 정한다. 월드 셰이더는 rgb만 읽으므로 압축하면 알파 없는 BC1이다.
+    if (layers.empty()) format = BlockCompression::isEnabled() ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_RGBA8;
+
+    // 디코드가 끝날 때까지는 회색 층으로 그린다
+    const size_t layerBytes = static_cast<size_t>(LAYER_SIZE) * LAYER_SIZE * 4;
+    int layer = static_cast<int>(layers.size());
+    pixels.resize(layerBytes * (layer + 1), PLACEHOLDER_VALUE);
+    layers[path] = layer;
+    encodeLayer(layer);
+    upload();
+
+    textureLoader().request(path, [this, layer, layerBytes](const DecodedImage& image) {
+        unsigned char* dst = pixels.data() + layerBytes * layer;
+        if (image.pixels) resampleRepeat(image.pixels, image.width, image.height, dst, LAYER_SIZE);
+        else std::memset(dst, 255, layerBytes);     // 못 읽은 이미지는 예전처럼 흰색
+
+        TextureArrayDesc desc = makeDesc();
+        desc.pixels = encodeLayer(layer);
+        backend().uploadTextureLayer(texture.get(), layer, desc);
+    });
+    return layer;
+}
+
+Render::TextureArrayDesc Render::TextureArray::makeDesc() const
+{
+    TextureArrayDesc desc;
+    desc.width = LAYER_SIZE;
+    desc.height = LAYER_SIZE;
+    desc.layers = static_cast<int>(layers.size());
+    // 블록과 눈이 쓰던 GL_LINEAR 축소를 그대로 쓴다. 층 전체에 삼선형(밉맵)을 걸면 화면 대부분을 덮는
+    // 블록 비용이 늘어서 (llvmpipe에서 월드 프레임 +20%) 캐릭터 스킨도 같은 필터로 맞췄다.
+    desc.minFilter = GL_LINEAR;
+    desc.mipmaps = false;
+    desc.format = format;
+    return desc;
+}
+
+const unsigned char* Render::TextureArray::encodeLayer(int layer)
+{
+    const size_t layerBytes = static_cast<size_t>(LAYER_SIZE) * LAYER_SIZE * 4;
+    const unsigned char* rgba = pixels.data() + layerBytes * layer;
+    if (format == GL_RGBA8) return rgba;
+
+    const size_t blockBytes = BlockCompression::encodedSize(format, LAYER_SIZE, LAYER_SIZE);
+    if (blocks.size() < blockBytes * (layer + 1)) blocks.resize(blockBytes * (layer + 1));
+    unsigned char* out = blocks.data() + blockBytes * layer;
+    BlockCompression::encode(format, rgba, LAYER_SIZE, LAYER_SIZE, out);
+    return out;
+}
+
+void Render::TextureArray::upload()
+{
+    TextureArrayDesc desc = makeDesc();
+    desc.pixels = format == GL_RGBA8 ? pixels.data() : blocks.data();
+    // 처음에만 이름이 생기고, 그 뒤로는 같은 이름에 다시 올린다
+    GLuint name = texture.get();
+    backend().uploadTextureArray(name, desc);
+    if (name != texture.get()) texture = Texture(name);
+}
+
+size_t Render::TextureArray::getGpuBytes() const
+{
+    return BlockCompression::encodedSize(format, LAYER_SIZE, LAYER_SIZE) * layers.size();
+}
+
+Render::TextureArray& Render::worldTextures()
+{
+    // 정적 객체 소멸자가 프로그램 종료 중에도 부를 수 있게 일부러 해제하지 않는다
+    static TextureArray* textures = new TextureArray();
+    return *textures;
+}
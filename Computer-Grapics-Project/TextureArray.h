@@ -0,0 +1,46 @@
+﻿#pragma once
+#include "RenderBackend.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Render {
+
+    // 월드에서 쓰는 이미지(블록, 눈, 캐릭터 스킨)를 GL_TEXTURE_2D_ARRAY 하나에 층으로 모은다.
+    // 그리기는 이 배열의 이름과 층 번호만 들고 있어서, 월드 패스 안에서는 텍스처를 다시 바인드하지 않는다.
+    //
+    // 층은 모두 LAYER_SIZE 정사각형 RGBA다. 크기가 다른 이미지(16x16 블록)는 반복 가장자리를 따라
+    // 쌍선형으로 늘려 넣으므로, 원래 텍스처를 GL_LINEAR로 확대한 것과 거의 같게 보인다.
+    // 층을 더하면 같은 이름에 전체를 다시 올리므로 먼저 받아 둔 이름도 계속 쓸 수 있다.
+    // 이미지는 TextureLoader 워커가 디코드하고, 그동안 그 층은 회색 자리표시다.
+    // BlockCompression이 켜져 있으면 층을 BC1로 인코딩해서 올린다 (RGBA 사본은 다시 인코딩할 때 쓴다).
+    class TextureArray
+    {
+    public:
+        static const int LAYER_SIZE = 64;
+        static const unsigned char PLACEHOLDER_VALUE = 160;
+
+        // path 이미지의 층 번호. 처음 보는 경로면 층을 더하고 디코드를 요청한다. 못 읽으면 흰색 층이 된다.
+        int addLayer(const std::string& path);
+        GLuint getTexture() const { return texture.get(); }
+        int getLayerCount() const { return static_cast<int>(layers.size()); }
+        GLenum getFormat() const { return format; }
+        // 텍스처가 GPU에서 차지하는 양
+        size_t getGpuBytes() const;
+
+    private:
+        TextureArrayDesc makeDesc() const;
+        // 층의 RGBA를 배열 형식으로 바꿔 그 층 데이터를 돌려준다
+        const unsigned char* encodeLayer(int layer);
+        void upload();
+
+        Texture texture;
+        std::map<std::string, int> layers;
+        std::vector<unsigned char> pixels;      // 층마다 LAYER_SIZE * LAYER_SIZE * 4
+        GLenum format = GL_RGBA8;
+        std::vector<unsigned char> blocks;      // 압축 형식일 때 층마다 인코딩한 블록
+    };
+
+    // 블록, 눈, 캐릭터가 같이 쓰는 배열
+    TextureArray& worldTextures();
+}
@@ -0,0 +1,318 @@
+﻿#include "TextureCache.h"
+#include "AssetPack.h"
+#include "BlockCompression.h"
+#include "MappedFile.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+const uint32_t Render::TextureCache::MAGIC;
+const uint32_t Render::TextureCache::VERSION;
+
+namespace {
+    // .gtex: 헤더, 단계 표, 16바이트 정렬된 단계 픽셀. 파일 그대로 매핑해서 읽으므로 채움 없이 고정 크기다.
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint64_t sourceHash;
+        uint32_t format;        // GL 내부 형식 (GL_RGBA8, 또는 S3TC DXT1/DXT5)
+        uint32_t channels;      // 원본 채널 수 (로그용)
+        uint32_t levelCount;
+        uint32_t reserved;
+    };
+    struct LevelEntry {
+        uint32_t width;
+        uint32_t height;
+        uint32_t offset;        // 파일 처음부터
+        uint32_t size;
+    };
+    static_assert(sizeof(FileHeader) == 48, "FileHeader는 파일 배치와 같아야 한다");
+    static_assert(sizeof(LevelEntry) == 16, "LevelEntry는 파일 배치와 같아야 한다");
+
+    const uint32_t MAX_LEVELS = 16;     // 32768 한 변까지
+    const size_t DATA_ALIGNMENT = 16;
+
+    struct SourceInfo {
+        uint64_t size = 0;
+        int64_t time = 0;
+    };
+
+    bool statSource(const std::string& path, SourceInfo& out)
+    {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) return false;
+        out.size = static_cast<uint64_t>(info.st_size);
+        out.time = static_cast<int64_t>(info.st_mtime);
+        return true;
+    }
+
+    bool readFile(const std::string& path, std::vector<unsigned char>& out)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        std::streamoff size = file.tellg();
+        if (size <= 0) return false;
+        out.resize(static_cast<size_t>(size));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), size));
+    }
+
+    // 헤더와 단계 표가 말이 되고 모든 단계가 파일 안에 있으면 헤더를, 아니면 nullptr
+    const FileHeader* parseHeader(const unsigned char* data, size_t size, bool compress)
+    {
+        if (size < sizeof(FileHeader)) return nullptr;
+        const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+        bool formatOk = compress ? BlockCompression::isCompressed(header->format) : header->format == GL_RGBA8;
+        if (header->magic != Render::TextureCache::MAGIC || header->version != Render::TextureCache::VERSION ||
+            !formatOk || header->levelCount == 0 || header->levelCount > MAX_LEVELS) return nullptr;
+        size_t tableEnd = sizeof(FileHeader) + header->levelCount * sizeof(LevelEntry);
+        if (size < tableEnd) return nullptr;
+
+        const LevelEntry* levels = reinterpret_cast<const LevelEntry*>(data + sizeof(FileHeader));
+        for (uint32_t i = 0; i < header->levelCount; ++i) {
+            const LevelEntry& level = levels[i];
+            if (level.width == 0 || level.height == 0 || level.offset < tableEnd ||
+                BlockCompression::encodedSize(header->format, level.width, level.height) != level.size ||
+                static_cast<uint64_t>(level.offset) + level.size > size) return nullptr;
+        }
+        return header;
+    }
+
+    void fillImage(const unsigned char* data, Render::DecodedImage& out)
+    {
+        const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+        const LevelEntry* levels = reinterpret_cast<const LevelEntry*>(data + sizeof(FileHeader));
+        out.levels.clear();
+        for (uint32_t i = 0; i < header->levelCount; ++i) {
+            Render::TextureLevel level;
+            level.pixels = data + levels[i].offset;
+            level.width = static_cast<int>(levels[i].width);
+            level.height = static_cast<int>(levels[i].height);
+            level.size = levels[i].size;
+            out.levels.push_back(level);
+        }
+        out.pixels = out.levels[0].pixels;
+        out.width = out.levels[0].width;
+        out.height = out.levels[0].height;
+        out.channels = static_cast<int>(header->channels);
+        out.format = header->format;
+    }
+
+    // 2x2 상자 평균 (glGenerateMipmap이 보통 하는 것과 같다). 홀수 변의 마지막 텍셀은 가장자리를 한 번 더 쓴다.
+    void downsample(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int width, int height)
+    {
+        for (int y = 0; y < height; ++y) {
+            const unsigned char* row0 = src + static_cast<size_t>(std::min(2 * y, srcHeight - 1)) * srcWidth * 4;
+            const unsigned char* row1 = src + static_cast<size_t>(std::min(2 * y + 1, srcHeight - 1)) * srcWidth * 4;
+            for (int x = 0; x < width; ++x) {
+                int x0 = std::min(2 * x, srcWidth - 1) * 4;
+                int x1 = std::min(2 * x + 1, srcWidth - 1) * 4;
+                unsigned char* out = dst + (static_cast<size_t>(y) * width + x) * 4;
+                for (int c = 0; c < 4; ++c) {
+                    out[c] = static_cast<unsigned char>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+                }
+            }
+        }
+    }
+
+    size_t alignUp(size_t value)
+    {
+        return (value + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+    }
+
+    // RGBA 원본에서 1x1까지 밉 단계를 만들어 .gtex 파일 모양 그대로 blob에 담는다. compress면 단계마다 블록으로 인코딩한다.
+    void buildFile(const unsigned char* rgba, int width, int height, int channels, const SourceInfo& source, uint64_t hash,
+        bool compress, std::vector<unsigned char>& blob)
+    {
+        // 밉은 RGBA로 만들고 (블록을 줄이면 오차가 쌓인다) 인코딩은 단계마다 따로 한다
+        std::vector<std::vector<unsigned char>> chain(1, std::vector<unsigned char>(rgba, rgba + static_cast<size_t>(width) * height * 4));
+        std::vector<LevelEntry> levels;
+        int w = width, h = height;
+        for (;;) {
+            LevelEntry level;
+            level.width = static_cast<uint32_t>(w);
+            level.height = static_cast<uint32_t>(h);
+            levels.push_back(level);
+            if ((w == 1 && h == 1) || levels.size() == MAX_LEVELS) break;
+            int nextWidth = std::max(1, w / 2), nextHeight = std::max(1, h / 2);
+            chain.push_back(std::vector<unsigned char>(static_cast<size_t>(nextWidth) * nextHeight * 4));
+            downsample(chain[chain.size() - 2].data(), w, h, chain.back().data(), nextWidth, nextHeight);
+            w = nextWidth;
+            h = nextHeight;
+        }
+
+        GLenum format = compress ? BlockCompression::chooseFormat(rgba, width, height) : GL_RGBA8;
+        size_t offset = alignUp(sizeof(FileHeader) + levels.size() * sizeof(LevelEntry));
+        for (LevelEntry& level : levels) {
+            level.size = static_cast<uint32_t>(BlockCompression::encodedSize(format, level.width, level.height));
+            level.offset = static_cast<uint32_t>(offset);
+            offset = alignUp(offset + level.size);
+        }
+        blob.assign(offset, 0);
+
+        FileHeader header;
+        header.magic = Render::TextureCache::MAGIC;
+        header.version = Render::TextureCache::VERSION;
+        header.sourceSize = source.size;
+        header.sourceTime = source.time;
+        header.sourceHash = hash;
+        header.format = format;
+        header.channels = static_cast<uint32_t>(channels);
+        header.levelCount = static_cast<uint32_t>(levels.size());
+        header.reserved = 0;
+        std::copy(reinterpret_cast<const unsigned char*>(&header), reinterpret_cast<const unsigned char*>(&header + 1), blob.begin());
+        std::copy(reinterpret_cast<const unsigned char*>(levels.data()), reinterpret_cast<const unsigned char*>(levels.data() + levels.size()),
+            blob.begin() + sizeof(FileHeader));
+
+        for (size_t i = 0; i < levels.size(); ++i) {
+            const LevelEntry& level = levels[i];
+            if (format == GL_RGBA8) std::copy(chain[i].begin(), chain[i].end(), blob.begin() + level.offset);
+            else BlockCompression::encode(format, chain[i].data(), level.width, level.height, blob.data() + level.offset);
+        }
+    }
+
+    // 워커 여럿이 같은 캐시를 쓰더라도 임시 파일이 겹치지 않게
+    std::atomic<unsigned int> temporarySerial(0);
+
+    void writeFile(const std::string& path, const std::vector<unsigned char>& blob)
+    {
+        std::string temporary = path + ".tmp" + std::to_string(temporarySerial++);
+        {
+            std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+            if (!out || !out.write(reinterpret_cast<const char*>(blob.data()), blob.size())) {
+                std::cerr << "텍스처 캐시 저장 실패: " << path << std::endl;
+                return;
+            }
+        }
+        // 다른 워커가 옛 파일을 매핑해 두었을 수 있으므로 제자리에 쓰거나 먼저 지우지 않고 한 번에 바꿔 넣는다.
+        // POSIX는 매핑이 옛 내용을 그대로 본다. Windows는 매핑된 파일을 바꾸지 못하므로 이번에는 옛 파일을 두고
+        // (읽는 쪽은 계속 맞는 것을 본다) 다음 실행에 다시 만든다.
+#ifdef _WIN32
+        bool replaced = MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        bool replaced = std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+        if (!replaced) {
+            std::remove(temporary.c_str());
+            std::cerr << "텍스처 캐시 저장 실패 (사용 중일 수 있음): " << path << std::endl;
+            return;
+        }
+        notePendingCache(path);
+    }
+
+    // load가 원본에 대해 아는 것. 캐시를 확인하다 원본을 읽었으면 다시 만들 때 bytes를 그대로 쓴다.
+    struct SourceState {
+        AssetPack::View packed;         // 에셋 팩에 있으면 팩이 원본이다
+        SourceInfo info;
+        bool present = true;
+        std::vector<unsigned char> bytes;
+        bool haveBytes = false;
+    };
+
+    // 캐시(header부터 size바이트)가 원본에 맞으면 true. 원본이 팩에 있으면 매니페스트 해시로, 아니면 크기와 시각으로,
+    // 시각만 다르면 원본을 해시해서 확인한다. 내용은 같고 시각만 달라졌으면 다음부터는 해시하지 않게 시각을 고친 사본을
+    // patched에 담아 cachePath에 바꿔 넣는다. 캐시 팩은 고칠 수 없어서 따로 써 두고 다음 실행에 합친다.
+    // 매핑된 파일은 제자리에서 고치지 않고, 바꿔 넣기 전에 mapping부터 푼다 (캐시 팩이면 nullptr).
+    bool validateCachedSource(const FileHeader* header, size_t size, SourceState& source, const std::string& path,
+        const std::string& cachePath, MappedFile* mapping, std::shared_ptr<std::vector<unsigned char>>& patched)
+    {
+        if (!source.present) return true;
+        if (source.packed) return header->sourceSize == source.info.size && header->sourceHash == source.packed.hash;
+        if (header->sourceSize != source.info.size) return false;
+        if (header->sourceTime == source.info.time) return true;
+        if (!source.haveBytes) {
+            if (!readFile(path, source.bytes)) return false;
+            source.haveBytes = true;
+        }
+        if (AssetPack::hashBytes(source.bytes.data(), source.bytes.size()) != header->sourceHash) return false;
+
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(header);
+        patched = std::make_shared<std::vector<unsigned char>>(data, data + size);
+        reinterpret_cast<FileHeader*>(patched->data())->sourceTime = source.info.time;
+        if (mapping) mapping->close();
+        writeFile(cachePath, *patched);
+        return true;
+    }
+}
+
+bool Render::TextureCache::load(const std::string& path, DecodedImage& out, bool compress) const
+{
+    out.path = path;
+    SourceState source;
+    source.packed = assetPack().find(path);
+    if (source.packed) source.info.size = source.packed.size;
+    else source.present = statSource(path, source.info);
+    std::string cachePath = cachePathFor(path, compress);
+
+    // 캐시 팩에 합쳐진 것이 맞으면 파일을 따로 열지 않고 팩 안을 그대로 쓴다 (팩은 끝까지 매핑돼 있다)
+    AssetPack::View cached = enabled ? cachePack().find(cachePath) : AssetPack::View();
+    if (cached) {
+        const FileHeader* header = parseHeader(cached.data, cached.size, compress);
+        std::shared_ptr<std::vector<unsigned char>> patched;
+        if (header && validateCachedSource(header, cached.size, source, path, cachePath, nullptr, patched)) {
+            fillImage(patched ? patched->data() : cached.data, out);
+            out.fromCache = true;
+            out.storage = patched;
+            return true;
+        }
+    }
+
+    if (enabled) {
+        std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+        if (file->open(cachePath)) {
+            const FileHeader* header = parseHeader(file->data(), file->size(), compress);
+            std::shared_ptr<std::vector<unsigned char>> patched;
+            if (header && validateCachedSource(header, file->size(), source, path, cachePath, file.get(), patched)) {
+                out.fromCache = true;
+                if (patched) {
+                    fillImage(patched->data(), out);
+                    out.storage = patched;
+                } else {
+                    fillImage(file->data(), out);
+                    out.storage = file;
+                }
+                return true;
+            }
+            file->close();
+        }
+    }
+
+    if (!source.present) return false;
+    const unsigned char* sourceData = source.packed.data;
+    size_t sourceSize = source.packed.size;
+    uint64_t sourceHash = source.packed.hash;
+    if (!source.packed) {
+        if (!source.haveBytes && !readFile(path, source.bytes)) return false;
+        sourceData = source.bytes.data();
+        sourceSize = source.bytes.size();
+        sourceHash = AssetPack::hashBytes(sourceData, sourceSize);
+    }
+
+    int width = 0, height = 0, channels = 0;
+    unsigned char* rgba = stbi_load_from_memory(sourceData, static_cast<int>(sourceSize), &width, &height, &channels, 4);
+    if (!rgba) return false;
+
+    std::shared_ptr<std::vector<unsigned char>> blob = std::make_shared<std::vector<unsigned char>>();
+    buildFile(rgba, width, height, channels, source.info, sourceHash, compress, *blob);
+    stbi_image_free(rgba);
+    if (enabled) writeFile(cachePath, *blob);
+
+    fillImage(blob->data(), out);
+    out.fromCache = false;
+    out.storage = blob;
+    return true;
+}
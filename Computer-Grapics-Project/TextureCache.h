@@ -0,0 +1,54 @@
+﻿#pragma once
+#include "RenderBackend.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Render {
+
+    // 워커가 읽은 이미지. levels[0]이 원본이고 (pixels와 같다) 뒤로 밉 단계가 이어진다. 전부 format 형식.
+    // 실패하면 pixels가 nullptr. channels는 원본 파일의 채널 수.
+    // storage가 픽셀 메모리(디코드 결과나 매핑한 캐시 파일)를 붙들고 있어서 복사해 넘겨도 된다.
+    struct DecodedImage {
+        std::string path;
+        const unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        GLenum format = GL_RGBA8;
+        std::vector<TextureLevel> levels;
+        bool fromCache = false;
+        std::shared_ptr<const void> storage;
+        int staging = -1;                       // TextureLoader가 단계를 스테이징 칸으로 옮겼으면 그 칸 (storage는 비어 있다)
+    };
+
+    // PNG를 GPU에 바로 올릴 수 있는 모양으로 바꿔 "<원본>.gtex"에 두고 다음부터는 그 파일을 매핑해서 쓴다.
+    // 캐시에는 밉 단계가 1x1까지 전부 들어 있어서 디코드도 glGenerateMipmap도 필요 없다.
+    // compress로 읽으면 단계마다 BC1/BC3 블록으로 인코딩한 것을 "<원본>.bc.gtex"에 따로 둔다.
+    //
+    // 원본의 크기와 수정 시각이 헤더와 같으면 그대로 쓴다. 시각만 다르면 원본 해시를 비교해서
+    // 같으면 헤더의 시각만 고치고 (체크아웃이나 복사로 시각만 바뀐 경우), 다르면 다시 만든다.
+    // 원본이 없고 캐시만 있으면 캐시를 쓴다. 원본이 에셋 팩에 있으면 팩에서 읽고, 캐시는 팩 매니페스트의
+    // 해시와 크기로 확인한다 (원본 파일을 열지도 해시하지도 않는다).
+    // 캐시는 캐시 팩(cachePack)에서 먼저 찾는다. 새로 만든 .gtex는 따로 쓰고 다음 실행이 캐시 팩에 합친다.
+    //
+    // load는 워커 스레드에서 부른다. setEnabled는 첫 load 전에.
+    class TextureCache
+    {
+    public:
+        static const uint32_t MAGIC = 0x58455447;       // "GTEX"
+        static const uint32_t VERSION = 1;
+
+        void setEnabled(bool value) { enabled = value; }
+        bool isEnabled() const { return enabled; }
+
+        // path를 읽어 out을 채운다. 못 읽으면 false. compress면 out.format이 압축 형식이다.
+        bool load(const std::string& path, DecodedImage& out, bool compress) const;
+
+        static std::string cachePathFor(const std::string& path, bool compress) { return path + (compress ? ".bc.gtex" : ".gtex"); }
+
+    private:
+        bool enabled = true;
+    };
+}
@@ -0,0 +1,309 @@
+﻿#include "TextureLoader.h"
+#include "BlockCompression.h"
+#include "FlightRecorder.h"
+#include "Profiler.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+const size_t Render::TextureLoader::UPLOAD_BUDGET_BYTES;
+
+Render::Texture Render::TextureLoader::load(const std::string& path, const TextureDesc& params, const glm::vec3& placeholder)
+{
+    unsigned char pixel[4] = {
+        static_cast<unsigned char>(placeholder.r * 255.0f + 0.5f),
+        static_cast<unsigned char>(placeholder.g * 255.0f + 0.5f),
+        static_cast<unsigned char>(placeholder.b * 255.0f + 0.5f),
+        255
+    };
+    TextureDesc desc = params;
+    desc.pixels = pixel;
+    desc.width = desc.height = 1;
+    desc.channels = 4;
+    desc.mipmaps = false;
+    GLuint texture = 0;
+    backend().uploadTexture(texture, desc);
+
+    enqueue(path, [this, texture, params](const DecodedImage& image) {
+        if (!image.pixels) return;
+        TextureDesc loaded = params;
+        loaded.pixels = image.pixels;
+        loaded.width = image.width;
+        loaded.height = image.height;
+        loaded.channels = 4;
+        loaded.levels = image.levels.data();
+        loaded.levelCount = static_cast<int>(image.levels.size());
+        loaded.format = image.format;
+        loaded.staging = image.staging;
+        GLuint name = texture;
+        backend().uploadTexture(name, loaded);
+
+        // 올린 단계만큼 (mipmaps가 아니면 0단계만) 메모리를 센다
+        size_t used = 0, uncompressed = 0;
+        int count = loaded.mipmaps ? loaded.levelCount : 1;
+        for (int level = 0; level < count; ++level) {
+            used += image.levels[level].size;
+            uncompressed += static_cast<size_t>(image.levels[level].width) * image.levels[level].height * 4;
+        }
+        stats.textureBytes += used;
+        stats.uncompressedBytes += uncompressed;
+        if (image.format != GL_RGBA8) {
+            std::cout << "텍스처 압축: " << image.path << " " << BlockCompression::formatName(image.format) << " "
+                << used / 1024 << "KB (RGBA8이면 " << uncompressed / 1024 << "KB, " << static_cast<double>(uncompressed) / used
+                << "배 절약)" << std::endl;
+        }
+    }, texture, BlockCompression::isEnabled(), true);
+    // 워커가 이 이미지를 끝내기 전에 채울 칸이 있게 한다
+    updateStaging();
+    return Texture(texture);
+}
+
+void Render::TextureLoader::request(const std::string& path, Completion onLoaded)
+{
+    enqueue(path, std::move(onLoaded), 0, false, false);
+}
+
+void Render::TextureLoader::forget(GLuint texture)
+{
+    if (texture == 0) return;
+    for (auto it = waiting.begin(); it != waiting.end();) {
+        if (it->second.texture == texture) it = waiting.erase(it);
+        else ++it;
+    }
+}
+
+uint32_t Render::TextureLoader::enqueue(const std::string& path, Completion onLoaded, GLuint texture, bool compress, bool stage)
+{
+    startWorkers();
+
+    uint32_t id = nextId++;
+    Waiting& w = waiting[id];
+    w.onLoaded = std::move(onLoaded);
+    w.texture = texture;
+    ++stats.requested;
+    FlightRecorder::event("texture request %s", path.c_str());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Job job;
+        job.id = id;
+        job.path = path;
+        job.compress = compress;
+        job.stage = stage;
+        jobs.push_back(job);
+    }
+    jobReady.notify_one();
+    return id;
+}
+
+void Render::TextureLoader::startWorkers()
+{
+    if (!workers.empty()) return;
+
+    // 이미지가 몇 장뿐이라 많이 둘 필요는 없다. 메인 스레드 몫 하나는 남긴다.
+    int count = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    count = std::max(1, std::min(count, 2));
+    for (int i = 0; i < count; ++i) workers.push_back(std::thread(&TextureLoader::workerMain, this, i));
+}
+
+void Render::TextureLoader::workerMain(int index)
+{
+    Profiler::setThreadName("texture decode " + std::to_string(index));
+    // 뒤집기 설정은 스레드마다 따로라서 GL 스레드의 stbi_set_flip_vertically_on_load와 섞이지 않는다.
+    // 캐시 파일에도 뒤집은 채로 들어간다.
+    stbi_set_flip_vertically_on_load_thread(1);
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobReady.wait(lock, [this] { return !jobs.empty(); });
+            job = jobs.front();
+            jobs.pop_front();
+        }
+
+        Result result;
+        result.id = job.id;
+        result.image.path = job.path;
+        double start = Profiler::now();
+        {
+            PROFILE_SCOPE("texture.decode");
+            if (!cache.load(job.path, result.image, job.compress)) result.image.pixels = nullptr;
+            else if (job.stage) stageLevels(result.image);
+        }
+        result.seconds = Profiler::now() - start;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(result);
+        }
+        resultReady.notify_all();
+    }
+}
+
+void Render::TextureLoader::stageLevels(DecodedImage& image)
+{
+    // 단계가 없으면 (캐시를 끈 디코드) GL이 밉을 만들어야 하므로 그대로 둔다
+    if (!image.pixels || image.levels.empty()) return;
+
+    size_t total = 0;
+    for (const TextureLevel& level : image.levels) total += (level.size + 15) & ~static_cast<size_t>(15);
+
+    int slot = -1;
+    unsigned char* memory = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < STAGING_SLOTS; ++i) {
+            if (slots[i].state == SLOT_FREE && slots[i].capacity >= total) {
+                slots[i].state = SLOT_FILLED;
+                slot = i;
+                memory = slots[i].memory;
+                break;
+            }
+        }
+    }
+    if (slot < 0) return;
+
+    PROFILE_SCOPE("texture.stage");
+    size_t offset = 0;
+    for (TextureLevel& level : image.levels) {
+        std::memcpy(memory + offset, level.pixels, level.size);
+        level.pixels = memory + offset;
+        offset += (level.size + 15) & ~static_cast<size_t>(15);
+    }
+    image.pixels = image.levels[0].pixels;
+    image.staging = slot;
+    image.storage.reset();                  // 캐시 매핑이나 디코드 버퍼는 여기서 바로 놓는다
+}
+
+void Render::TextureLoader::updateStaging()
+{
+    bool loading = false;
+    for (const auto& entry : waiting) {
+        if (entry.second.texture != 0) {
+            loading = true;
+            break;
+        }
+    }
+
+    SlotState states[STAGING_SLOTS];
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < STAGING_SLOTS; ++i) states[i] = slots[i].state;
+    }
+
+    stagingMapped = false;
+    for (int i = 0; i < STAGING_SLOTS; ++i) {
+        if (loading && states[i] == SLOT_UNMAPPED) {
+            // 한 칸이 한 update의 업로드 예산만큼이다. 더 큰 이미지는 칸 없이 올린다.
+            void* memory = backend().mapStaging(i, UPLOAD_BUDGET_BYTES);
+            std::lock_guard<std::mutex> lock(mutex);
+            slots[i].memory = static_cast<unsigned char*>(memory);
+            slots[i].capacity = memory ? UPLOAD_BUDGET_BYTES : 0;
+            slots[i].state = memory ? SLOT_FREE : SLOT_UNMAPPED;
+            states[i] = slots[i].state;
+        }
+        else if (!loading && states[i] == SLOT_FREE) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                // 그 사이 워커가 가져갔으면 둔다
+                if (slots[i].state == SLOT_FREE) {
+                    slots[i].state = SLOT_UNMAPPED;
+                    slots[i].memory = nullptr;
+                    slots[i].capacity = 0;
+                }
+                states[i] = slots[i].state;
+            }
+            if (states[i] == SLOT_UNMAPPED) backend().mapStaging(i, 0);
+        }
+        if (states[i] != SLOT_UNMAPPED) stagingMapped = true;
+    }
+}
+
+void Render::TextureLoader::update()
+{
+    // 칸이 남아 있으면 forget한 결과가 칸을 쥐고 있을 수 있으므로 비울 때까지 돈다
+    if (waiting.empty() && !stagingMapped) return;
+    deliver(UPLOAD_BUDGET_BYTES);
+    updateStaging();
+}
+
+void Render::TextureLoader::deliver(size_t budget)
+{
+    PROFILE_SCOPE("textures.upload");
+    double start = Profiler::now();
+    size_t uploaded = 0;
+    for (;;) {
+        Result result;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (results.empty()) break;
+            size_t bytes = static_cast<size_t>(results.front().image.width) * results.front().image.height * 4;
+            if (uploaded > 0 && uploaded + bytes > budget) break;
+            result = results.front();
+            results.pop_front();
+            uploaded += bytes;
+        }
+
+        DecodedImage& image = result.image;
+        stats.decodeSeconds += result.seconds;
+        bool handedOver = false;
+        auto found = waiting.find(result.id);
+        if (found != waiting.end()) {
+            Completion onLoaded = std::move(found->second.onLoaded);
+            waiting.erase(found);
+            if (image.pixels) {
+                ++stats.completed;
+                if (image.fromCache) ++stats.cacheHits;
+                if (image.staging >= 0) ++stats.staged;
+                std::cout << "텍스처 로드 성공: " << image.path << " (" << image.width << "x" << image.height << ", "
+                    << image.channels << " channels, " << (image.fromCache ? "캐시 " : "디코드 ") << result.seconds * 1000.0
+                    << "ms, 밉 " << image.levels.size() << "단계)" << std::endl;
+            }
+            else {
+                ++stats.failed;
+                std::cerr << "텍스처 로드 실패: " << image.path << std::endl;
+            }
+            if (onLoaded) {
+                onLoaded(image);
+                handedOver = true;
+            }
+        }
+        // forget한 요청이면 읽은 것만 버린다 (result와 같이 storage가 풀린다)
+        if (image.staging >= 0) {
+            // 올렸으면 백엔드가 unmap했다. 올리지 않고 버리는 칸은 PBO가 아직 매핑돼 있으므로 여기서 푼다.
+            if (!handedOver) backend().mapStaging(image.staging, 0);
+            // 칸을 돌려준다. 다시 매핑하는 것은 updateStaging이 한다.
+            std::lock_guard<std::mutex> lock(mutex);
+            slots[image.staging].state = SLOT_UNMAPPED;
+            slots[image.staging].memory = nullptr;
+            slots[image.staging].capacity = 0;
+        }
+    }
+
+    double seconds = Profiler::now() - start;
+    stats.uploadSeconds += seconds;
+    stats.maxFrameUploadSeconds = std::max(stats.maxFrameUploadSeconds, seconds);
+}
+
+void Render::TextureLoader::finish()
+{
+    while (!waiting.empty()) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            resultReady.wait(lock, [this] { return !results.empty(); });
+        }
+        deliver(UPLOAD_BUDGET_BYTES);
+        updateStaging();
+    }
+    updateStaging();
+}
+
+Render::TextureLoader& Render::textureLoader()
+{
+    // 정적 객체 소멸자(텍스처를 지우는 화면들)가 프로그램 종료 중에도 부를 수 있게 일부러 해제하지 않는다.
+    // 워커는 일을 기다리며 멈춰 있다가 프로세스와 같이 끝난다.
+    static TextureLoader* loader = new TextureLoader();
+    return *loader;
+}
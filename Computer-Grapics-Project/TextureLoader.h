@@ -0,0 +1,113 @@
+﻿#pragma once
+#include "RenderBackend.h"
+#include "TextureCache.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Render {
+
+    // PNG 디코드를 워커 스레드로 넘기고, 끝난 것은 GL 스레드가 update에서 올린다.
+    // 요청한 쪽은 자리표시 텍스처로 바로 그리기 시작하고, 업로드가 끝나면 같은 텍스처 이름에
+    // 진짜 이미지가 들어간다. 그래서 로드 때문에 프레임이 멈추지 않는다.
+    // 워커는 TextureCache를 거치므로 두 번째 실행부터는 디코드 대신 캐시 파일을 매핑하고, 밉 단계도 만들지 않고 올린다.
+    // load로 읽은 단계는 워커가 GL 스레드가 미리 매핑해 둔 스테이징 칸(PBO)에 바로 복사해 두고, 다음 update에서
+    // unmap과 업로드만 한다. 빈 칸이 없거나 모자라면 기다리지 않고 메모리에서 바로 올린다.
+    // update, load, request, forget, finish는 GL 스레드에서만 부른다.
+    class TextureLoader
+    {
+    public:
+        typedef std::function<void(const DecodedImage&)> Completion;
+
+        struct Stats {
+            uint32_t requested = 0;
+            uint32_t completed = 0;
+            uint32_t failed = 0;
+            uint32_t cacheHits = 0;             // 디코드 없이 .gtex 캐시에서 읽은 것
+            uint32_t staged = 0;                // 워커가 스테이징 칸에 채워서 올린 것
+            double decodeSeconds = 0.0;         // 워커에서 쓴 시간 합 (캐시 읽기 포함)
+            double uploadSeconds = 0.0;         // GL 스레드에서 쓴 시간 합
+            double maxFrameUploadSeconds = 0.0; // update 한 번에 쓴 가장 긴 시간
+            size_t textureBytes = 0;            // load로 올린 텍스처가 GPU에서 차지하는 양
+            size_t uncompressedBytes = 0;       // 같은 텍스처를 RGBA8로 올렸다면
+        };
+
+        // 한 update에서 올릴 픽셀 양. 넘으면 나머지는 다음 프레임으로 미룬다 (최소 하나는 올린다).
+        static const size_t UPLOAD_BUDGET_BYTES = 8u << 20;
+
+        // 첫 요청 전에 (--no-texture-cache)
+        void setCacheEnabled(bool value) { cache.setEnabled(value); }
+
+        // 2D 텍스처: placeholder 색 1x1을 바로 올려 이름을 주고, 디코드가 끝나면 params로 같은 이름에 다시 올린다.
+        // 파일을 못 읽으면 자리표시 색이 그대로 남는다. BlockCompression이 켜져 있으면 BC1/BC3으로 올린다.
+        // 돌려준 Texture를 지우면 아직 안 끝난 업로드도 버린다.
+        Texture load(const std::string& path, const TextureDesc& params, const glm::vec3& placeholder = glm::vec3(0.5f));
+        // 디코드가 끝나면 update에서 onLoaded를 부른다 (실패하면 image.pixels가 nullptr). 이미지는 항상 RGBA8.
+        void request(const std::string& path, Completion onLoaded);
+        // texture를 지우기 전에 (Texture::reset이 부른다). 아직 안 끝난 load의 업로드를 버린다.
+        void forget(GLuint texture);
+
+        // GL 스레드에서 프레임마다
+        void update();
+        // 요청한 것이 전부 올라갈 때까지 기다린다 (헤드리스 캡처가 자리표시를 찍지 않게)
+        void finish();
+        size_t pendingCount() const { return waiting.size(); }
+        const Stats& getStats() const { return stats; }
+
+    private:
+        struct Job {
+            uint32_t id = 0;
+            std::string path;
+            bool compress = false;
+            bool stage = false;                 // load만 (request 결과는 CPU에서 읽으므로 메모리에 둔다)
+        };
+        struct Result {
+            uint32_t id = 0;
+            DecodedImage image;
+            double seconds = 0.0;
+        };
+        // GL 스레드가 매핑하고 (FREE), 워커가 가져가 채우고 (FILLED), 업로드가 끝나면 다시 UNMAPPED
+        enum SlotState { SLOT_UNMAPPED, SLOT_FREE, SLOT_FILLED };
+        struct Slot {
+            SlotState state = SLOT_UNMAPPED;
+            unsigned char* memory = nullptr;
+            size_t capacity = 0;
+        };
+        struct Waiting {
+            Completion onLoaded;
+            GLuint texture = 0;                 // load로 만든 것이면 그 이름 (forget용)
+        };
+
+        void startWorkers();
+        void workerMain(int index);
+        uint32_t enqueue(const std::string& path, Completion onLoaded, GLuint texture, bool compress, bool stage);
+        // 워커 스레드: 빈 칸이 있으면 단계를 거기로 옮긴다
+        void stageLevels(DecodedImage& image);
+        // 올릴 load가 남아 있으면 빈 칸을 매핑해 두고, 없으면 칸의 저장 공간을 돌려준다
+        void updateStaging();
+        // 끝난 결과를 budget 바이트까지 올린다
+        void deliver(size_t budget);
+
+        TextureCache cache;                     // 워커가 읽기만 한다
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable jobReady;
+        std::condition_variable resultReady;
+        std::deque<Job> jobs;
+        std::deque<Result> results;
+        Slot slots[STAGING_SLOTS];              // mutex로 보호
+        bool stagingMapped = false;             // GL 스레드만 만진다
+
+        std::map<uint32_t, Waiting> waiting;    // GL 스레드만 만진다
+        uint32_t nextId = 1;
+        Stats stats;
+    };
+
+    TextureLoader& textureLoader();
+}
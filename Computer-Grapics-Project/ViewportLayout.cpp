@@ -0,0 +1,51 @@
+﻿#include "ViewportLayout.h"
+#include <algorithm>
+
+const int ViewportLayout::MAX_VIEWS;
+
+namespace {
+    ViewportRect makeRect(int x, int y, int width, int height)
+    {
+        ViewportRect r;
+        r.x = x;
+        r.y = y;
+        r.width = width;
+        r.height = height;
+        return r;
+    }
+}
+
+void ViewportLayout::update(int newCount, int width, int height)
+{
+    newCount = std::max(1, std::min(newCount, MAX_VIEWS));
+    if (newCount == viewCount && width == screenWidth && height == screenHeight) return;
+    viewCount = newCount;
+    screenWidth = width;
+    screenHeight = height;
+
+    int leftW = width / 2;
+    int rightW = width - leftW;
+    int bottomH = height / 2;
+    int topH = height - bottomH;
+
+    switch (viewCount) {
+    case 1:
+        viewports[0] = makeRect(0, 0, width, height);
+        break;
+    case 2:
+        viewports[0] = makeRect(0, 0, leftW, height);
+        viewports[1] = makeRect(leftW, 0, rightW, height);
+        break;
+    case 3:
+        viewports[0] = makeRect(0, bottomH, leftW, topH);
+        viewports[1] = makeRect(leftW, bottomH, rightW, topH);
+        viewports[2] = makeRect(0, 0, width, bottomH);
+        break;
+    default:
+        viewports[0] = makeRect(0, bottomH, leftW, topH);
+        viewports[1] = makeRect(leftW, bottomH, rightW, topH);
+        viewports[2] = makeRect(0, 0, leftW, bottomH);
+        viewports[3] = makeRect(leftW, 0, rightW, bottomH);
+        break;
+    }
+}
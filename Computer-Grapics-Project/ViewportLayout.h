@@ -0,0 +1,29 @@
+﻿#pragma once
+
+// 로컬 분할 화면 칸 나누기 (1~4명). 좌표는 GL 뷰포트 기준이라 y=0이 화면 아래다.
+//   1: 전체   2: 좌우   3: 위 좌우 + 아래 전체 폭   4: 2x2
+// 칸 순서는 위 왼쪽부터 읽는 순서이고, 나누어 떨어지지 않는 픽셀은 오른쪽/위 칸이 가져간다.
+struct ViewportRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+class ViewportLayout
+{
+public:
+    static const int MAX_VIEWS = 4;
+
+    // 칸 수나 화면 크기가 바뀌었을 때만 다시 나눈다
+    void update(int viewCount, int screenWidth, int screenHeight);
+
+    int getViewCount() const { return viewCount; }
+    const ViewportRect& getViewport(int index) const { return viewports[index]; }
+
+private:
+    int viewCount = 0;
+    int screenWidth = 0;
+    int screenHeight = 0;
+    ViewportRect viewports[MAX_VIEWS];
+};
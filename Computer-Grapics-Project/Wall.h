@@ -10,7 +10,7 @@ private:
 public:
     Wall();
 
-    void addBlock(const Block& block);
+    void addBlock(Block&& block);
     void addBlock(float x, float y, float z, float size = 1.0f);
 
     void createHorizontalWall(float startX, float y, float z, int length, float blockSize);
@@ -19,7 +19,8 @@ public:
     size_t getBlockCount() const { return blocks.size(); }
     const Block& getBlock(size_t index) const { return blocks[index]; }
 
-    void render() const;
+    glm::vec3 getColor() const { return glm::vec3(0.6f, 0.4f, 0.2f); }
+    void render(Render::DrawList& out) const;
 
     void clear() { blocks.clear(); }
 };
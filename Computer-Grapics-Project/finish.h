@@ -1,6 +1,8 @@
 #pragma once
 #include <gl/glew.h>
+#include "GlIntercept.h"
 #include <gl/glm/glm.hpp>
+#include "RenderBackend.h"
 #include <string>
 
 enum class Winner {
@@ -15,20 +17,19 @@ public:
     ~FinishScreen();
 
     void initialize();
-    void render(GLuint shaderProgram) const;
+    void render() const;
     void cleanup();
 
     void setWinner(Winner w);
 
 private:
     void initializeBuffers();
-    void loadTextureForWinner();
+    void loadWinnerTextures();
 
-    GLuint vao = 0;
-    GLuint vbo = 0;
-    GLuint textureId = 0;
+    Render::Mesh mesh;
+    Render::Texture winnerTextures[2];      // Steve, Alex
+    GLuint textureId = 0;                   //    ( 0)
     bool isInitialized = false;
-    bool textureLoaded = false;
 
     Winner winner = Winner::NONE;
 };
\ No newline at end of file
@@ -3,33 +3,49 @@
 in vec4 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
+in float Alpha;
 
 out vec4 FragColor;
 
+#ifdef LAYERED
+uniform sampler2DArray texture1;
+uniform float layer;
+#elif defined(TEXTURED)
+uniform sampler2D texture1;
+#else
+uniform vec3 vColor;
+#endif
+
+#ifdef LIT
 uniform vec3 lightPos;
 uniform vec3 lightColor;
-uniform vec3 vColor;
+#ifdef MULTIVIEW
+flat in vec3 ViewPos;
+#define viewPos ViewPos
+#else
 uniform vec3 viewPos;
-uniform bool lightingEnabled;
-uniform bool useTexture;
-uniform sampler2D texture1;
+#endif
+#endif
 
 void main ()
 {
-	vec3 objectColor;
-	
-	if (useTexture) {
-		objectColor = texture(texture1, TexCoord).rgb;
-	} else {
-		objectColor = vColor;
-	}
-
-	if (!lightingEnabled)
-	{
-		FragColor = vec4(objectColor, 1.0f);
-		return;
-	}
+#ifdef LAYERED
+	vec3 objectColor = texture(texture1, vec3(TexCoord, layer)).rgb;
+#elif defined(TEXTURED)
+	vec3 objectColor = texture(texture1, TexCoord).rgb;
+#else
+	vec3 objectColor = vColor;
+#endif
+
+#ifdef ALPHA
+	float alpha = Alpha;
+#else
+	float alpha = 1.0f;
+#endif
 
+#ifndef LIT
+	FragColor = vec4(objectColor, alpha);
+#else
 	float ambientLight = 0.5f;
 	vec3 ambient = ambientLight * lightColor;
 
@@ -46,5 +62,6 @@ void main ()
 
 	vec3 result = (ambient + diffuse + specular) * objectColor;
 
-	FragColor = vec4(result, 1.0f);
+	FragColor = vec4(result, alpha);
+#endif
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include <gl/glew.h>
+#include "GlIntercept.h"
 #include <gl/glm/glm.hpp>
+#include "RenderBackend.h"
 #include <string>
 
 enum class GameState {
@@ -16,7 +18,7 @@ public:
     ~TitleScreen();
 
     void initialize();
-    void render(GLuint shaderProgram) const;
+    void render() const;
     GameState handleKeyInput(unsigned char key) const;
     void cleanup();
 
@@ -25,10 +27,9 @@ private:
     void renderText(const std::string& text, float x, float y, float scale) const;
     void loadTitleTexture();
 
-    GLuint vao;
-    GLuint vbo;
+    Render::Mesh mesh;
     bool isInitialized;
 
-    GLuint titleTextureId = 0;
+    Render::Texture titleTexture;
     bool textureLoaded = false;
 };
\ No newline at end of file
@@ -1,21 +1,49 @@
 #version 330 core
+#ifdef MULTIVIEW
+#extension GL_ARB_shader_viewport_layer_array : enable
+#extension GL_AMD_vertex_shader_viewport_index : enable
+#endif
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in float aAlpha;
 
 out vec4 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
+out float Alpha;
 
 uniform mat4 model;
+#ifdef LIT
+uniform mat3 normalMatrix;
+#endif
+#ifdef MULTIVIEW
+layout (std140) uniform Views {
+    mat4 viewProjections[4];
+    vec4 viewPositions[4];
+};
+flat out vec3 ViewPos;
+#else
 uniform mat4 view;
 uniform mat4 projection;
+#endif
 
 void main()
 {
     FragPos = vec4(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+#ifdef LIT
+    Normal = normalMatrix * aNormal;
+#else
+    Normal = aNormal;
+#endif
     TexCoord = aTexCoord;
+    Alpha = aAlpha;
     
+#ifdef MULTIVIEW
+    ViewPos = viewPositions[gl_InstanceID].xyz;
+    gl_ViewportIndex = gl_InstanceID;
+    gl_Position = viewProjections[gl_InstanceID] * FragPos;
+#else
     gl_Position = projection * view * vec4(FragPos);
+#endif
 }
\ No newline at end of file